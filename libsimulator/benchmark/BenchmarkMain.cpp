@@ -1,5 +1,11 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
+#include "benchmarkAnyAngleSearch.hpp"
 #include "benchmarkCollisionGeometry.hpp"
+#include "benchmarkGeometryBuilder.hpp"
+#include "benchmarkMesh.hpp"
+#include "benchmarkOperationalDecisionSystem.hpp"
+#include "benchmarkPortalGraph.hpp"
+#include "benchmarkRoutingEngine.hpp"
 
 #include <benchmark/benchmark.h>
 
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "AnyAngleSearch.hpp"
+#include "Mesh.hpp"
+#include "RoutingEngine.hpp"
+#include "benchmarkRoutingEngine.hpp"
+#include "buildGeometries.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <utility>
+
+/// Computes paths between the same pairs of positions as 'bmRoutingEngineComputeCorridor' on the
+/// navigation mesh of the large street network, merged into convex polygons if
+/// 'state.range(0)' is not 0. The mean number of expanded search nodes is reported.
+static void bmAnyAngleSearchComputePath(benchmark::State& state)
+{
+    const auto geometry = buildLargeStreetNetwork();
+    const RoutingEngine engine(geometry.Polygon());
+    Mesh mesh = *engine.MeshData();
+    if(state.range(0) != 0) {
+        mesh.MergeGreedy();
+    }
+    const AnyAngleSearch search(std::move(mesh));
+    const auto positions = samplePositions(geometry, 16);
+
+    size_t query = 0;
+    size_t expandedNodes = 0;
+    for(auto _ : state) {
+        const auto& from = positions[query % positions.size()];
+        const auto& to = positions[(query * 7 + positions.size() / 2) % positions.size()];
+        const auto path = search.ComputePath(from, to);
+        benchmark::DoNotOptimize(path);
+        expandedNodes += path.expandedNodes;
+        ++query;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["expandedNodes"] = benchmark::Counter(
+        static_cast<double>(expandedNodes), benchmark::Counter::kAvgIterations);
+    state.counters["polygons"] = static_cast<double>(search.MeshData().CountPolygons());
+}
+
+BENCHMARK(bmAnyAngleSearchComputePath)
+    ->ArgName("merged")
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMicrosecond);
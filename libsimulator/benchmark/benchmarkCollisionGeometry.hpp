@@ -5,6 +5,8 @@
 
 #include <benchmark/benchmark.h>
 
+#include <tuple>
+
 template <class... Args>
 void bmLineSegmentsInDistanceTo(benchmark::State& state, Args&&... args)
 {
@@ -17,6 +19,22 @@ void bmLineSegmentsInDistanceTo(benchmark::State& state, Args&&... args)
     }
 }
 
+/// Queries around the first vertex of the accessible area, i.e. right next to a wall, with a
+/// distance of 'state.range(0)' / 10 meters.
+template <class... Args>
+void bmLineSegmentsInDistanceToBoundary(benchmark::State& state, Args&&... args)
+{
+    auto args_tuple = std::make_tuple(std::move(args)...);
+    auto geometry = std::move(std::get<CollisionGeometry>(args_tuple));
+    const auto position = std::get<0>(geometry.AccessibleArea()).front();
+    const auto distance = static_cast<double>(state.range(0)) / 10.;
+
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(geometry.LineSegmentsInDistanceTo(distance, position));
+        benchmark::ClobberMemory();
+    }
+}
+
 template <class... Args>
 void bmLineSegmentsInApproxDistanceTo(benchmark::State& state, Args&&... args)
 {
@@ -33,6 +51,19 @@ BENCHMARK_CAPTURE(bmLineSegmentsInDistanceTo, large_street_network, buildLargeSt
 
 BENCHMARK_CAPTURE(bmLineSegmentsInDistanceTo, grosser_stern, buildGrosserStern());
 
+BENCHMARK_CAPTURE(
+    bmLineSegmentsInDistanceToBoundary,
+    large_street_network,
+    buildLargeStreetNetwork())
+    ->Arg(2)
+    ->Arg(10)
+    ->Arg(50);
+
+BENCHMARK_CAPTURE(bmLineSegmentsInDistanceToBoundary, grosser_stern, buildGrosserStern())
+    ->Arg(2)
+    ->Arg(10)
+    ->Arg(50);
+
 BENCHMARK_CAPTURE(
     bmLineSegmentsInApproxDistanceTo,
     large_street_network,
@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "GeometryBuilder.hpp"
+#include "Point.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/// Adds a square grid of 'roomCount' overlapping rooms to 'builder', like a floor plan imported
+/// from DXF. Every room contains one pillar that is excluded from the accessible area.
+inline void addFloorPlan(GeometryBuilder& builder, size_t roomCount)
+{
+    const auto rowLength = static_cast<size_t>(std::ceil(std::sqrt(roomCount)));
+    for(size_t room = 0; room < roomCount; ++room) {
+        const auto x = 10. * static_cast<double>(room % rowLength);
+        const auto y = 10. * static_cast<double>(room / rowLength);
+        builder.AddAccessibleArea({{x, y}, {x + 11, y}, {x + 11, y + 11}, {x, y + 11}});
+        builder.ExcludeFromAccessibleArea(
+            {{x + 4, y + 4}, {x + 6, y + 4}, {x + 6, y + 6}, {x + 4, y + 6}});
+    }
+}
+
+/// Builds a floor plan of 'state.range(0)' rooms with 'state.range(1)' threads, the complexity
+/// is reported against the number of rooms.
+static void bmGeometryBuilderBuild(benchmark::State& state)
+{
+    const auto roomCount = static_cast<size_t>(state.range(0));
+    const auto threadCount = static_cast<size_t>(state.range(1));
+    for(auto _ : state) {
+        GeometryBuilder builder(threadCount);
+        addFloorPlan(builder, roomCount);
+        benchmark::DoNotOptimize(builder.Build());
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(bmGeometryBuilderBuild)
+    ->ArgNames({"rooms", "threads"})
+    ->ArgsProduct({{16, 64, 256, 1024, 4096}, {1, 4}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime()
+    ->Complexity();
@@ -2,11 +2,16 @@
 
 #pragma once
 
+#include "GeometricFunctions.hpp"
 #include "LineSegment.hpp"
 #include "Point.hpp"
 
 #include <benchmark/benchmark.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
 template <class... Args>
 void bmDistToOnLine(benchmark::State& state, Args&&... args)
 {
@@ -51,3 +56,38 @@ BENCHMARK_CAPTURE(bmDistTo, dist_to_point, LineSegment(Point(-1.3, 2.1), Point(3
     ->DenseRange(-50, 150, 10)
     ->Arg(-100000)
     ->Arg(100000);
+
+/// Line of sight test against 'state.range(0)' parallel walls that are all missed.
+static std::vector<LineSegment> wallsBesideSightLine(int64_t count)
+{
+    std::vector<LineSegment> walls{};
+    for(int64_t index = 0; index < count; ++index) {
+        const auto y = 1.0 + 0.1 * static_cast<double>(index);
+        walls.emplace_back(Point(-2, y), Point(2, y + 0.05));
+    }
+    return walls;
+}
+
+static void bmIntersectsEachWall(benchmark::State& state)
+{
+    const LineSegment sightLine(Point(-1, 0), Point(1, 0.5));
+    const auto walls = wallsBesideSightLine(state.range(0));
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(
+            std::any_of(walls.cbegin(), walls.cend(), [&sightLine](const auto& wall) {
+                return intersects(sightLine, wall);
+            }));
+    }
+}
+
+static void bmIntersectsAnyWall(benchmark::State& state)
+{
+    const LineSegment sightLine(Point(-1, 0), Point(1, 0.5));
+    const auto walls = wallsBesideSightLine(state.range(0));
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(intersectsAny(sightLine, walls));
+    }
+}
+
+BENCHMARK(bmIntersectsEachWall)->RangeMultiplier(4)->Range(4, 256);
+BENCHMARK(bmIntersectsAnyWall)->RangeMultiplier(4)->Range(4, 256);
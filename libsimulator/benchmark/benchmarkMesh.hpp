@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "AABB.hpp"
+#include "Mesh.hpp"
+#include "RoutingEngine.hpp"
+#include "buildGeometries.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+/// Locates 1024 points spread over the bounds of the large street network in its navigation
+/// mesh, merged into convex polygons if 'state.range(0)' is not 0.
+static void bmMeshFindContainingPolygon(benchmark::State& state)
+{
+    const auto geometry = buildLargeStreetNetwork();
+    const RoutingEngine engine(geometry.Polygon());
+    auto mesh = engine.MeshData()->Clone();
+    if(state.range(0) != 0) {
+        mesh->MergeGreedy();
+    }
+
+    const AABB bounds(std::get<0>(geometry.AccessibleArea()));
+    constexpr size_t samplesPerAxis = 32;
+    std::vector<glm::dvec2> points{};
+    points.reserve(samplesPerAxis * samplesPerAxis);
+    for(size_t x = 0; x < samplesPerAxis; ++x) {
+        for(size_t y = 0; y < samplesPerAxis; ++y) {
+            points.emplace_back(
+                bounds.xmin + (bounds.xmax - bounds.xmin) * (x + 0.5) / samplesPerAxis,
+                bounds.ymin + (bounds.ymax - bounds.ymin) * (y + 0.5) / samplesPerAxis);
+        }
+    }
+
+    for(auto _ : state) {
+        for(const auto& p : points) {
+            benchmark::DoNotOptimize(mesh->FindContainingPolygon(p));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * points.size());
+    state.counters["polygons"] = static_cast<double>(mesh->CountPolygons());
+}
+
+BENCHMARK(bmMeshFindContainingPolygon)->ArgName("merged")->Arg(0)->Arg(1);
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "CollisionFreeSpeedModel.hpp"
+#include "CollisionFreeSpeedModelData.hpp"
+#include "GenericAgent.hpp"
+#include "GeometryBuilder.hpp"
+#include "Journey.hpp"
+#include "Point.hpp"
+#include "Simulation.hpp"
+#include "StageDescription.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+
+/// Creates a square hall filled with a regular grid of agents all heading to the same waypoint.
+inline std::unique_ptr<Simulation>
+buildCrowdedHall(size_t agentsPerRow, size_t threadCount, double neighborListSkin = 0.0)
+{
+    const double extent = static_cast<double>(agentsPerRow) + 2.0;
+    GeometryBuilder builder;
+    builder.AddAccessibleArea({{0, 0}, {extent, 0}, {extent, extent}, {0, extent}});
+
+    auto simulation = std::make_unique<Simulation>(
+        std::make_unique<CollisionFreeSpeedModel>(8.0, 0.1, 5.0, 0.02),
+        std::make_unique<CollisionGeometry>(builder.Build()),
+        0.01,
+        threadCount,
+        neighborListSkin);
+
+    const auto stage = simulation->AddStage(WaypointDescription{{extent / 2, extent - 0.5}, 0.5});
+    const auto journey = simulation->AddJourney({{stage, NonTransitionDescription{}}});
+
+    for(size_t row = 0; row < agentsPerRow; ++row) {
+        for(size_t column = 0; column < agentsPerRow; ++column) {
+            simulation->AddAgent(GenericAgent{
+                GenericAgent::ID::Invalid,
+                journey,
+                stage,
+                Point{1.5 + column, 1.5 + row},
+                CollisionFreeSpeedModelData{}});
+        }
+    }
+    return simulation;
+}
+
+/// Measures one iteration of a simulation with 10.000 agents for the thread count given as
+/// benchmark argument.
+static void bmIterateWithThreads(benchmark::State& state)
+{
+    const auto simulation = buildCrowdedHall(100, static_cast<size_t>(state.range(0)));
+
+    for(auto _ : state) {
+        simulation->Iterate();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * simulation->AgentCount());
+}
+
+BENCHMARK(bmIterateWithThreads)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+/// Measures one iteration of a simulation with 10.000 agents on a single thread for the neighbor
+/// list skin given as benchmark argument in centimeters, 0 disables neighbor lists.
+static void bmIterateWithNeighborLists(benchmark::State& state)
+{
+    const auto simulation = buildCrowdedHall(100, 1, static_cast<double>(state.range(0)) / 100);
+
+    for(auto _ : state) {
+        simulation->Iterate();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * simulation->AgentCount());
+}
+
+BENCHMARK(bmIterateWithNeighborLists)->Arg(0)->Arg(20)->Arg(40)->Arg(80);
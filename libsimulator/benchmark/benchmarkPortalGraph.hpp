@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "Mesh.hpp"
+#include "PortalGraph.hpp"
+#include "RoutingEngine.hpp"
+#include "benchmarkRoutingEngine.hpp"
+#include "buildGeometries.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <vector>
+
+/// Precomputes the portal graph of the large street network on 'state.range(0)' threads.
+static void bmPortalGraphBuild(benchmark::State& state)
+{
+    const auto geometry = buildLargeStreetNetwork();
+    const RoutingEngine engine(geometry.Polygon());
+    const auto threadCount = static_cast<size_t>(state.range(0));
+
+    size_t portals = 0;
+    for(auto _ : state) {
+        const PortalGraph graph(*engine.MeshData(), threadCount);
+        portals = graph.CountPortals();
+        benchmark::DoNotOptimize(portals);
+    }
+    state.counters["polygons"] = static_cast<double>(engine.MeshData()->CountPolygons());
+    state.counters["portals"] = static_cast<double>(portals);
+}
+
+BENCHMARK(bmPortalGraphBuild)
+    ->ArgName("threads")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+/// Computes routes between the same pairs of positions as 'bmRoutingEngineComputeCorridor'. The
+/// mean number of expanded portals is reported.
+static void bmPortalGraphComputeRoute(benchmark::State& state)
+{
+    const auto geometry = buildLargeStreetNetwork();
+    const RoutingEngine engine(geometry.Polygon());
+    const PortalGraph graph(*engine.MeshData(), 1);
+    const auto positions = samplePositions(geometry, 16);
+    std::vector<size_t> polygons{};
+    polygons.reserve(positions.size());
+    for(const auto& position : positions) {
+        polygons.push_back(engine.Locate(position));
+    }
+
+    size_t query = 0;
+    size_t expandedNodes = 0;
+    for(auto _ : state) {
+        const auto from = query % positions.size();
+        const auto to = (query * 7 + positions.size() / 2) % positions.size();
+        const auto route = graph.ComputeRoute(
+            {positions[from].x, positions[from].y},
+            polygons[from],
+            {positions[to].x, positions[to].y},
+            polygons[to]);
+        benchmark::DoNotOptimize(route);
+        expandedNodes += route.expandedNodes;
+        ++query;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["expandedNodes"] = benchmark::Counter(
+        static_cast<double>(expandedNodes), benchmark::Counter::kAvgIterations);
+    state.counters["clusters"] = static_cast<double>(graph.CountClusters());
+}
+
+BENCHMARK(bmPortalGraphComputeRoute)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "AABB.hpp"
+#include "CollisionGeometry.hpp"
+#include "Point.hpp"
+#include "RoutingEngine.hpp"
+#include "buildGeometries.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+/// Points of a regular lattice with 'samplesPerAxis' points per axis that are inside of
+/// 'geometry'.
+inline std::vector<Point> samplePositions(const CollisionGeometry& geometry, size_t samplesPerAxis)
+{
+    const AABB bounds(std::get<0>(geometry.AccessibleArea()));
+    std::vector<Point> positions{};
+    for(size_t x = 0; x < samplesPerAxis; ++x) {
+        for(size_t y = 0; y < samplesPerAxis; ++y) {
+            const Point p{
+                bounds.xmin + (bounds.xmax - bounds.xmin) * (x + 0.5) / samplesPerAxis,
+                bounds.ymin + (bounds.ymax - bounds.ymin) * (y + 0.5) / samplesPerAxis};
+            if(geometry.InsideGeometry(p)) {
+                positions.push_back(p);
+            }
+        }
+    }
+    return positions;
+}
+
+/// Computes corridors between pairs of positions spread over the large street network.
+/// Arg 0 selects the 'RoutingAlgorithm', the mean length of the resulting paths is reported.
+static void bmRoutingEngineComputeCorridor(benchmark::State& state)
+{
+    const auto geometry = buildLargeStreetNetwork();
+    RoutingEngine engine(geometry.Polygon());
+    engine.SetAlgorithm(static_cast<RoutingAlgorithm>(state.range(0)));
+    const auto positions = samplePositions(geometry, 16);
+
+    size_t query = 0;
+    double pathLength = 0;
+    for(auto _ : state) {
+        const auto& from = positions[query % positions.size()];
+        const auto& to = positions[(query * 7 + positions.size() / 2) % positions.size()];
+        const auto corridor = engine.ComputeCorridor(from, to);
+        benchmark::DoNotOptimize(corridor);
+        for(size_t index = 1; index < corridor.waypoints.size(); ++index) {
+            pathLength += Distance(corridor.waypoints[index - 1], corridor.waypoints[index]);
+        }
+        ++query;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["pathLength"] =
+        benchmark::Counter(pathLength, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(bmRoutingEngineComputeCorridor)
+    ->ArgName("algorithm")
+    ->Arg(static_cast<int64_t>(RoutingAlgorithm::Triangulation))
+    ->Arg(static_cast<int64_t>(RoutingAlgorithm::AnyAngle))
+    ->Arg(static_cast<int64_t>(RoutingAlgorithm::Hierarchical))
+    ->Unit(benchmark::kMicrosecond);
+
+/// Locates a dense lattice of positions in order, so that consecutive positions are close like
+/// the positions of one agent in consecutive iterations. Arg 0 selects if the triangle of the
+/// previous position is used as hint.
+static void bmRoutingEngineLocate(benchmark::State& state)
+{
+    const auto geometry = buildLargeStreetNetwork();
+    RoutingEngine engine(geometry.Polygon());
+    const auto positions = samplePositions(geometry, 512);
+    const bool useHint = state.range(0) != 0;
+
+    size_t query = 0;
+    size_t hint = RoutingEngine::NoFaceHint;
+    for(auto _ : state) {
+        const auto face = engine.Locate(positions[query % positions.size()], hint);
+        benchmark::DoNotOptimize(face);
+        if(useHint) {
+            hint = face;
+        }
+        ++query;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(bmRoutingEngineLocate)->ArgName("hint")->Arg(0)->Arg(1);
+
+/// Computes the lengths of 4096 paths between positions spread over the large street network
+/// in one batch on 'state.range(0)' threads.
+static void bmRoutingEngineComputeBatch(benchmark::State& state)
+{
+    const auto geometry = buildLargeStreetNetwork();
+    RoutingEngine engine(geometry.Polygon());
+    const auto positions = samplePositions(geometry, 16);
+    std::vector<Point> origins{};
+    std::vector<Point> destinations{};
+    for(size_t query = 0; query < 4096; ++query) {
+        origins.push_back(positions[query % positions.size()]);
+        destinations.push_back(positions[(query * 7 + positions.size() / 2) % positions.size()]);
+    }
+    const auto threadCount = static_cast<size_t>(state.range(0));
+
+    for(auto _ : state) {
+        const auto batch = engine.ComputeBatch(origins, destinations, threadCount, false);
+        benchmark::DoNotOptimize(batch);
+    }
+    state.SetItemsProcessed(state.iterations() * origins.size());
+}
+
+BENCHMARK(bmRoutingEngineComputeBatch)
+    ->ArgName("threads")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -38,6 +38,24 @@ struct AABB {
         ymax = std::max(b.y, std::max(a.y, ymax));
     }
 
+    /// Grows the box to contain 'p'.
+    void Extend(Point p)
+    {
+        xmin = std::min(xmin, p.x);
+        xmax = std::max(xmax, p.x);
+        ymin = std::min(ymin, p.y);
+        ymax = std::max(ymax, p.y);
+    }
+
+    /// Grows the box to contain 'other'.
+    void Extend(const AABB& other)
+    {
+        xmin = std::min(xmin, other.xmin);
+        xmax = std::max(xmax, other.xmax);
+        ymin = std::min(ymin, other.ymin);
+        ymax = std::max(ymax, other.ymax);
+    }
+
     bool Inside(Point p) const { return p.x >= xmin && p.x <= xmax && p.y >= ymin && p.y <= ymax; }
 
     bool Overlap(const AABB& other) const
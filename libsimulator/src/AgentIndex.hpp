@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "GenericAgent.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <unordered_map>
+
+/// Maps agent ids to the position of the agent in its AgentContainer.
+/// Needs to be updated whenever agents are added to, removed from or moved inside the container.
+class AgentIndex
+{
+    std::unordered_map<GenericAgent::ID, size_t> _positions{};
+
+public:
+    /// Returns the position of the agent with 'id' or nothing if the agent is unknown.
+    std::optional<size_t> Find(GenericAgent::ID id) const
+    {
+        const auto iter = _positions.find(id);
+        if(iter == std::end(_positions)) {
+            return std::nullopt;
+        }
+        return iter->second;
+    }
+
+    bool Contains(GenericAgent::ID id) const { return _positions.contains(id); }
+
+    /// Sets the position of the agent with 'id', the agent is added if it is unknown.
+    void Set(GenericAgent::ID id, size_t position) { _positions.insert_or_assign(id, position); }
+
+    void Remove(GenericAgent::ID id) { _positions.erase(id); }
+
+    size_t Size() const { return _positions.size(); }
+
+    /// Sets the positions of all agents in 'agents' starting at position 'first'.
+    template <typename Agent>
+    void Reindex(const AgentContainer<Agent>& agents, size_t first = 0)
+    {
+        for(size_t position = first; position < agents.size(); ++position) {
+            Set(agents[position].id, position);
+        }
+    }
+};
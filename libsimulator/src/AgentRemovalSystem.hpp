@@ -1,11 +1,12 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #pragma once
 
+#include "AgentIndex.hpp"
 #include "GenericAgent.hpp"
 #include "StageManager.hpp"
 
-#include <algorithm>
 #include <map>
+#include <utility>
 #include <vector>
 
 template <typename Agent>
@@ -19,32 +20,37 @@ public:
     AgentRemovalSystem(AgentRemovalSystem&& other) = delete;
     AgentRemovalSystem& operator=(AgentRemovalSystem&& other) = delete;
 
+    /// Removes all agents in 'removedAgentIds' from 'agents' and keeps 'agentIndex' in sync.
+    /// The order of the remaining agents is not preserved.
     void
     Run(AgentContainer<Agent>& agents,
         std::vector<GenericAgent::ID>& removedAgentIds,
-        StageManager& stageManager) const;
+        StageManager& stageManager,
+        AgentIndex& agentIndex) const;
 };
 
 template <typename Agent>
 void AgentRemovalSystem<Agent>::Run(
     AgentContainer<Agent>& agents,
     std::vector<GenericAgent::ID>& removedAgentIds,
-    StageManager& stageManager) const
+    StageManager& stageManager,
+    AgentIndex& agentIndex) const
 {
-
-    auto iter = std::remove_if(
-        std::begin(agents),
-        std::end(agents),
-        [&removedAgentIds, &stageManager](const GenericAgent& agent) {
-            auto found =
-                std::find(std::begin(removedAgentIds), std::end(removedAgentIds), agent.id) !=
-                std::end(removedAgentIds);
-            if(found) {
-                stageManager.HandleRemoveAgent(agent.stageId);
-            }
-            return found;
-        });
-    agents.erase(iter, std::end(agents));
+    // Removed agents are replaced by the last agent of the container, hence the cost only depends
+    // on the number of removed agents. Ids marked twice are only found once in the index.
+    for(const auto id : removedAgentIds) {
+        const auto position = agentIndex.Find(id);
+        if(!position) {
+            continue;
+        }
+        stageManager.HandleRemoveAgent(agents[*position].stageId);
+        agentIndex.Remove(id);
+        if(*position != agents.size() - 1) {
+            agents[*position] = std::move(agents.back());
+            agentIndex.Set(agents[*position].id, *position);
+        }
+        agents.pop_back();
+    }
 
     removedAgentIds.clear();
 }
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "AgentStore.hpp"
+
+#include "GenericAgent.hpp"
+#include "Point.hpp"
+#include "SimulationError.hpp"
+
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace
+{
+template <typename Data>
+Point orientationOf(const Data& data)
+{
+    if constexpr(requires { data.orientation; }) {
+        return data.orientation;
+    } else {
+        return {};
+    }
+}
+
+template <typename Data>
+Point velocityOf(const Data& data)
+{
+    if constexpr(requires { data.velocity; }) {
+        return data.velocity;
+    } else if constexpr(requires { data.speed; }) {
+        return data.orientation * data.speed;
+    } else {
+        return {};
+    }
+}
+
+template <typename Data>
+double radiusOf(const Data& data)
+{
+    if constexpr(requires { data.radius; }) {
+        return data.radius;
+    } else {
+        return 0.0;
+    }
+}
+} // namespace
+
+void AgentStore::Gather(const AgentContainer<GenericAgent>& agents)
+{
+    _ids.clear();
+    _stageIds.clear();
+    _positions.clear();
+    _orientations.clear();
+    _velocities.clear();
+    _radii.clear();
+    std::visit([](auto& column) { column.clear(); }, _models);
+    if(agents.empty()) {
+        return;
+    }
+
+    _ids.reserve(agents.size());
+    _stageIds.reserve(agents.size());
+    _positions.reserve(agents.size());
+    _orientations.reserve(agents.size());
+    _velocities.reserve(agents.size());
+    _radii.reserve(agents.size());
+    for(const auto& agent : agents) {
+        _ids.push_back(agent.id);
+        _stageIds.push_back(agent.stageId);
+        _positions.push_back(agent.pos);
+        std::visit(
+            [this](const auto& data) {
+                _orientations.push_back(orientationOf(data));
+                _velocities.push_back(velocityOf(data));
+                _radii.push_back(radiusOf(data));
+            },
+            agent.model);
+    }
+
+    std::visit(
+        [this, &agents](const auto& first) {
+            using Data = std::decay_t<decltype(first)>;
+            if(!std::holds_alternative<std::vector<Data>>(_models)) {
+                _models.emplace<std::vector<Data>>();
+            }
+            auto& column = std::get<std::vector<Data>>(_models);
+            column.reserve(agents.size());
+            for(const auto& agent : agents) {
+                const auto* data = std::get_if<Data>(&agent.model);
+                if(data == nullptr) {
+                    throw SimulationError("Agent {} uses a different model", agent.id);
+                }
+                column.push_back(*data);
+            }
+        },
+        agents.front().model);
+}
@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "GenericAgent.hpp"
+#include "Point.hpp"
+#include "UniqueID.hpp"
+
+#include <cstddef>
+#include <span>
+#include <variant>
+#include <vector>
+
+namespace detail
+{
+template <typename Model>
+struct ModelColumns;
+
+template <typename... Data>
+struct ModelColumns<std::variant<Data...>> {
+    using type = std::variant<std::vector<Data>...>;
+};
+} // namespace detail
+
+/// Structure of arrays copy of the agent state read in hot loops.
+/// Element 'i' of every column belongs to the i-th agent of the container passed to 'Gather', the
+/// same index the neighborhood search reports for it, see 'GetNeighborIndicesOf'. The container
+/// stays the owner of the agents, updates are applied to it and gathered again.
+/// Orientation, velocity and radius are derived from the model data, agents whose model does not
+/// define such a property report a zero value.
+class AgentStore
+{
+public:
+    /// One column holding the model data of all agents, all agents of a simulation share the
+    /// same model.
+    using ModelColumn = detail::ModelColumns<GenericAgent::Model>::type;
+
+private:
+    std::vector<GenericAgent::ID> _ids{};
+    std::vector<jps::UniqueID<BaseStage>> _stageIds{};
+    std::vector<Point> _positions{};
+    std::vector<Point> _orientations{};
+    std::vector<Point> _velocities{};
+    std::vector<double> _radii{};
+    ModelColumn _models{};
+
+public:
+    size_t Size() const { return _ids.size(); }
+
+    std::span<const GenericAgent::ID> Ids() const { return _ids; }
+    std::span<const jps::UniqueID<BaseStage>> StageIds() const { return _stageIds; }
+    std::span<const Point> Positions() const { return _positions; }
+    std::span<const Point> Orientations() const { return _orientations; }
+    std::span<const Point> Velocities() const { return _velocities; }
+    std::span<const double> Radii() const { return _radii; }
+
+    /// Returns the model data of all agents, throws std::bad_variant_access if the agents do not
+    /// use 'Data'.
+    template <typename Data>
+    std::span<const Data> Models() const
+    {
+        return std::get<std::vector<Data>>(_models);
+    }
+
+    /// Copies the state of 'agents' into the columns, reusing their allocations.
+    void Gather(const AgentContainer<GenericAgent>& agents);
+};
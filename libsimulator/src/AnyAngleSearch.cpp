@@ -0,0 +1,489 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "AnyAngleSearch.hpp"
+
+#include "GenerationStamps.hpp"
+#include "Mesh.hpp"
+#include "Point.hpp"
+#include "glm/ext/vector_double2.hpp"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace
+{
+/// Tolerance of all length comparisons, relative to the lengths involved
+constexpr double Epsilon{1e-9};
+
+/// Returns 1 if 'b' is left of the line from 'o' through 'a', -1 if it is right of it and 0 if
+/// the three points are collinear within a tolerance relative to their distances.
+int side(glm::dvec2 o, glm::dvec2 a, glm::dvec2 b)
+{
+    const auto u = a - o;
+    const auto v = b - o;
+    const double cross = u.x * v.y - u.y * v.x;
+    const double tolerance = Epsilon * (glm::dot(u, u) + glm::dot(v, v));
+    if(cross > tolerance) {
+        return 1;
+    }
+    if(cross < -tolerance) {
+        return -1;
+    }
+    return 0;
+}
+
+/// Parameter in [0, 1] of the point where the line from 'o' through 'a' crosses the segment from
+/// 'p' to 'q'.
+double crossing(glm::dvec2 o, glm::dvec2 a, glm::dvec2 p, glm::dvec2 q)
+{
+    const auto d = a - o;
+    const auto cross = [](glm::dvec2 u, glm::dvec2 v) { return u.x * v.y - u.y * v.x; };
+    const double denominator = cross(d, p - q);
+    if(denominator == 0) {
+        return 0;
+    }
+    return std::clamp(cross(d, p - o) / denominator, 0., 1.);
+}
+
+/// Point at parameter 's' of the segment from 'p' to 'q', exactly 'p' and 'q' at 0 and 1.
+glm::dvec2 pointAt(glm::dvec2 p, glm::dvec2 q, double s)
+{
+    if(s <= 0) {
+        return p;
+    }
+    if(s >= 1) {
+        return q;
+    }
+    return p + s * (q - p);
+}
+
+/// Range of parameters of the segment from 'p' to 'q' whose points lie on a side of the line
+/// from 'o' through 'a' accepted by 'inside'. 'sideP' and 'sideQ' are the sides of 'p' and 'q'
+/// as returned by 'side'. The range is empty if its begin is larger than its end.
+template <typename Inside>
+std::pair<double, double> clip(
+    glm::dvec2 o,
+    glm::dvec2 a,
+    glm::dvec2 p,
+    glm::dvec2 q,
+    int sideP,
+    int sideQ,
+    Inside&& inside)
+{
+    const bool insideP = inside(sideP);
+    const bool insideQ = inside(sideQ);
+    if(insideP && insideQ) {
+        return {0, 1};
+    }
+    if(!insideP && !insideQ) {
+        return {1, 0};
+    }
+    const double s = crossing(o, a, p, q);
+    return insideP ? std::make_pair(0., s) : std::make_pair(s, 1.);
+}
+
+/// Lower bound of the length of a path from 'root' through the interval from 'left' to 'right'
+/// to 'target'. 'root' is right of the line from 'left' to 'right'.
+double heuristic(glm::dvec2 root, glm::dvec2 left, glm::dvec2 right, glm::dvec2 target)
+{
+    // A target on the side of the root is mirrored, every path to it crosses the interval twice
+    if(side(left, right, target) < 0) {
+        const auto d = right - left;
+        const auto projection = left + d * (glm::dot(target - left, d) / glm::dot(d, d));
+        target = 2. * projection - target;
+    }
+    if(side(root, right, target) < 0) {
+        return glm::distance(root, right) + glm::distance(right, target);
+    }
+    if(side(root, left, target) > 0) {
+        return glm::distance(root, left) + glm::distance(left, target);
+    }
+    return glm::distance(root, target);
+}
+
+/// Interval on the edge 'edge' of 'polygon' through which paths from 'root' enter 'polygon'.
+/// The edge runs from 'left' to 'right' in the orientation of 'polygon', seen from 'root'.
+struct SearchNode {
+    size_t root{};
+    glm::dvec2 left{};
+    glm::dvec2 right{};
+    size_t polygon{};
+    size_t edge{};
+    /// Length of the shortest known path to 'root'
+    double g{};
+    /// Lower bound of the length of the path through this node, exact for final nodes
+    double f{};
+    /// Final nodes end in the target, 'root' is the last turning point
+    bool final{false};
+};
+
+/// Scratch memory of 'AnyAngleSearch::ComputePath', one instance per thread.
+/// Per root the best path length and the previous root are kept, see 'GenerationStamps'.
+struct SearchScratch {
+    struct HeapEntry {
+        double f;
+        double g;
+        size_t node;
+
+        /// Lowest 'f' first, ties go to the longer known path which is closer to the target
+        bool operator>(const HeapEntry& other) const
+        {
+            if(f != other.f) {
+                return f > other.f;
+            }
+            return g < other.g;
+        }
+    };
+
+    GenerationStamps stamps{};
+    std::vector<double> g{};
+    std::vector<size_t> parent{};
+    std::vector<SearchNode> nodes{};
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<>> open{};
+
+    void Begin(size_t rootCount)
+    {
+        stamps.Begin(rootCount);
+        if(g.size() < rootCount) {
+            g.resize(rootCount);
+            parent.resize(rootCount);
+        }
+        nodes.clear();
+        open = {};
+    }
+
+    /// Records a path of length 'length' to 'root' coming from 'previous'.
+    /// Returns false if a shorter path to 'root' is known, nodes of such a path are pruned.
+    bool Improve(size_t root, double length, size_t previous)
+    {
+        if(stamps.IsValid(root)) {
+            const double tolerance = Epsilon * std::max(1., g[root]);
+            if(length > g[root] + tolerance) {
+                return false;
+            }
+            if(length > g[root] - tolerance) {
+                return true;
+            }
+        }
+        stamps.Mark(root);
+        g[root] = length;
+        parent[root] = previous;
+        return true;
+    }
+
+    bool IsStale(const SearchNode& node) const
+    {
+        return node.g > g[node.root] + Epsilon * std::max(1., g[node.root]);
+    }
+
+    void Push(const SearchNode& node)
+    {
+        open.push({node.f, node.g, nodes.size()});
+        nodes.push_back(node);
+    }
+};
+
+thread_local SearchScratch searchScratch{};
+} // namespace
+
+AnyAngleSearch::AnyAngleSearch(Mesh navigationMesh) : mesh(std::move(navigationMesh))
+{
+    corners.resize(mesh.CountVertices(), false);
+    for(size_t index = 0; index < mesh.CountPolygons(); ++index) {
+        const auto& polygon = mesh.Polygons(index);
+        const auto count = polygon.vertices.size();
+        for(size_t edge = 0; edge < count; ++edge) {
+            if(polygon.neighbors[edge] == Mesh::Polygon::InvalidIndex) {
+                corners[polygon.vertices[edge]] = true;
+                corners[polygon.vertices[(edge + 1) % count]] = true;
+            }
+        }
+    }
+}
+
+std::vector<size_t> AnyAngleSearch::containingPolygons(glm::dvec2 p) const
+{
+    const auto first = mesh.FindContainingPolygon(p);
+    if(first == Mesh::Polygon::InvalidIndex) {
+        return {};
+    }
+    std::vector<size_t> result{first};
+    for(size_t position = 0; position < result.size(); ++position) {
+        const auto& polygon = mesh.Polygons(result[position]);
+        const auto count = polygon.vertices.size();
+        for(size_t edge = 0; edge < count; ++edge) {
+            const auto neighbor = polygon.neighbors[edge];
+            if(neighbor == Mesh::Polygon::InvalidIndex ||
+               std::find(result.begin(), result.end(), neighbor) != result.end()) {
+                continue;
+            }
+            const auto a = mesh.Vertex(polygon.vertices[edge]);
+            const auto b = mesh.Vertex(polygon.vertices[(edge + 1) % count]);
+            if(side(a, b, p) == 0 && glm::dot(p - a, p - b) <= 0) {
+                result.push_back(neighbor);
+            }
+        }
+    }
+    return result;
+}
+
+AnyAngleSearch::Path AnyAngleSearch::ComputePath(Point from, Point to) const
+{
+    Path result{};
+    const glm::dvec2 start{from.x, from.y};
+    const glm::dvec2 target{to.x, to.y};
+    const auto startPolygons = containingPolygons(start);
+    const auto targetPolygons = containingPolygons(target);
+    if(startPolygons.empty() || targetPolygons.empty()) {
+        return result;
+    }
+    const auto isTargetPolygon = [&targetPolygons](size_t polygon) {
+        return std::find(targetPolygons.begin(), targetPolygons.end(), polygon) !=
+               targetPolygons.end();
+    };
+    if(std::any_of(startPolygons.begin(), startPolygons.end(), isTargetPolygon)) {
+        result.waypoints = {from, to};
+        return result;
+    }
+
+    // Roots are mesh vertices, the start is an additional root after the last vertex
+    const size_t startRoot = mesh.CountVertices();
+    const auto rootPosition = [&](size_t root) {
+        return root == startRoot ? start : mesh.Vertex(root);
+    };
+    auto& scratch = searchScratch;
+    scratch.Begin(startRoot + 1);
+    scratch.Improve(startRoot, 0, startRoot);
+
+    // Pushes the node entering the neighbor of 'polygon' across its edge 'edge' through the
+    // part of that edge from 'right' to 'left'
+    const auto pushNode = [&](size_t root,
+                              double g,
+                              size_t polygon,
+                              size_t edge,
+                              glm::dvec2 right,
+                              glm::dvec2 left) {
+        const auto& from_polygon = mesh.Polygons(polygon);
+        const auto count = from_polygon.vertices.size();
+        const auto next = from_polygon.neighbors[edge];
+        if(next == Mesh::Polygon::InvalidIndex) {
+            return;
+        }
+        const auto right_vertex = from_polygon.vertices[edge];
+        const auto left_vertex = from_polygon.vertices[(edge + 1) % count];
+        auto r = rootPosition(root);
+        // A root on the line of the edge only touches 'next' in the end point closest to it,
+        // paths into 'next' have to turn there
+        if(root != right_vertex && root != left_vertex &&
+           side(mesh.Vertex(right_vertex), mesh.Vertex(left_vertex), r) == 0) {
+            const auto vertex =
+                glm::distance(r, mesh.Vertex(right_vertex)) <
+                        glm::distance(r, mesh.Vertex(left_vertex)) ?
+                    right_vertex :
+                    left_vertex;
+            g += glm::distance(r, mesh.Vertex(vertex));
+            if(!corners[vertex] || !scratch.Improve(vertex, g, root)) {
+                return;
+            }
+            root = vertex;
+            r = mesh.Vertex(vertex);
+            right = mesh.Vertex(right_vertex);
+            left = mesh.Vertex(left_vertex);
+        }
+        if(glm::distance(left, right) <= Epsilon * glm::distance(r, right)) {
+            return;
+        }
+        const auto& next_polygon = mesh.Polygons(next);
+        const auto next_count = next_polygon.vertices.size();
+        for(size_t next_edge = 0; next_edge < next_count; ++next_edge) {
+            if(next_polygon.vertices[next_edge] == left_vertex &&
+               next_polygon.vertices[(next_edge + 1) % next_count] == right_vertex) {
+                scratch.Push(
+                    {root,
+                     left,
+                     right,
+                     next,
+                     next_edge,
+                     g,
+                     g + heuristic(r, left, right, target),
+                     false});
+                return;
+            }
+        }
+    };
+
+    // Pushes a node with the new root 'vertex' turning the path from 'node' at 'vertex'
+    const auto pushTurn = [&](const SearchNode& node,
+                              size_t vertex,
+                              size_t edge,
+                              glm::dvec2 right,
+                              glm::dvec2 left) {
+        const double g = node.g + glm::distance(rootPosition(node.root), mesh.Vertex(vertex));
+        if(scratch.Improve(vertex, g, node.root)) {
+            pushNode(vertex, g, node.polygon, edge, right, left);
+        }
+    };
+
+    // Pushes the final node if 'target' can be reached in a straight line from the root of
+    // 'node' or one of its interval end points.
+    const auto pushFinal = [&](const SearchNode& node, glm::dvec2 a, glm::dvec2 b) {
+        const auto r = rootPosition(node.root);
+        const auto right_side = side(r, node.right, target);
+        const auto left_side = side(r, node.left, target);
+        const auto& polygon = mesh.Polygons(node.polygon);
+        const auto count = polygon.vertices.size();
+        if(right_side >= 0 && left_side <= 0) {
+            scratch.Push(
+                {node.root,
+                 node.left,
+                 node.right,
+                 node.polygon,
+                 node.edge,
+                 node.g,
+                 node.g + glm::distance(r, target),
+                 true});
+            return;
+        }
+        size_t vertex{};
+        if(right_side < 0 && node.right == b) {
+            vertex = polygon.vertices[(node.edge + 1) % count];
+        } else if(left_side > 0 && node.left == a) {
+            vertex = polygon.vertices[node.edge];
+        } else {
+            return;
+        }
+        if(!corners[vertex]) {
+            return;
+        }
+        const double g = node.g + glm::distance(r, mesh.Vertex(vertex));
+        if(scratch.Improve(vertex, g, node.root)) {
+            scratch.Push(
+                {vertex,
+                 node.left,
+                 node.right,
+                 node.polygon,
+                 node.edge,
+                 g,
+                 g + glm::distance(mesh.Vertex(vertex), target),
+                 true});
+        }
+    };
+
+    for(const auto polygon : startPolygons) {
+        const auto& vertices = mesh.Polygons(polygon).vertices;
+        for(size_t edge = 0; edge < vertices.size(); ++edge) {
+            pushNode(
+                startRoot,
+                0,
+                polygon,
+                edge,
+                mesh.Vertex(vertices[edge]),
+                mesh.Vertex(vertices[(edge + 1) % vertices.size()]));
+        }
+    }
+
+    while(!scratch.open.empty()) {
+        const auto node = scratch.nodes[scratch.open.top().node];
+        scratch.open.pop();
+        if(scratch.IsStale(node)) {
+            continue;
+        }
+        if(node.final) {
+            result.waypoints.push_back(to);
+            for(auto root = node.root; root != startRoot; root = scratch.parent[root]) {
+                const auto p = mesh.Vertex(root);
+                result.waypoints.emplace_back(p.x, p.y);
+            }
+            result.waypoints.push_back(from);
+            std::reverse(result.waypoints.begin(), result.waypoints.end());
+            // A start or target on a vertex coincides with the root at that vertex
+            result.waypoints.erase(
+                std::unique(result.waypoints.begin(), result.waypoints.end()),
+                result.waypoints.end());
+            return result;
+        }
+        ++result.expandedNodes;
+
+        const auto& polygon = mesh.Polygons(node.polygon);
+        const auto count = polygon.vertices.size();
+        const auto a_vertex = polygon.vertices[node.edge];
+        const auto b_vertex = polygon.vertices[(node.edge + 1) % count];
+        const auto a = mesh.Vertex(a_vertex);
+        const auto b = mesh.Vertex(b_vertex);
+        const auto r = rootPosition(node.root);
+
+        if(isTargetPolygon(node.polygon)) {
+            pushFinal(node, a, b);
+        }
+
+        // A root at an end point of the edge lies on the boundary of the polygon and sees all
+        // of it
+        if(node.root == a_vertex || node.root == b_vertex) {
+            for(size_t step = 1; step < count; ++step) {
+                const auto edge = (node.edge + step) % count;
+                pushNode(
+                    node.root,
+                    node.g,
+                    node.polygon,
+                    edge,
+                    mesh.Vertex(polygon.vertices[edge]),
+                    mesh.Vertex(polygon.vertices[(edge + 1) % count]));
+            }
+            continue;
+        }
+
+        // The part of the polygon between the rays from the root through the interval end
+        // points is visible from the root, the parts outside can only be reached by turning at
+        // an interval end point that is a corner.
+        const bool turn_right = node.right == b && corners[b_vertex];
+        const bool turn_left = node.left == a && corners[a_vertex];
+        for(size_t step = 1; step < count; ++step) {
+            const auto edge = (node.edge + step) % count;
+            const auto p = mesh.Vertex(polygon.vertices[edge]);
+            const auto q = mesh.Vertex(polygon.vertices[(edge + 1) % count]);
+            const auto right_p = side(r, node.right, p);
+            const auto right_q = side(r, node.right, q);
+            const auto left_p = side(r, node.left, p);
+            const auto left_q = side(r, node.left, q);
+
+            const auto [right_begin, right_end] =
+                clip(r, node.right, p, q, right_p, right_q, [](int s) { return s >= 0; });
+            const auto [left_begin, left_end] =
+                clip(r, node.left, p, q, left_p, left_q, [](int s) { return s <= 0; });
+            const auto begin = std::max(right_begin, left_begin);
+            const auto end = std::min(right_end, left_end);
+            if(begin < end) {
+                pushNode(
+                    node.root,
+                    node.g,
+                    node.polygon,
+                    edge,
+                    pointAt(p, q, begin),
+                    pointAt(p, q, end));
+            }
+            if(turn_right) {
+                const auto [turn_begin, turn_end] =
+                    clip(r, b, p, q, right_p, right_q, [](int s) { return s < 0; });
+                if(turn_begin < turn_end) {
+                    pushTurn(
+                        node, b_vertex, edge, pointAt(p, q, turn_begin), pointAt(p, q, turn_end));
+                }
+            }
+            if(turn_left) {
+                const auto [turn_begin, turn_end] =
+                    clip(r, a, p, q, left_p, left_q, [](int s) { return s > 0; });
+                if(turn_begin < turn_end) {
+                    pushTurn(
+                        node, a_vertex, edge, pointAt(p, q, turn_begin), pointAt(p, q, turn_end));
+                }
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "Mesh.hpp"
+#include "Point.hpp"
+
+#include <cstddef>
+#include <vector>
+
+/// Euclidean shortest paths over the convex polygons of a Mesh.
+///
+/// Implements the interval based any-angle search from "Compromise-free Pathfinding on a
+/// Navigation Mesh" (Cui, Harabor, Grastien 2017, known as Polyanya). A search node is an
+/// interval on a polygon edge together with the last turning point (root) of the paths through
+/// it, so a single node covers all straight continuations through the interval. Paths only turn
+/// at vertices on the boundary of the mesh and come out optimal without any post-processing.
+class AnyAngleSearch
+{
+    Mesh mesh;
+    /// Per vertex of 'mesh': true if the vertex lies on the boundary, only there paths may turn
+    std::vector<bool> corners{};
+
+public:
+    /// Result of one search.
+    struct Path {
+        /// Start, all turning points and destination, empty if the destination is unreachable
+        std::vector<Point> waypoints{};
+        /// Number of search nodes expanded to find 'waypoints'
+        size_t expandedNodes{0};
+    };
+
+    /// Searches over the polygons of 'navigationMesh'. Merging the mesh beforehand reduces the
+    /// number of search nodes, see 'Mesh::MergeGreedy'.
+    explicit AnyAngleSearch(Mesh navigationMesh);
+    ~AnyAngleSearch() = default;
+    AnyAngleSearch(const AnyAngleSearch& other) = default;
+    AnyAngleSearch& operator=(const AnyAngleSearch& other) = default;
+    AnyAngleSearch(AnyAngleSearch&& other) = default;
+    AnyAngleSearch& operator=(AnyAngleSearch&& other) = default;
+
+    /// Computes the shortest path from 'from' to 'to'. The path is empty if either position is
+    /// outside of the mesh or 'to' cannot be reached. Safe to call concurrently.
+    Path ComputePath(Point from, Point to) const;
+
+    const Mesh& MeshData() const { return mesh; }
+
+private:
+    /// Indices of all polygons containing 'p', more than one if 'p' is on a shared edge or
+    /// vertex.
+    std::vector<size_t> containingPolygons(glm::dvec2 p) const;
+};
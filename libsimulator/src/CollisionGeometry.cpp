@@ -6,17 +6,28 @@
 #include "GeometricFunctions.hpp"
 #include "LineSegment.hpp"
 #include "Point.hpp"
+#include "RoutingEngine.hpp"
+#include "SimulationError.hpp"
+#include "WallDistanceField.hpp"
 
 #include <CGAL/Boolean_set_operations_2/oriented_side.h>
 #include <CGAL/enum.h>
 #include <CGAL/number_utils.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <set>
+#include <span>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 Cell makeCell(Point p)
@@ -97,26 +108,253 @@ void ExtractSegmentsFromPolygon(const Poly& p, std::vector<LineSegment>& segment
     segments.emplace_back(fromPoint_2(boundary.back()), fromPoint_2(boundary.front()));
 }
 
+namespace
+{
+/// Search radius of the approximate grid, every segment within this distance to any point of a
+/// cell is listed in the cell.
+constexpr double approximateSearchRadius = 4.;
+
+/// Fills a CSR layout in two passes, 'forEachEntry(emit)' has to call 'emit(cell, value)' for all
+/// entries and is called twice.
+template <typename Value, typename ForEachEntry>
+void buildCsr(
+    size_t cellCount,
+    std::vector<uint32_t>& offsets,
+    std::vector<Value>& values,
+    ForEachEntry&& forEachEntry)
+{
+    offsets.assign(cellCount + 1, 0);
+    forEachEntry([&offsets](size_t cell, const Value&) { ++offsets[cell + 1]; });
+    for(size_t cell = 0; cell < cellCount; ++cell) {
+        if(offsets[cell + 1] > std::numeric_limits<uint32_t>::max() - offsets[cell]) {
+            throw SimulationError("Geometry has too many line segments per grid cell");
+        }
+        offsets[cell + 1] += offsets[cell];
+    }
+    values.resize(offsets.back());
+    std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+    forEachEntry([&next, &values](size_t cell, const Value& value) {
+        values[next[cell]++] = value;
+    });
+}
+} // namespace
+
+std::optional<size_t> CollisionGeometry::gridCell(int64_t x, int64_t y) const
+{
+    const auto column = x - _gridMinX;
+    const auto row = y - _gridMinY;
+    if(column < 0 || column >= _gridWidth || row < 0 || row >= _gridHeight) {
+        return std::nullopt;
+    }
+    if(_sparseCells) {
+        const auto iter = _sparseCells->find({x, y});
+        if(iter == _sparseCells->end()) {
+            return std::nullopt;
+        }
+        return iter->second;
+    }
+    return static_cast<size_t>(row * _gridWidth + column);
+}
+
+template <typename Func>
+void CollisionGeometry::forEachApproximateCell(const LineSegment& ls, Func&& func) const
+{
+    const auto searchExtend = Point(approximateSearchRadius, approximateSearchRadius);
+    const AABB lineSegmentBounds({ls.p1, ls.p2});
+    const auto bottomLeft = lineSegmentBounds.BottomLeft() - searchExtend;
+    const auto topRight = lineSegmentBounds.TopRight() + searchExtend;
+
+    for(auto x = cellIndex(bottomLeft.x); x <= cellIndex(topRight.x); ++x) {
+        for(auto y = cellIndex(bottomLeft.y); y <= cellIndex(topRight.y); ++y) {
+            const auto cellX = static_cast<double>(x) * CELL_EXTEND;
+            const auto cellY = static_cast<double>(y) * CELL_EXTEND;
+            const AABB bbWithSearchRadius(
+                {cellX - approximateSearchRadius, cellY - approximateSearchRadius},
+                {cellX + approximateSearchRadius + CELL_EXTEND,
+                 cellY + approximateSearchRadius + CELL_EXTEND});
+
+            if(bbWithSearchRadius.Intersects(ls)) {
+                func(x, y);
+            }
+        }
+    }
+}
+
+void CollisionGeometry::addSparseCells(std::span<const LineSegment> segments)
+{
+    for(const auto& ls : segments) {
+        forEachApproximateCell(ls, [this](int64_t x, int64_t y) {
+            if(_sparseCells->try_emplace({x, y}, _cellLocations.size()).second) {
+                _cellLocations.push_back(CellLocation::Boundary);
+            }
+        });
+    }
+}
+
 CollisionGeometry::CollisionGeometry(PolyWithHoles accessibleArea)
-    : _accessibleAreaPolygon(accessibleArea)
+    : _accessibleAreaPolygon(std::move(accessibleArea))
 {
-    _segments.reserve(CountLineSegments(accessibleArea));
-    ExtractSegmentsFromPolygon(accessibleArea.outer_boundary(), _segments);
-    for(const auto& hole : accessibleArea.holes()) {
-        ExtractSegmentsFromPolygon(hole, _segments);
+    extractAccessibleArea();
+
+    if(!_segments.empty()) {
+        std::vector<Point> points{};
+        points.reserve(2 * _segments.size());
+        for(const auto& ls : _segments) {
+            points.push_back(ls.p1);
+            points.push_back(ls.p2);
+        }
+        const AABB bounds(points);
+        _gridMinX = cellIndex(bounds.xmin - approximateSearchRadius);
+        _gridMinY = cellIndex(bounds.ymin - approximateSearchRadius);
+        _gridWidth = cellIndex(bounds.xmax + approximateSearchRadius) - _gridMinX + 1;
+        _gridHeight = cellIndex(bounds.ymax + approximateSearchRadius) - _gridMinY + 1;
+    }
+    // Compare in floating point, the product may not fit into an integer
+    if(static_cast<double>(_gridWidth) * static_cast<double>(_gridHeight) > MAX_DENSE_CELLS) {
+        _sparseCells.emplace();
+        addSparseCells(_segments);
+    } else {
+        _cellLocations.assign(
+            static_cast<size_t>(_gridWidth * _gridHeight), CellLocation::Boundary);
+    }
+    const auto cellCount = _cellLocations.size();
+
+    buildCsr<uint32_t>(cellCount, _gridOffsets, _gridSegments, [this](auto&& emit) {
+        for(size_t index = 0; index < _segments.size(); ++index) {
+            anyCellOnLineSegment(_segments[index], [this, index, &emit](int64_t x, int64_t y) {
+                if(const auto cell = gridCell(x, y)) {
+                    emit(*cell, static_cast<uint32_t>(index));
+                }
+                return false;
+            });
+        }
+    });
+    buildCsr<LineSegment>(
+        cellCount, _approximateOffsets, _approximateSegments, [this](auto&& emit) {
+            for(const auto& ls : _segments) {
+                forEachApproximateCell(ls, [this, &ls, &emit](int64_t x, int64_t y) {
+                    if(const auto cell = gridCell(x, y)) {
+                        emit(*cell, ls);
+                    }
+                });
+            }
+        });
+    classifyCells(_gridMinX, _gridMinY, _gridMinX + _gridWidth - 1, _gridMinY + _gridHeight - 1);
+}
+
+CollisionGeometry::CollisionGeometry(
+    const CollisionGeometry& base,
+    PolyWithHoles accessibleArea,
+    size_t removedFirst,
+    size_t removedCount)
+    : _accessibleAreaPolygon(std::move(accessibleArea))
+    , _gridMinX(base._gridMinX)
+    , _gridMinY(base._gridMinY)
+    , _gridWidth(base._gridWidth)
+    , _gridHeight(base._gridHeight)
+    , _sparseCells(base._sparseCells)
+    , _cellLocations(base._cellLocations)
+{
+    extractAccessibleArea();
+    const auto removed = std::span(base._segments).subspan(removedFirst, removedCount);
+    const auto keptCount = base._segments.size() - removedCount;
+    const auto added = std::span(_segments).subspan(keptCount);
+    // Cells of removed segments stay in a sparse grid, they are merely empty
+    if(_sparseCells) {
+        addSparseCells(added);
     }
+    const auto baseCellCount = base._cellLocations.size();
+    const auto cellCount = _cellLocations.size();
 
-    for(const auto& ls : _segments) {
-        const auto cells = cellsFromLineSegment(ls);
-        for(const auto& cell : cells) {
-            _grid[cell].insert(ls);
+    // Entries of kept segments are copied in order and all added segments have larger indices,
+    // so every cell lists its segments in the same order as a geometry built from scratch.
+    buildCsr<uint32_t>(cellCount, _gridOffsets, _gridSegments, [&](auto&& emit) {
+        for(size_t cell = 0; cell < baseCellCount; ++cell) {
+            for(auto entry = base._gridOffsets[cell]; entry < base._gridOffsets[cell + 1];
+                ++entry) {
+                const auto index = base._gridSegments[entry];
+                if(index < removedFirst) {
+                    emit(cell, index);
+                } else if(index >= removedFirst + removedCount) {
+                    emit(cell, static_cast<uint32_t>(index - removedCount));
+                }
+            }
+        }
+        for(size_t index = keptCount; index < _segments.size(); ++index) {
+            anyCellOnLineSegment(_segments[index], [this, index, &emit](int64_t x, int64_t y) {
+                if(const auto cell = gridCell(x, y)) {
+                    emit(*cell, static_cast<uint32_t>(index));
+                }
+                return false;
+            });
+        }
+    });
+
+    // Only cells within the search radius of a removed segment need to be filtered
+    std::vector<bool> touched(cellCount, false);
+    for(const auto& ls : removed) {
+        forEachApproximateCell(ls, [this, &touched](int64_t x, int64_t y) {
+            if(const auto cell = gridCell(x, y)) {
+                touched[*cell] = true;
+            }
+        });
+    }
+    buildCsr<LineSegment>(cellCount, _approximateOffsets, _approximateSegments, [&](auto&& emit) {
+        for(size_t cell = 0; cell < baseCellCount; ++cell) {
+            for(auto entry = base._approximateOffsets[cell];
+                entry < base._approximateOffsets[cell + 1];
+                ++entry) {
+                const auto& ls = base._approximateSegments[entry];
+                if(!touched[cell] ||
+                   std::find(removed.begin(), removed.end(), ls) == removed.end()) {
+                    emit(cell, ls);
+                }
+            }
+        }
+        for(size_t index = keptCount; index < _segments.size(); ++index) {
+            const auto& ls = _segments[index];
+            forEachApproximateCell(ls, [this, &ls, &emit](int64_t x, int64_t y) {
+                if(const auto cell = gridCell(x, y)) {
+                    emit(*cell, ls);
+                }
+            });
         }
+    });
 
-        insertIntoApproximateGrid(ls);
+    // Cells outside of the bounds of the changed segments keep their location
+    std::vector<Point> changed{};
+    for(const auto& ls : removed) {
+        changed.push_back(ls.p1);
+        changed.push_back(ls.p2);
     }
+    for(size_t index = keptCount; index < _segments.size(); ++index) {
+        changed.push_back(_segments[index].p1);
+        changed.push_back(_segments[index].p2);
+    }
+    if(!changed.empty()) {
+        const AABB bounds(changed);
+        classifyCells(
+            cellIndex(bounds.xmin),
+            cellIndex(bounds.ymin),
+            cellIndex(bounds.xmax),
+            cellIndex(bounds.ymax));
+
+        // Distances of 'base' stay valid away from the changed walls
+        if(const auto* field = base._wallDistanceCache->field.load(std::memory_order_acquire)) {
+            auto& cache = *_wallDistanceCache;
+            cache.storage = std::make_unique<WallDistanceField>(*field, *this, bounds);
+            cache.field.store(cache.storage.get(), std::memory_order_release);
+        }
+    }
+}
 
-    for(auto& [_, vec] : _approximateGrid) {
-        vec.shrink_to_fit();
+void CollisionGeometry::extractAccessibleArea()
+{
+    _segments.clear();
+    _segments.reserve(CountLineSegments(_accessibleAreaPolygon));
+    ExtractSegmentsFromPolygon(_accessibleAreaPolygon.outer_boundary(), _segments);
+    for(const auto& hole : _accessibleAreaPolygon.holes()) {
+        ExtractSegmentsFromPolygon(hole, _segments);
     }
 
     const auto cvt = [](const auto& c) {
@@ -138,76 +376,263 @@ CollisionGeometry::CollisionGeometry(PolyWithHoles accessibleArea)
     _accessibleArea = std::make_tuple(exterior, holes);
 }
 
-const std::vector<LineSegment>& CollisionGeometry::LineSegmentsInApproxDistanceTo(Point p) const
+CollisionGeometry CollisionGeometry::WithObstacle(const Poly& obstacle) const
 {
-    const auto cell = makeCell(p);
-    if(const auto it = _approximateGrid.find(cell); it != _approximateGrid.end()) {
-        return it->second;
+    Poly hole = obstacle;
+    if(hole.is_counterclockwise_oriented()) {
+        hole.reverse_orientation();
+    }
+    std::vector<LineSegment> obstacleSegments{};
+    ExtractSegmentsFromPolygon(hole, obstacleSegments);
+    for(const auto& ls : obstacleSegments) {
+        if(IntersectsAny(ls)) {
+            throw SimulationError("Obstacle intersects the boundary of the accessible area");
+        }
+    }
+    if(!InsideGeometry(obstacleSegments.front().p1)) {
+        throw SimulationError("Obstacle is outside of the accessible area");
+    }
+    for(const auto& existing : _accessibleAreaPolygon.holes()) {
+        if(hole.bounded_side(*existing.vertices_begin()) != CGAL::ON_UNBOUNDED_SIDE) {
+            throw SimulationError("Obstacle contains a hole of the accessible area");
+        }
     }
-    static const std::vector<LineSegment> empty{};
-    return empty;
+
+    std::vector<Poly> holes(
+        _accessibleAreaPolygon.holes_begin(), _accessibleAreaPolygon.holes_end());
+    holes.push_back(std::move(hole));
+    return CollisionGeometry(
+        *this,
+        PolyWithHoles(_accessibleAreaPolygon.outer_boundary(), holes.begin(), holes.end()),
+        _segments.size(),
+        0);
 }
 
-void CollisionGeometry::insertIntoApproximateGrid(const LineSegment& ls)
+CollisionGeometry CollisionGeometry::WithoutObstacle(const Poly& obstacle) const
 {
-    constexpr double searchRadius = 4.;
-
-    const auto searchExtend = Point(searchRadius, searchRadius);
-    const AABB lineSegmentBounds({ls.p1, ls.p2});
-    const AABB searchBounds(
-        lineSegmentBounds.BottomLeft() - searchExtend, lineSegmentBounds.TopRight() + searchExtend);
+    Poly hole = obstacle;
+    if(hole.is_counterclockwise_oriented()) {
+        hole.reverse_orientation();
+    }
+    // Segments are stored outer boundary first, followed by the holes in order
+    std::vector<Poly> holes{};
+    size_t firstSegment = _accessibleAreaPolygon.outer_boundary().size();
+    std::optional<size_t> removedFirst{};
+    for(const auto& existing : _accessibleAreaPolygon.holes()) {
+        if(!removedFirst && std::equal(
+                                existing.vertices_begin(),
+                                existing.vertices_end(),
+                                hole.vertices_begin(),
+                                hole.vertices_end())) {
+            removedFirst = firstSegment;
+        } else {
+            holes.push_back(existing);
+        }
+        firstSegment += existing.size();
+    }
+    if(!removedFirst) {
+        throw SimulationError("Obstacle is not part of the geometry");
+    }
+    return CollisionGeometry(
+        *this,
+        PolyWithHoles(_accessibleAreaPolygon.outer_boundary(), holes.begin(), holes.end()),
+        *removedFirst,
+        hole.size());
+}
 
-    auto cellBottomLeft = makeCell(searchBounds.BottomLeft());
-    auto cellTopRight = makeCell(searchBounds.TopRight());
+std::unique_ptr<RoutingEngine> CollisionGeometry::CreateRoutingEngine() const
+{
+    if(_routingEngine) {
+        return _routingEngine->Clone();
+    }
+    return std::make_unique<RoutingEngine>(_accessibleAreaPolygon);
+}
 
-    for(double x = cellBottomLeft.x; x <= cellTopRight.x; x += CELL_EXTEND) {
-        for(double y = cellBottomLeft.y; y <= cellTopRight.y; y += CELL_EXTEND) {
-            const auto cell = makeCell({x, y});
+std::span<const LineSegment> CollisionGeometry::LineSegmentsInApproxDistanceTo(Point p) const
+{
+    const auto cell = gridCell(cellIndex(p.x), cellIndex(p.y));
+    if(!cell) {
+        return {};
+    }
+    const auto first = _approximateOffsets[*cell];
+    const auto last = _approximateOffsets[*cell + 1];
+    return {_approximateSegments.data() + first, last - first};
+}
 
-            const AABB bbWithSearchRadius(
-                {cell.x - searchRadius, cell.y - searchRadius},
-                {cell.x + searchRadius + CELL_EXTEND, cell.y + searchRadius + CELL_EXTEND});
+std::vector<LineSegment> CollisionGeometry::LineSegmentsInDistanceTo(double distance, Point p) const
+{
+    if(_gridWidth == 0 || _gridHeight == 0 || !(distance >= 0)) {
+        return {};
+    }
+    // Clamp in floating point first, the query square may reach far outside of the grid
+    const auto clampedCellIndex = [](double coordinate, int64_t first, int64_t count) {
+        const auto lower = static_cast<double>(first);
+        const auto upper = static_cast<double>(first + count - 1);
+        return static_cast<int64_t>(std::clamp(std::floor(coordinate / CELL_EXTEND), lower, upper));
+    };
+    const auto minX = clampedCellIndex(p.x - distance, _gridMinX, _gridWidth);
+    const auto maxX = clampedCellIndex(p.x + distance, _gridMinX, _gridWidth);
+    const auto minY = clampedCellIndex(p.y - distance, _gridMinY, _gridHeight);
+    const auto maxY = clampedCellIndex(p.y + distance, _gridMinY, _gridHeight);
 
-            if(bbWithSearchRadius.Intersects(ls)) {
-                auto& vec = _approximateGrid[cell];
-                vec.push_back(ls);
+    // Segments spanning several cells are listed in each of them
+    std::vector<uint32_t> candidates{};
+    for(auto y = minY; y <= maxY; ++y) {
+        for(auto x = minX; x <= maxX; ++x) {
+            const auto cell = gridCell(x, y);
+            if(!cell) {
+                continue;
             }
+            candidates.insert(
+                candidates.end(),
+                _gridSegments.begin() + _gridOffsets[*cell],
+                _gridSegments.begin() + _gridOffsets[*cell + 1]);
         }
     }
-}
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
 
-CollisionGeometry::LineSegmentRange
-CollisionGeometry::LineSegmentsInDistanceTo(double distance, Point p) const
-{
-    return LineSegmentRange{
-        DistanceQueryIterator<LineSegment>{distance, p, _segments.cbegin(), _segments.cend()},
-        DistanceQueryIterator<LineSegment>{distance, p, _segments.cend(), _segments.cend()}};
+    std::vector<LineSegment> result{};
+    for(const auto index : candidates) {
+        if(dist(_segments[index], p) <= distance) {
+            result.push_back(_segments[index]);
+        }
+    }
+    return result;
 }
 
 bool CollisionGeometry::IntersectsAny(const LineSegment& linesegment) const
 {
-    const auto cellsToQuery = cellsFromLineSegment(linesegment);
-    for(const auto& cell : cellsToQuery) {
-        const auto iter = _grid.find(cell);
-        if(iter == std::end(_grid)) {
-            continue;
+    return anyCellOnLineSegment(linesegment, [this, &linesegment](int64_t x, int64_t y) {
+        const auto cell = gridCell(x, y);
+        if(!cell) {
+            return false;
         }
-        if(std::find_if(
-               iter->second.cbegin(), iter->second.cend(), [&linesegment](const auto candidate) {
-                   return intersects(linesegment, candidate);
-               }) != iter->second.end()) {
-            return true;
+        for(auto index = _gridOffsets[*cell]; index < _gridOffsets[*cell + 1]; ++index) {
+            if(intersectsFiltered(linesegment, _segments[_gridSegments[index]])) {
+                return true;
+            }
         }
-    }
-    return false;
+        return false;
+    });
 }
 
 bool CollisionGeometry::InsideGeometry(Point p) const
 {
+    // The grid extends beyond all segments, anything outside of it is outside of the geometry.
+    // Cells missing in a sparse grid are far from all segments but may be inside.
+    const auto cell = gridCell(cellIndex(p.x), cellIndex(p.y));
+    if(!cell) {
+        if(!_sparseCells) {
+            return false;
+        }
+    } else {
+        switch(_cellLocations[*cell]) {
+            case CellLocation::Outside:
+                return false;
+            case CellLocation::Inside:
+                return true;
+            case CellLocation::Boundary:
+                break;
+        }
+    }
     return CGAL::oriented_side(K::Point_2(p.x, p.y), _accessibleAreaPolygon) !=
            CGAL::ON_NEGATIVE_SIDE;
 }
 
+void CollisionGeometry::classifyCells(int64_t minX, int64_t minY, int64_t maxX, int64_t maxY)
+{
+    // Cells of a sparse grid are not contiguous and all stay boundary cells
+    if(_sparseCells) {
+        return;
+    }
+    minX = std::max(minX, _gridMinX);
+    minY = std::max(minY, _gridMinY);
+    maxX = std::min(maxX, _gridMinX + _gridWidth - 1);
+    maxY = std::min(maxY, _gridMinY + _gridHeight - 1);
+    if(minX > maxX || minY > maxY) {
+        return;
+    }
+    const auto width = maxX - minX + 1;
+    const auto height = maxY - minY + 1;
+    const auto hasSegments = [this](size_t cell) {
+        return _gridOffsets[cell] != _gridOffsets[cell + 1];
+    };
+
+    // Cells without segments are either completely inside or completely outside. Neighboring
+    // cells without segments are not separated by the boundary, so each connected region of
+    // them is classified with a single exact test of one of its cells.
+    std::vector<bool> visited(static_cast<size_t>(width * height), false);
+    std::vector<size_t> region{};
+    std::vector<std::pair<int64_t, int64_t>> stack{};
+    for(auto startY = minY; startY <= maxY; ++startY) {
+        for(auto startX = minX; startX <= maxX; ++startX) {
+            const auto start = *gridCell(startX, startY);
+            const auto startVisited = static_cast<size_t>((startY - minY) * width + startX - minX);
+            if(hasSegments(start)) {
+                _cellLocations[start] = CellLocation::Boundary;
+                continue;
+            }
+            if(visited[startVisited]) {
+                continue;
+            }
+            region.clear();
+            stack.emplace_back(startX, startY);
+            visited[startVisited] = true;
+            while(!stack.empty()) {
+                const auto [x, y] = stack.back();
+                stack.pop_back();
+                region.push_back(*gridCell(x, y));
+                for(const auto& [dx, dy] : {std::pair{-1, 0}, {1, 0}, {0, -1}, {0, 1}}) {
+                    const auto nx = x + dx;
+                    const auto ny = y + dy;
+                    if(nx < minX || nx > maxX || ny < minY || ny > maxY) {
+                        continue;
+                    }
+                    const auto neighborVisited =
+                        static_cast<size_t>((ny - minY) * width + nx - minX);
+                    if(!visited[neighborVisited] && !hasSegments(*gridCell(nx, ny))) {
+                        visited[neighborVisited] = true;
+                        stack.emplace_back(nx, ny);
+                    }
+                }
+            }
+
+            const K::Point_2 center(
+                (static_cast<double>(startX) + 0.5) * CELL_EXTEND,
+                (static_cast<double>(startY) + 0.5) * CELL_EXTEND);
+            const auto location =
+                CGAL::oriented_side(center, _accessibleAreaPolygon) == CGAL::ON_NEGATIVE_SIDE ?
+                    CellLocation::Outside :
+                    CellLocation::Inside;
+            for(const auto cell : region) {
+                _cellLocations[cell] = location;
+            }
+        }
+    }
+}
+
+const WallDistanceField& CollisionGeometry::WallDistances(double resolution) const
+{
+    auto& cache = *_wallDistanceCache;
+    if(const auto* field = cache.field.load(std::memory_order_acquire);
+       field != nullptr && field->Resolution() == resolution) {
+        return *field;
+    }
+    std::lock_guard lock(cache.mutex);
+    if(!cache.storage) {
+        cache.storage = std::make_unique<WallDistanceField>(*this, resolution);
+        cache.field.store(cache.storage.get(), std::memory_order_release);
+    }
+    if(cache.storage->Resolution() != resolution) {
+        throw SimulationError(
+            "Wall distance field was already built with resolution {}, cannot use {}",
+            cache.storage->Resolution(),
+            resolution);
+    }
+    return *cache.storage;
+}
+
 const std::tuple<std::vector<Point>, std::vector<std::vector<Point>>>&
 CollisionGeometry::AccessibleArea() const
 {
@@ -3,69 +3,33 @@
 
 #include "CfgCgal.hpp"
 #include "HashCombine.hpp"
-#include "IteratorPair.hpp"
 #include "LineSegment.hpp"
 #include "Point.hpp"
 #include "UniqueID.hpp"
+#include "WallDistanceField.hpp"
 
+#include <atomic>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <set>
+#include <span>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 class CollisionGeometry;
+class RoutingEngine;
 
 double dist(LineSegment l, Point p);
 
-template <typename T>
-class DistanceQueryIterator
-{
-private:
-    using BackingIterator = typename std::vector<T>::const_iterator;
-    double _distance;
-    Point _p;
-    BackingIterator _current;
-    BackingIterator _end;
-
-public:
-    using iterator_category = std::input_iterator_tag;
-    using value_type = T;
-    using difference_type = std::ptrdiff_t;
-    using pointer = T*;
-    using reference = T&;
-    DistanceQueryIterator(double distance, Point p, BackingIterator current, BackingIterator end)
-        : _distance(distance)
-        , _p(p)
-        , _current(
-              std::find_if(
-                  current,
-                  end,
-                  [this](const auto& t) { return dist(t, _p) <= _distance; }))
-        , _end(end)
-    {
-    }
-    ~DistanceQueryIterator() = default;
-    DistanceQueryIterator(const DistanceQueryIterator& other) = default;
-    DistanceQueryIterator& operator=(const DistanceQueryIterator& other) = default;
-
-    bool operator==(const DistanceQueryIterator& other) const { return _current == other._current; }
-
-    bool operator!=(const DistanceQueryIterator& other) const { return !(*this == other); }
-
-    DistanceQueryIterator& operator++()
-    {
-        do {
-            ++_current;
-        } while(_current != _end && dist(*_current, _p) > _distance);
-        return *this;
-    }
-
-    const T& operator*() const { return *_current; }
-};
-
 /// Encodes a cell in the geometry grid.
 /// Cells are defined on the intervalls [min.x, min.x + extend), [min.y, min.y + extend)
 const int CELL_EXTEND = 4;
@@ -92,17 +56,131 @@ struct std::hash<Cell> {
 /// Creates all cells that are trouched by the linesegment
 std::set<Cell> cellsFromLineSegment(LineSegment ls);
 
+/// Integer coordinate of the cell containing 'coordinate' along one axis, i.e. the cell
+/// [index * CELL_EXTEND, (index + 1) * CELL_EXTEND).
+inline int64_t cellIndex(double coordinate)
+{
+    return static_cast<int64_t>(std::floor(coordinate / CELL_EXTEND));
+}
+
+/// Walks all cells touched by 'ls' from 'ls.p1' to 'ls.p2' (DDA traversal) and calls
+/// 'func(x, y)' with the integer coordinates of each cell. Returns true as soon as 'func' returns
+/// true, false if 'func' returned false for all cells.
+/// When the segment passes through a cell corner both cells adjacent to the corner are visited as
+/// well, so the visited cells are a superset of 'cellsFromLineSegment'. Does not allocate.
+template <typename Func>
+bool anyCellOnLineSegment(LineSegment ls, Func&& func)
+{
+    constexpr double tieTolerance = 1e-9;
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+    auto x = cellIndex(ls.p1.x);
+    auto y = cellIndex(ls.p1.y);
+    const auto lastX = cellIndex(ls.p2.x);
+    const auto lastY = cellIndex(ls.p2.y);
+    const int64_t stepX = lastX < x ? -1 : 1;
+    const int64_t stepY = lastY < y ? -1 : 1;
+    auto stepsX = (lastX - x) * stepX;
+    auto stepsY = (lastY - y) * stepY;
+
+    // Parameter along the segment at which the next cell border is crossed and the parameter
+    // distance between two borders.
+    const auto delta = ls.p2 - ls.p1;
+    const auto firstBorder = [](int64_t cell, int64_t step, double start, double direction) {
+        const auto border = static_cast<double>(step > 0 ? cell + 1 : cell) * CELL_EXTEND;
+        return direction == 0 ? infinity : (border - start) / direction;
+    };
+    auto tMaxX = firstBorder(x, stepX, ls.p1.x, delta.x);
+    auto tMaxY = firstBorder(y, stepY, ls.p1.y, delta.y);
+    const auto tDeltaX = delta.x == 0 ? infinity : CELL_EXTEND / std::abs(delta.x);
+    const auto tDeltaY = delta.y == 0 ? infinity : CELL_EXTEND / std::abs(delta.y);
+
+    if(func(x, y)) {
+        return true;
+    }
+    while(stepsX > 0 || stepsY > 0) {
+        if(stepsX > 0 && stepsY > 0 && std::abs(tMaxX - tMaxY) <= tieTolerance) {
+            if(func(x + stepX, y) || func(x, y + stepY)) {
+                return true;
+            }
+            x += stepX;
+            y += stepY;
+            --stepsX;
+            --stepsY;
+            tMaxX += tDeltaX;
+            tMaxY += tDeltaY;
+        } else if(stepsY == 0 || (stepsX > 0 && tMaxX < tMaxY)) {
+            x += stepX;
+            --stepsX;
+            tMaxX += tDeltaX;
+        } else {
+            y += stepY;
+            --stepsY;
+            tMaxY += tDeltaY;
+        }
+        if(func(x, y)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 class CollisionGeometry
 {
 private:
     PolyWithHoles _accessibleAreaPolygon;
     std::vector<LineSegment> _segments;
-    std::unordered_map<Cell, std::set<LineSegment>> _grid{};
-    std::unordered_map<Cell, std::vector<LineSegment>> _approximateGrid{};
+    /// Integer coordinates of the bottom left cell and size of the cell grid covering all
+    /// segments plus the approximate search radius. Cells of a dense grid are stored row by row.
+    int64_t _gridMinX{};
+    int64_t _gridMinY{};
+    int64_t _gridWidth{};
+    int64_t _gridHeight{};
+    struct CellHash {
+        size_t operator()(const std::pair<int64_t, int64_t>& cell) const noexcept
+        {
+            std::hash<int64_t> hasher{};
+            return jps::hash_combine(hasher(cell.first), hasher(cell.second));
+        }
+    };
+    /// Index of every stored cell if the grid exceeds 'MAX_DENSE_CELLS' cells. A sparse grid only
+    /// stores the cells within the approximate search radius of any segment in the order they
+    /// were added, all of them are classified as 'CellLocation::Boundary'.
+    std::optional<std::unordered_map<std::pair<int64_t, int64_t>, size_t, CellHash>>
+        _sparseCells{};
+    /// Indices into '_segments' of all segments touching a cell, stored in CSR layout: the
+    /// segments of cell 'c' are '_gridSegments[_gridOffsets[c]]' to
+    /// '_gridSegments[_gridOffsets[c + 1]]' (exclusive).
+    std::vector<uint32_t> _gridOffsets{};
+    std::vector<uint32_t> _gridSegments{};
+    /// Copies of all segments within the approximate search radius of a cell in the same CSR
+    /// layout, kept as values so queries return one contiguous range.
+    std::vector<uint32_t> _approximateOffsets{};
+    std::vector<LineSegment> _approximateSegments{};
+    /// Location of each grid cell relative to the accessible area, only points in boundary cells
+    /// need an exact test.
+    enum class CellLocation : uint8_t { Outside, Inside, Boundary };
+    std::vector<CellLocation> _cellLocations{};
+
+    /// Wall distance field built on first request, shared by all copies of this geometry.
+    /// Geometries derived with 'WithObstacle' / 'WithoutObstacle' start with a copy of the field
+    /// of their base in which only the nodes close to the obstacle are recomputed.
+    struct WallDistanceCache {
+        std::mutex mutex{};
+        std::atomic<const WallDistanceField*> field{nullptr};
+        std::unique_ptr<WallDistanceField> storage{};
+    };
+    std::shared_ptr<WallDistanceCache> _wallDistanceCache{std::make_shared<WallDistanceCache>()};
     std::tuple<std::vector<Point>, std::vector<std::vector<Point>>> _accessibleArea{};
+    /// Routing engine built together with this geometry, e.g. loaded from a 'GeometryCache'.
+    /// Shared by all copies, geometries derived with 'WithObstacle' / 'WithoutObstacle' have none.
+    std::shared_ptr<const RoutingEngine> _routingEngine{};
+
+    friend class GeometryCache;
 
 public:
-    using LineSegmentRange = IteratorPair<DistanceQueryIterator<LineSegment>>;
+    /// Upper limit of cells for which a dense grid is used, larger geometries use a sparse grid.
+    static constexpr size_t MAX_DENSE_CELLS = size_t{1} << 20;
+
     /// Do not call constructor drectly use 'GeometryBuilder'
     /// @param segments line segments constituting the geometry
     explicit CollisionGeometry(PolyWithHoles accessibleArea);
@@ -116,13 +194,18 @@ public:
     CollisionGeometry(CollisionGeometry&& other) = default;
     /// Moveable
     CollisionGeometry& operator=(CollisionGeometry&& other) = default;
-    /// Returns an iterator pair to all linesegments <= 'distance' away from 'p'
+    /// Returns all linesegments <= 'distance' away from 'p'
+    /// Only segments in grid cells overlapping the square around 'p' are tested, so the cost
+    /// depends on the local density of the geometry and not on its total size.
     /// @param distance from reference point
     /// @param p reference point
-    /// @return iterator_pair to all linesegments in range
-    LineSegmentRange LineSegmentsInDistanceTo(double distance, Point p) const;
+    /// @return all linesegments in range, in the order they are stored in the geometry
+    std::vector<LineSegment> LineSegmentsInDistanceTo(double distance, Point p) const;
 
-    const std::vector<LineSegment>& LineSegmentsInApproxDistanceTo(Point p) const;
+    /// Returns all linesegments that are close to 'p', i.e. all segments within the search radius
+    /// of the cell containing 'p', and maybe some more.
+    /// The range stays valid as long as the geometry.
+    std::span<const LineSegment> LineSegmentsInApproxDistanceTo(Point p) const;
 
     /// Will perfrom a linesegment intersection versus the whole geometry, i.e. walls and closed
     /// doors.
@@ -130,12 +213,63 @@ public:
     /// @return if any linesegment of the geometry was intersected.
     bool IntersectsAny(const LineSegment& linesegment) const;
 
+    /// Checks if 'p' is inside the accessible area or on its boundary.
+    /// Answered from the precomputed cell classification unless 'p' lies in a cell crossed by a
+    /// segment, only those points are tested against the polygon.
     bool InsideGeometry(Point p) const;
 
     const std::tuple<std::vector<Point>, std::vector<std::vector<Point>>>& AccessibleArea() const;
 
     const PolyWithHoles& Polygon() const { return _accessibleAreaPolygon; }
 
+    /// Returns true if the cells of the grid are stored densely, see 'MAX_DENSE_CELLS'.
+    bool IsDense() const { return !_sparseCells.has_value(); }
+
+    /// Returns the distance field to the walls of this geometry with 'resolution' meters between
+    /// its nodes. The field is built on the first call and then reused, all later calls have to
+    /// ask for the same resolution. Safe to call concurrently.
+    const WallDistanceField& WallDistances(double resolution) const;
+
+    /// Returns a copy of this geometry with 'obstacle' excluded from the accessible area.
+    /// 'obstacle' becomes a new hole and has to lie strictly inside of the accessible area, i.e.
+    /// it may not touch any boundary or contain existing holes. Only grid cells and wall distance
+    /// nodes close to the obstacle are recomputed, all others are copied.
+    CollisionGeometry WithObstacle(const Poly& obstacle) const;
+
+    /// Returns a copy of this geometry with the hole added by 'WithObstacle(obstacle)' removed.
+    /// Only grid cells and wall distance nodes close to the obstacle are recomputed, all others are
+    /// copied.
+    CollisionGeometry WithoutObstacle(const Poly& obstacle) const;
+
+    /// Returns a routing engine for the accessible area of this geometry. Copies the routing
+    /// engine built together with this geometry if there is one, otherwise triangulates the
+    /// accessible area.
+    std::unique_ptr<RoutingEngine> CreateRoutingEngine() const;
+
 private:
-    void insertIntoApproximateGrid(const LineSegment& ls);
+    /// Empty geometry, filled by 'GeometryCache'
+    CollisionGeometry() = default;
+    /// Creates the geometry of 'accessibleArea' from 'base', whose segments only differ by the
+    /// removed segments 'base._segments[removedFirst, removedFirst + removedCount)' and segments
+    /// appended to the end. Both sets of segments have to lie inside of the grid of 'base'.
+    CollisionGeometry(
+        const CollisionGeometry& base,
+        PolyWithHoles accessibleArea,
+        size_t removedFirst,
+        size_t removedCount);
+    /// Fills '_segments' and '_accessibleArea' from '_accessibleAreaPolygon'.
+    void extractAccessibleArea();
+    /// Index of the cell with the integer coordinates 'x', 'y' in the grid or nothing if the cell
+    /// lies outside of the grid or is not stored in a sparse grid.
+    std::optional<size_t> gridCell(int64_t x, int64_t y) const;
+    /// Calls 'func(x, y)' with the integer coordinates of every grid cell within the approximate
+    /// search radius of 'ls'.
+    template <typename Func>
+    void forEachApproximateCell(const LineSegment& ls, Func&& func) const;
+    /// Adds all cells within the approximate search radius of 'segments' to the sparse grid and
+    /// classifies new cells as 'CellLocation::Boundary'.
+    void addSparseCells(std::span<const LineSegment> segments);
+    /// Classifies all cells with integer coordinates in [minX, maxX] x [minY, maxY] and stores
+    /// the result in '_cellLocations', requires the exact grid.
+    void classifyCells(int64_t minX, int64_t minY, int64_t maxX, int64_t maxY);
 };
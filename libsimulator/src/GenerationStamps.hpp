@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Tells apart the entries of reused per-node search arrays that belong to the running search
+/// from those of earlier searches. Starting a search only increments the generation, so the
+/// arrays never have to be cleared once they have grown to the largest search on this thread.
+class GenerationStamps
+{
+    std::vector<uint32_t> stamps{};
+    uint32_t generation{0};
+
+public:
+    /// Starts a new search over 'count' entries, all entries are invalid afterwards.
+    void Begin(size_t count)
+    {
+        if(stamps.size() < count) {
+            stamps.resize(count, 0);
+        }
+        if(++generation == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            generation = 1;
+        }
+    }
+
+    /// True if entry 'index' was marked in the running search.
+    bool IsValid(size_t index) const { return stamps[index] == generation; }
+
+    void Mark(size_t index) { stamps[index] = generation; }
+};
@@ -7,6 +7,14 @@
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 #include <CGAL/Intersections_2/Segment_2_Segment_2.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
 /// Computes the cross product 2D of vectors apex->a (A) and apex->b (B)
 /// Geometrically the absolute value of the cross product in 2d is also the area of the
 /// parallelogram of A and B. The sign of the cross product determines the relation of A and B.
@@ -83,3 +91,86 @@ inline bool intersects(const LineSegment& l1, const LineSegment& l2)
 {
     return intersectsWithCGAL(l1, l2);
 }
+
+namespace detail
+{
+/// Relative error bound of the floating point orientation test, 'ccwerrboundA' from Shewchuk,
+/// "Adaptive Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates".
+constexpr double orientationErrorBound = (3.0 + 8.0 * std::numeric_limits<double>::epsilon()) *
+                                         std::numeric_limits<double>::epsilon() / 2.0;
+
+struct FilteredOrientation {
+    double determinant;
+    /// The sign of 'determinant' is exact and not zero.
+    bool certain;
+};
+
+/// Floating point orientation test of 'c' relative to the line through 'a' and 'b'.
+inline FilteredOrientation filteredOrientation(Point a, Point b, Point c)
+{
+    const double left = (a.x - c.x) * (b.y - c.y);
+    const double right = (a.y - c.y) * (b.x - c.x);
+    const double determinant = left - right;
+    const double bound = orientationErrorBound * (std::abs(left) + std::abs(right));
+    return {determinant, std::abs(determinant) > bound};
+}
+
+enum FilteredIntersection : uint8_t { Disjoint = 0, Intersecting = 1, Ambiguous = 2 };
+
+/// Classifies the segments 'p'-'q' and 'a'-'b' without branches, 'Ambiguous' if floating point
+/// arithmetic cannot decide whether they intersect.
+inline FilteredIntersection classifyIntersection(Point p, Point q, Point a, Point b)
+{
+    const bool overlaps = std::min(a.x, b.x) <= std::max(p.x, q.x) &&
+                          std::max(a.x, b.x) >= std::min(p.x, q.x) &&
+                          std::min(a.y, b.y) <= std::max(p.y, q.y) &&
+                          std::max(a.y, b.y) >= std::min(p.y, q.y);
+    const auto o1 = filteredOrientation(p, q, a);
+    const auto o2 = filteredOrientation(p, q, b);
+    const auto o3 = filteredOrientation(a, b, p);
+    const auto o4 = filteredOrientation(a, b, q);
+    const bool certain = o1.certain & o2.certain & o3.certain & o4.certain;
+    const bool crosses = ((o1.determinant < 0) != (o2.determinant < 0)) &
+                         ((o3.determinant < 0) != (o4.determinant < 0));
+    return static_cast<FilteredIntersection>(
+        (overlaps & certain & crosses) * Intersecting + (overlaps & !certain) * Ambiguous);
+}
+} // namespace detail
+
+/// Same result as 'intersects' but only falls back to CGAL if the floating point filter of
+/// 'intersectsAny' cannot decide.
+inline bool intersectsFiltered(const LineSegment& l1, const LineSegment& l2)
+{
+    const auto state = detail::classifyIntersection(l1.p1, l1.p2, l2.p1, l2.p2);
+    return state == detail::Intersecting ||
+           (state == detail::Ambiguous && intersectsWithCGAL(l1, l2));
+}
+
+/// Checks 'segment' against all 'segments', gives the same result as calling 'intersects' for
+/// each of them.
+/// Segment pairs are first classified with bounding boxes and floating point orientation tests in
+/// a branch free loop over blocks of segments. Only pairs for which these tests cannot decide,
+/// i.e. touching, collinear or nearly degenerate pairs, are passed to the exact CGAL predicate.
+inline bool intersectsAny(const LineSegment& segment, std::span<const LineSegment> segments)
+{
+    constexpr size_t blockSize = 8;
+    std::array<detail::FilteredIntersection, blockSize> state{};
+    for(size_t first = 0; first < segments.size(); first += blockSize) {
+        const size_t count = std::min(blockSize, segments.size() - first);
+        for(size_t index = 0; index < count; ++index) {
+            const auto& other = segments[first + index];
+            state[index] =
+                detail::classifyIntersection(segment.p1, segment.p2, other.p1, other.p2);
+        }
+        for(size_t index = 0; index < count; ++index) {
+            if(state[index] == detail::Intersecting) {
+                return true;
+            }
+            if(state[index] == detail::Ambiguous &&
+               intersectsWithCGAL(segment, segments[first + index])) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
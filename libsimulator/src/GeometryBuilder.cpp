@@ -3,17 +3,58 @@
 
 #include "CfgCgal.hpp"
 #include "CollisionGeometry.hpp"
+#include "GeometryCache.hpp"
 #include "Point.hpp"
 #include "RoutingEngine.hpp"
 #include "SimulationError.hpp"
+#include "ThreadPool.hpp"
 
-#include <CGAL/Boolean_set_operations_2.h>
+#include <CGAL/Polygon_set_2.h>
 #include <fmt/format.h>
 #include <fmt/ranges.h>
 
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
 #include <memory>
 #include <vector>
 
+namespace
+{
+using PolySet = CGAL::Polygon_set_2<K>;
+
+/// Unites all 'polygons' in a balanced tree of pairwise merges. Level 'stride' of the tree merges
+/// set 'i + stride' into set 'i' for every 'i' that is a multiple of '2 * stride', all merges of
+/// one level run in parallel on 'pool'. The tree only depends on the number of polygons.
+PolySet unite(const std::vector<Polygon>& polygons, ThreadPool& pool)
+{
+    std::vector<PolySet> sets{};
+    sets.reserve(polygons.size());
+    for(const auto& polygon : polygons) {
+        sets.emplace_back(static_cast<Poly>(polygon));
+    }
+    if(sets.empty()) {
+        return {};
+    }
+    for(size_t stride = 1; stride < sets.size(); stride *= 2) {
+        const auto mergeCount = (sets.size() + stride - 1) / (2 * stride);
+        pool.ParallelFor(
+            mergeCount,
+            [&sets, stride](size_t merge) {
+                const auto target = 2 * stride * merge;
+                sets[target].join(sets[target + stride]);
+                sets[target + stride].clear();
+            },
+            1);
+    }
+    return sets.front();
+}
+} // namespace
+
+GeometryBuilder::GeometryBuilder(size_t threadCount) : _threadCount(threadCount)
+{
+}
+
 GeometryBuilder& GeometryBuilder::AddAccessibleArea(const std::vector<Point>& lineLoop)
 {
     _accessibleAreas.emplace_back(lineLoop);
@@ -28,36 +69,31 @@ GeometryBuilder& GeometryBuilder::ExcludeFromAccessibleArea(const std::vector<Po
 
 CollisionGeometry GeometryBuilder::Build()
 {
-    const std::vector<Poly> accessibleListInput{
-        std::begin(_accessibleAreas), std::end(_accessibleAreas)};
-    PolyWithHolesList accessibleList{};
-
-    CGAL::join(
-        std::begin(accessibleListInput),
-        std::end(accessibleListInput),
-        std::back_inserter(accessibleList));
+    // The first level of the larger union has the most independent merges
+    const auto maxMerges = std::max(_accessibleAreas.size(), _exclusions.size()) / 2;
+    ThreadPool pool(std::min(std::max<size_t>(maxMerges, 1), _threadCount));
 
-    if(accessibleList.size() != 1) {
+    auto accessibleArea = unite(_accessibleAreas, pool);
+    if(accessibleArea.number_of_polygons_with_holes() != 1) {
         throw SimulationError("accessible area not connected");
     }
 
-    auto accessibleArea = *accessibleList.begin();
-
-    const std::vector<Poly> exclusionsListInput{std::begin(_exclusions), std::end(_exclusions)};
-    PolyWithHolesList exclusionsList{};
-    CGAL::join(
-        std::begin(exclusionsListInput),
-        std::end(exclusionsListInput),
-        std::back_inserter(exclusionsList));
-
-    for(const auto& ex : exclusionsList) {
-        PolyWithHolesList res{};
-        CGAL::difference(accessibleArea, ex, std::back_inserter(res));
-        if(res.size() != 1) {
+    if(!_exclusions.empty()) {
+        accessibleArea.difference(unite(_exclusions, pool));
+        if(accessibleArea.number_of_polygons_with_holes() != 1) {
             throw SimulationError("Exclusion splits accessibleArea");
         }
-        accessibleArea = *res.begin();
     }
 
-    return CollisionGeometry(accessibleArea);
+    PolyWithHolesList accessibleList{};
+    accessibleArea.polygons_with_holes(std::back_inserter(accessibleList));
+    return CollisionGeometry(accessibleList.front());
+}
+
+CollisionGeometry GeometryBuilder::Build(const std::filesystem::path& cacheDirectory)
+{
+    const GeometryCache::Input input{
+        {std::begin(_accessibleAreas), std::end(_accessibleAreas)},
+        {std::begin(_exclusions), std::end(_exclusions)}};
+    return GeometryCache(cacheDirectory).LoadOrBuild(input, [this]() { return Build(); });
 }
@@ -5,15 +5,22 @@
 #include "Point.hpp"
 #include "Polygon.hpp"
 
+#include <cstddef>
+#include <filesystem>
 #include <vector>
 
 class GeometryBuilder
 {
     std::vector<Polygon> _accessibleAreas{};
     std::vector<Polygon> _exclusions{};
+    size_t _threadCount{1};
 
 public:
+    /// Builder using a single thread.
     GeometryBuilder() = default;
+    /// Builder using at most 'threadCount' threads to unite the polygons. The built geometry does
+    /// not depend on the number of threads, building throws if 'threadCount' is 0.
+    explicit GeometryBuilder(size_t threadCount);
     ~GeometryBuilder() = default;
     GeometryBuilder(const GeometryBuilder& other) = delete;
     GeometryBuilder& operator=(const GeometryBuilder& other) = delete;
@@ -22,5 +29,13 @@ public:
 
     GeometryBuilder& AddAccessibleArea(const std::vector<Point>& lineLoop);
     GeometryBuilder& ExcludeFromAccessibleArea(const std::vector<Point>& lineLoop);
+    /// Unites all accessible areas and all exclusions and subtracts the exclusions from the
+    /// accessible areas.
+    /// Both unions merge neighboring polygons pairwise in a balanced tree, all merges of one level
+    /// of the tree run in parallel. The exclusions are subtracted with a single difference.
     CollisionGeometry Build();
+    /// Same as 'Build' but loads the geometry and its triangulation from the GeometryCache in
+    /// 'cacheDirectory' if it was built from the same input before, otherwise builds and stores
+    /// it.
+    CollisionGeometry Build(const std::filesystem::path& cacheDirectory);
 };
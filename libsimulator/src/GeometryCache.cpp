@@ -0,0 +1,592 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "GeometryCache.hpp"
+
+#include "CfgCgal.hpp"
+#include "CollisionGeometry.hpp"
+#include "LineSegment.hpp"
+#include "Point.hpp"
+#include "RoutingEngine.hpp"
+
+#include <Logger.hpp>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <span>
+#include <system_error>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace
+{
+constexpr std::array<char, 8> fileMagic{'J', 'P', 'S', 'G', 'E', 'O', 'C', '\0'};
+constexpr uint32_t byteOrderMark{0x01020304};
+constexpr size_t sectionAlignment{8};
+
+struct FileHeader {
+    std::array<char, 8> magic{};
+    uint32_t version{};
+    uint32_t byteOrder{};
+    uint64_t key{};
+};
+
+/// Face of the triangulation as stored in the cache. Vertex 0 is the infinite vertex, all other
+/// vertices are the finite vertices in stored order.
+struct CachedFace {
+    std::array<uint32_t, 3> vertices{};
+    std::array<uint32_t, 3> neighbors{};
+    /// Bits 0 to 2 mark constrained edges, bit 3 marks faces inside of the domain
+    uint32_t flags{};
+};
+constexpr uint32_t inDomainFlag{1u << 3};
+
+static_assert(std::is_trivially_copyable_v<Point>);
+static_assert(std::is_trivially_copyable_v<LineSegment>);
+static_assert(sizeof(LineSegment) == 4 * sizeof(double));
+
+/// Appends values and arrays to a buffer, every array is prefixed with its size and padded to
+/// 'sectionAlignment'.
+class Writer
+{
+    std::vector<char> _buffer{};
+
+public:
+    template <typename T>
+    void Value(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        Bytes(&value, sizeof(T));
+    }
+
+    template <typename T>
+    void Array(std::span<const T> values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        Value(static_cast<uint64_t>(values.size()));
+        Bytes(values.data(), values.size_bytes());
+    }
+
+    const std::vector<char>& Buffer() const { return _buffer; }
+
+private:
+    void Bytes(const void* data, size_t size)
+    {
+        const auto begin = static_cast<const char*>(data);
+        _buffer.insert(_buffer.end(), begin, begin + size);
+        const auto padded = (_buffer.size() + sectionAlignment - 1) / sectionAlignment;
+        _buffer.resize(padded * sectionAlignment);
+    }
+};
+
+/// Reads what 'Writer' wrote. Once a read runs past the end of the buffer all further reads
+/// return empty values and 'Valid' returns false.
+class Reader
+{
+    std::span<const char> _buffer;
+    size_t _offset{0};
+    bool _valid{true};
+
+public:
+    explicit Reader(std::span<const char> buffer) : _buffer(buffer) {}
+
+    template <typename T>
+    T Value()
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value{};
+        Bytes(&value, sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    std::vector<T> Array()
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto size = Value<uint64_t>();
+        if(!_valid || size > (_buffer.size() - _offset) / sizeof(T)) {
+            _valid = false;
+            return {};
+        }
+        std::vector<T> values(size);
+        Bytes(values.data(), size * sizeof(T));
+        return values;
+    }
+
+    /// True if all reads succeeded and the whole buffer was read.
+    bool Valid() const { return _valid && _offset == _buffer.size(); }
+
+private:
+    void Bytes(void* data, size_t size)
+    {
+        const auto padded = (size + sectionAlignment - 1) / sectionAlignment * sectionAlignment;
+        if(!_valid || padded > _buffer.size() - _offset) {
+            _valid = false;
+            return;
+        }
+        std::memcpy(data, _buffer.data() + _offset, size);
+        _offset += padded;
+    }
+};
+
+/// Stable FNV-1a hash of a sequence of 64 bit values.
+class Fnv1a
+{
+    uint64_t _hash{14695981039346656037ull};
+
+public:
+    void Add(uint64_t value)
+    {
+        for(size_t byte = 0; byte < sizeof(value); ++byte) {
+            _hash ^= (value >> (8 * byte)) & 0xff;
+            _hash *= 1099511628211ull;
+        }
+    }
+
+    void Add(const Poly& polygon)
+    {
+        Add(polygon.size());
+        for(auto iter = polygon.vertices_begin(); iter != polygon.vertices_end(); ++iter) {
+            Add(std::bit_cast<uint64_t>(CGAL::to_double(iter->x())));
+            Add(std::bit_cast<uint64_t>(CGAL::to_double(iter->y())));
+        }
+    }
+
+    uint64_t Value() const { return _hash; }
+};
+
+Poly toPoly(std::span<const Point> points)
+{
+    Poly polygon{};
+    for(const auto& p : points) {
+        polygon.push_back(K::Point_2(p.x, p.y));
+    }
+    return polygon;
+}
+
+void appendPoints(const Poly& polygon, std::vector<Point>& points)
+{
+    for(auto iter = polygon.vertices_begin(); iter != polygon.vertices_end(); ++iter) {
+        points.emplace_back(CGAL::to_double(iter->x()), CGAL::to_double(iter->y()));
+    }
+}
+
+/// Writes the sizes and then the points of 'polygons'.
+void writePolygons(const std::vector<Poly>& polygons, Writer& writer)
+{
+    std::vector<uint64_t> sizes{};
+    std::vector<Point> points{};
+    for(const auto& polygon : polygons) {
+        sizes.push_back(polygon.size());
+        appendPoints(polygon, points);
+    }
+    writer.Array(std::span<const uint64_t>(sizes));
+    writer.Array(std::span<const Point>(points));
+}
+
+/// Checks that 'sizes' and 'points' as written by 'writePolygons' hold exactly 'polygons'.
+bool matchesPolygons(
+    const std::vector<uint64_t>& sizes,
+    const std::vector<Point>& points,
+    const std::vector<Poly>& polygons)
+{
+    std::vector<Point> expected{};
+    for(const auto& polygon : polygons) {
+        appendPoints(polygon, expected);
+    }
+    return std::equal(
+               sizes.begin(),
+               sizes.end(),
+               polygons.begin(),
+               polygons.end(),
+               [](auto size, const auto& polygon) { return size == polygon.size(); }) &&
+           points == expected;
+}
+
+/// Checks that 'offsets' is a valid CSR offset array for 'cellCount' cells over 'valueCount'
+/// values. An empty grid has no offsets at all.
+bool isValidCsr(const std::vector<uint32_t>& offsets, size_t valueCount, size_t cellCount)
+{
+    if(cellCount == 0 && offsets.empty()) {
+        return valueCount == 0;
+    }
+    return offsets.size() == cellCount + 1 && offsets.front() == 0 &&
+           offsets.back() == valueCount && std::is_sorted(offsets.begin(), offsets.end());
+}
+
+/// Checks that all faces reference existing and distinct vertices, every vertex is part of a face
+/// and neighboring faces point back to each other across the same edge with the same constraint,
+/// as required by the triangulation data structure.
+bool isValidTriangulation(size_t vertexCount, const std::vector<CachedFace>& faces)
+{
+    if(faces.empty()) {
+        return vertexCount == 0;
+    }
+    std::vector<bool> used(vertexCount + 1, false);
+    for(const auto& face : faces) {
+        for(size_t corner = 0; corner < 3; ++corner) {
+            if(face.vertices[corner] > vertexCount || face.neighbors[corner] >= faces.size()) {
+                return false;
+            }
+            used[face.vertices[corner]] = true;
+        }
+        if(face.vertices[0] == face.vertices[1] || face.vertices[1] == face.vertices[2] ||
+           face.vertices[2] == face.vertices[0]) {
+            return false;
+        }
+    }
+    if(!std::all_of(used.begin(), used.end(), [](bool u) { return u; })) {
+        return false;
+    }
+    const auto isConstrained = [](const CachedFace& face, size_t corner) {
+        return (face.flags & (1u << corner)) != 0;
+    };
+    for(size_t index = 0; index < faces.size(); ++index) {
+        const auto& face = faces[index];
+        for(size_t corner = 0; corner < 3; ++corner) {
+            // Both faces share the edge opposite of their corners in reverse direction
+            const auto& neighbor = faces[face.neighbors[corner]];
+            const auto first = face.vertices[(corner + 1) % 3];
+            const auto second = face.vertices[(corner + 2) % 3];
+            bool found = false;
+            for(size_t other = 0; other < 3 && !found; ++other) {
+                found = neighbor.neighbors[other] == index &&
+                        neighbor.vertices[(other + 1) % 3] == second &&
+                        neighbor.vertices[(other + 2) % 3] == first &&
+                        isConstrained(neighbor, other) == isConstrained(face, corner);
+            }
+            if(!found) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void writeTriangulation(const CDT& cdt, Writer& writer)
+{
+    std::vector<Point> points{};
+    std::vector<CachedFace> cachedFaces{};
+    if(cdt.dimension() == 2) {
+        std::unordered_map<CDT::Vertex_handle, uint32_t> vertexIndices{
+            {cdt.infinite_vertex(), 0}};
+        for(const CDT::Vertex_handle vertex : cdt.finite_vertex_handles()) {
+            vertexIndices.emplace(vertex, static_cast<uint32_t>(vertexIndices.size()));
+            points.emplace_back(
+                CGAL::to_double(vertex->point().x()), CGAL::to_double(vertex->point().y()));
+        }
+        std::unordered_map<CDT::Face_handle, uint32_t> faceIndices{};
+        for(const CDT::Face_handle face : cdt.all_face_handles()) {
+            faceIndices.emplace(face, static_cast<uint32_t>(faceIndices.size()));
+        }
+        cachedFaces.reserve(faceIndices.size());
+        for(const CDT::Face_handle face : cdt.all_face_handles()) {
+            CachedFace cached{};
+            for(int corner = 0; corner < 3; ++corner) {
+                cached.vertices[corner] = vertexIndices.at(face->vertex(corner));
+                cached.neighbors[corner] = faceIndices.at(face->neighbor(corner));
+                if(face->is_constrained(corner)) {
+                    cached.flags |= 1u << corner;
+                }
+            }
+            if(face->get_in_domain()) {
+                cached.flags |= inDomainFlag;
+            }
+            cachedFaces.push_back(cached);
+        }
+    }
+    writer.Array(std::span<const Point>(points));
+    writer.Array(std::span<const CachedFace>(cachedFaces));
+}
+
+/// Rebuilds the triangulation data structure of 'cdt' from validated cached data.
+void restoreTriangulation(
+    CDT& cdt,
+    const std::vector<Point>& points,
+    const std::vector<CachedFace>& cachedFaces)
+{
+    if(cachedFaces.empty()) {
+        return;
+    }
+    auto& tds = cdt.tds();
+    tds.clear();
+    tds.set_dimension(2);
+
+    std::vector<CDT::Vertex_handle> vertices{};
+    vertices.reserve(points.size() + 1);
+    vertices.push_back(tds.create_vertex());
+    for(const auto& p : points) {
+        const auto vertex = tds.create_vertex();
+        vertex->set_point(K::Point_2(p.x, p.y));
+        vertices.push_back(vertex);
+    }
+    cdt.set_infinite_vertex(vertices.front());
+
+    std::vector<CDT::Face_handle> faces{};
+    faces.reserve(cachedFaces.size());
+    for(const auto& cached : cachedFaces) {
+        faces.push_back(tds.create_face(
+            vertices[cached.vertices[0]],
+            vertices[cached.vertices[1]],
+            vertices[cached.vertices[2]]));
+    }
+    for(size_t index = 0; index < faces.size(); ++index) {
+        const auto& cached = cachedFaces[index];
+        const auto face = faces[index];
+        face->set_neighbors(
+            faces[cached.neighbors[0]], faces[cached.neighbors[1]], faces[cached.neighbors[2]]);
+        for(int corner = 0; corner < 3; ++corner) {
+            face->set_constraint(corner, (cached.flags & (1u << corner)) != 0);
+            face->vertex(corner)->set_face(face);
+        }
+        face->set_in_domain((cached.flags & inDomainFlag) != 0);
+    }
+}
+} // namespace
+
+uint64_t GeometryCache::Key(const Input& input)
+{
+    Fnv1a hash{};
+    hash.Add(FormatVersion);
+    hash.Add(input.accessibleAreas.size());
+    for(const auto& polygon : input.accessibleAreas) {
+        hash.Add(polygon);
+    }
+    hash.Add(input.exclusions.size());
+    for(const auto& polygon : input.exclusions) {
+        hash.Add(polygon);
+    }
+    return hash.Value();
+}
+
+GeometryCache::GeometryCache(std::filesystem::path directory) : _directory(std::move(directory))
+{
+}
+
+CollisionGeometry GeometryCache::LoadOrBuild(
+    const Input& input,
+    const std::function<CollisionGeometry()>& build) const
+{
+    if(auto geometry = Load(input)) {
+        return std::move(*geometry);
+    }
+    auto geometry = build();
+    auto routingEngine = std::make_shared<RoutingEngine>(geometry.Polygon());
+    Store(input, geometry, *routingEngine);
+    geometry._routingEngine = std::move(routingEngine);
+    return geometry;
+}
+
+std::optional<CollisionGeometry> GeometryCache::Load(const Input& input) const
+{
+    const auto key = Key(input);
+    const auto path = EntryPath(key);
+    std::error_code error{};
+    const auto size = std::filesystem::file_size(path, error);
+    if(error) {
+        return std::nullopt;
+    }
+    std::vector<char> buffer(size);
+    std::ifstream file(path, std::ios::binary);
+    if(!file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()))) {
+        return std::nullopt;
+    }
+
+    Reader reader(buffer);
+    const auto header = reader.Value<FileHeader>();
+    if(header.magic != fileMagic || header.version != FormatVersion ||
+       header.byteOrder != byteOrderMark || header.key != key) {
+        return std::nullopt;
+    }
+
+    const auto accessibleAreaSizes = reader.Array<uint64_t>();
+    const auto accessibleAreaPoints = reader.Array<Point>();
+    const auto exclusionSizes = reader.Array<uint64_t>();
+    const auto exclusionPoints = reader.Array<Point>();
+    const auto outer = reader.Array<Point>();
+    const auto holeSizes = reader.Array<uint64_t>();
+    const auto holePoints = reader.Array<Point>();
+    const auto grid = reader.Array<int64_t>();
+    const auto sparseCells = reader.Array<int64_t>();
+    auto gridOffsets = reader.Array<uint32_t>();
+    auto gridSegments = reader.Array<uint32_t>();
+    auto approximateOffsets = reader.Array<uint32_t>();
+    auto approximateSegments = reader.Array<LineSegment>();
+    const auto cellLocations = reader.Array<uint8_t>();
+    const auto vertices = reader.Array<Point>();
+    const auto faces = reader.Array<CachedFace>();
+    if(!reader.Valid() || outer.size() < 3 || grid.size() != 4) {
+        return std::nullopt;
+    }
+    if(!matchesPolygons(accessibleAreaSizes, accessibleAreaPoints, input.accessibleAreas) ||
+       !matchesPolygons(exclusionSizes, exclusionPoints, input.exclusions)) {
+        return std::nullopt;
+    }
+
+    std::vector<Poly> holes{};
+    size_t holeStart = 0;
+    for(const auto holeSize : holeSizes) {
+        if(holeSize < 3 || holeSize > holePoints.size() - holeStart) {
+            return std::nullopt;
+        }
+        holes.push_back(toPoly(std::span(holePoints).subspan(holeStart, holeSize)));
+        holeStart += holeSize;
+    }
+    if(holeStart != holePoints.size()) {
+        return std::nullopt;
+    }
+
+    const auto gridWidth = grid[2];
+    const auto gridHeight = grid[3];
+    if(gridWidth < 0 || gridHeight < 0 ||
+       (gridWidth > 0 && gridHeight > std::numeric_limits<int64_t>::max() / gridWidth)) {
+        return std::nullopt;
+    }
+    // Sparse grids list the coordinates of their cells in the order of the cell indices
+    const bool sparse = !sparseCells.empty();
+    const auto denseCellCount = static_cast<double>(gridWidth) * static_cast<double>(gridHeight);
+    if(sparse != (denseCellCount > CollisionGeometry::MAX_DENSE_CELLS) ||
+       sparseCells.size() % 2 != 0) {
+        return std::nullopt;
+    }
+    const auto cellCount =
+        sparse ? sparseCells.size() / 2 : static_cast<size_t>(gridWidth * gridHeight);
+    if(cellLocations.size() != cellCount ||
+       !isValidCsr(gridOffsets, gridSegments.size(), cellCount) ||
+       !isValidCsr(approximateOffsets, approximateSegments.size(), cellCount) ||
+       std::any_of(cellLocations.begin(), cellLocations.end(), [](auto location) {
+           return location > static_cast<uint8_t>(CollisionGeometry::CellLocation::Boundary);
+       })) {
+        return std::nullopt;
+    }
+    if(!isValidTriangulation(vertices.size(), faces)) {
+        return std::nullopt;
+    }
+
+    CollisionGeometry geometry{};
+    geometry._accessibleAreaPolygon = PolyWithHoles(toPoly(outer), holes.begin(), holes.end());
+    geometry.extractAccessibleArea();
+    if(std::any_of(gridSegments.begin(), gridSegments.end(), [&](auto index) {
+           return index >= geometry._segments.size();
+       })) {
+        return std::nullopt;
+    }
+    geometry._gridMinX = grid[0];
+    geometry._gridMinY = grid[1];
+    geometry._gridWidth = gridWidth;
+    geometry._gridHeight = gridHeight;
+    if(sparse) {
+        auto& cells = geometry._sparseCells.emplace();
+        for(size_t cell = 0; cell < cellCount; ++cell) {
+            const auto x = sparseCells[2 * cell];
+            const auto y = sparseCells[2 * cell + 1];
+            const auto outside =
+                x < grid[0] || x - grid[0] >= gridWidth || y < grid[1] || y - grid[1] >= gridHeight;
+            if(outside || !cells.try_emplace({x, y}, cell).second) {
+                return std::nullopt;
+            }
+        }
+    }
+    geometry._gridOffsets = std::move(gridOffsets);
+    geometry._gridSegments = std::move(gridSegments);
+    geometry._approximateOffsets = std::move(approximateOffsets);
+    geometry._approximateSegments = std::move(approximateSegments);
+    geometry._cellLocations.reserve(cellCount);
+    std::transform(
+        cellLocations.begin(),
+        cellLocations.end(),
+        std::back_inserter(geometry._cellLocations),
+        [](auto location) { return static_cast<CollisionGeometry::CellLocation>(location); });
+
+    auto routingEngine = std::make_shared<RoutingEngine>();
+    restoreTriangulation(routingEngine->cdt, vertices, faces);
+    routingEngine->indexFaces();
+    geometry._routingEngine = std::move(routingEngine);
+    return geometry;
+}
+
+bool GeometryCache::Store(
+    const Input& input,
+    const CollisionGeometry& geometry,
+    const RoutingEngine& routingEngine) const
+{
+    const auto key = Key(input);
+    Writer writer{};
+    writer.Value(FileHeader{fileMagic, FormatVersion, byteOrderMark, key});
+    writePolygons(input.accessibleAreas, writer);
+    writePolygons(input.exclusions, writer);
+
+    const auto& polygon = geometry._accessibleAreaPolygon;
+    std::vector<Point> outer{};
+    appendPoints(polygon.outer_boundary(), outer);
+    std::vector<uint64_t> holeSizes{};
+    std::vector<Point> holePoints{};
+    for(const auto& hole : polygon.holes()) {
+        holeSizes.push_back(hole.size());
+        appendPoints(hole, holePoints);
+    }
+    writer.Array(std::span<const Point>(outer));
+    writer.Array(std::span<const uint64_t>(holeSizes));
+    writer.Array(std::span<const Point>(holePoints));
+
+    const std::array<int64_t, 4> grid{
+        geometry._gridMinX, geometry._gridMinY, geometry._gridWidth, geometry._gridHeight};
+    writer.Array(std::span<const int64_t>(grid));
+    std::vector<int64_t> sparseCells{};
+    if(geometry._sparseCells) {
+        sparseCells.resize(2 * geometry._sparseCells->size());
+        for(const auto& [coordinates, cell] : *geometry._sparseCells) {
+            sparseCells[2 * cell] = coordinates.first;
+            sparseCells[2 * cell + 1] = coordinates.second;
+        }
+    }
+    writer.Array(std::span<const int64_t>(sparseCells));
+    writer.Array(std::span<const uint32_t>(geometry._gridOffsets));
+    writer.Array(std::span<const uint32_t>(geometry._gridSegments));
+    writer.Array(std::span<const uint32_t>(geometry._approximateOffsets));
+    writer.Array(std::span<const LineSegment>(geometry._approximateSegments));
+    std::vector<uint8_t> cellLocations(geometry._cellLocations.size());
+    std::transform(
+        geometry._cellLocations.begin(),
+        geometry._cellLocations.end(),
+        cellLocations.begin(),
+        [](auto location) { return static_cast<uint8_t>(location); });
+    writer.Array(std::span<const uint8_t>(cellLocations));
+    writeTriangulation(routingEngine.cdt, writer);
+
+    const auto path = EntryPath(key);
+    auto temporaryPath = path;
+    temporaryPath += fmt::format(".{:08x}.tmp", std::random_device{}());
+    std::error_code error{};
+    std::filesystem::create_directories(_directory, error);
+    if(!error) {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        const auto& buffer = writer.Buffer();
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        file.close();
+        if(!file) {
+            error = std::make_error_code(std::errc::io_error);
+        }
+    }
+    if(!error) {
+        std::filesystem::rename(temporaryPath, path, error);
+    }
+    if(error) {
+        std::filesystem::remove(temporaryPath, error);
+        LOG_WARNING("Could not store geometry in cache {}", path.string());
+        return false;
+    }
+    return true;
+}
+
+std::filesystem::path GeometryCache::EntryPath(uint64_t key) const
+{
+    return _directory / fmt::format("{:016x}.jpsgeo", key);
+}
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "CfgCgal.hpp"
+#include "CollisionGeometry.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <vector>
+
+class RoutingEngine;
+
+/// Stores built geometries on disk so that later runs with the same input skip all CGAL work.
+///
+/// Each entry is one binary file named after the key of its input. It holds the input, the
+/// accessible area, the segment grid of the CollisionGeometry and the triangulation of the
+/// RoutingEngine as flat arrays, every array is aligned to 8 bytes. Values are written in the byte
+/// order of the host, files written on a host with a different byte order are ignored.
+/// Unreadable, truncated or inconsistent entries are treated as a miss and replaced.
+class GeometryCache
+{
+    std::filesystem::path _directory;
+
+public:
+    /// Version of the file format, part of every key. Increment on every change of the format.
+    static constexpr uint32_t FormatVersion{3};
+
+    /// Polygons a geometry is built from, the union of 'accessibleAreas' minus the union of
+    /// 'exclusions'. Every entry stores its input and is only loaded for the same input, so
+    /// inputs with colliding keys never load each other's entry.
+    struct Input {
+        std::vector<Poly> accessibleAreas{};
+        std::vector<Poly> exclusions{};
+    };
+
+    /// Stable key of 'input', names its entry. Depends on the order and the exact coordinates of
+    /// all polygons.
+    static uint64_t Key(const Input& input);
+
+    /// Cache with entries in 'directory', the directory is created when the first entry is
+    /// stored.
+    explicit GeometryCache(std::filesystem::path directory);
+
+    /// Returns the geometry stored for 'input' or builds it with 'build' and stores it.
+    /// The returned geometry carries the triangulation of its RoutingEngine either way, see
+    /// 'CollisionGeometry::CreateRoutingEngine'. Failing to store an entry is not an error.
+    CollisionGeometry
+    LoadOrBuild(const Input& input, const std::function<CollisionGeometry()>& build) const;
+
+    /// Returns the geometry stored for 'input' or nothing if there is no valid entry.
+    std::optional<CollisionGeometry> Load(const Input& input) const;
+
+    /// Stores 'geometry' built from 'input' and the triangulation of 'routingEngine', replacing
+    /// an existing entry. The file is written next to the entry and then renamed, so concurrent
+    /// readers either see the old or the new entry. Returns false if the entry was not written.
+    bool Store(
+        const Input& input,
+        const CollisionGeometry& geometry,
+        const RoutingEngine& routingEngine) const;
+
+    /// Path of the entry stored under 'key'.
+    std::filesystem::path EntryPath(uint64_t key) const;
+};
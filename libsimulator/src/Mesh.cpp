@@ -18,6 +18,7 @@
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <queue>
 #include <set>
@@ -85,6 +86,7 @@ Mesh::Mesh(const CDT& cdt)
     }
 
     updateBoundingBoxes();
+    updatePolygonGrid();
 };
 
 std::unique_ptr<Mesh> Mesh::Clone() const
@@ -99,6 +101,7 @@ void Mesh::MergeGreedy()
     trimEmptyPolygons();
     assert(isValid());
     updateBoundingBoxes();
+    updatePolygonGrid();
 }
 
 void Mesh::mergeDeadEnds()
@@ -174,7 +177,7 @@ double Mesh::polygonArea(const std::vector<size_t> indices) const
         const auto& current_vertex = vertices[indices[index]];
         const auto& next_vertex = vertices[indices[next(index)]];
 
-        area += (current_vertex.x * next_vertex.y) - (current_vertex.y - next_vertex.x);
+        area += (current_vertex.x * next_vertex.y) - (current_vertex.y * next_vertex.x);
     }
     area = std::abs(area) / 2.0;
     return area;
@@ -255,7 +258,7 @@ void Mesh::smartMerge(bool keep_deadends = true)
         const auto node = polygonQueue.top();
         polygonQueue.pop();
 
-        if(abs(node.area - bestMerge[node.source]) > 1e-8) {
+        if(std::abs(node.area - bestMerge[node.source]) > 1e-8) {
             // Not the right node.
             continue;
         }
@@ -358,6 +361,11 @@ bool Mesh::polygonIsConvex(const std::vector<size_t>& indices) const
             // This indicates CW winding between consecutive segments
             return false;
         }
+        if(cp.z == 0.0 && glm::dot(segment_a, segment_b) <= 0.0) {
+            // The boundary turns back onto itself, this happens when merging polygons that
+            // share more than one edge
+            return false;
+        }
     }
     return true;
 }
@@ -534,10 +542,72 @@ void Mesh::updateBoundingBoxes()
         });
 }
 
+void Mesh::updatePolygonGrid()
+{
+    gridWidth = 0;
+    gridHeight = 0;
+    gridOffsets.clear();
+    gridPolygons.clear();
+    if(boundingBoxes.empty()) {
+        return;
+    }
+
+    AABB bounds{};
+    for(const auto& box : boundingBoxes) {
+        bounds.Extend(box);
+    }
+    gridMin = {bounds.xmin, bounds.ymin};
+    gridMax = {bounds.xmax, bounds.ymax};
+    const auto extent = gridMax - gridMin;
+    const auto area = extent.x * extent.y;
+    gridCellSize = area > 0 ? std::sqrt(area / static_cast<double>(boundingBoxes.size())) :
+                              std::max({extent.x, extent.y, 1.});
+    gridWidth = static_cast<size_t>(extent.x / gridCellSize) + 1;
+    gridHeight = static_cast<size_t>(extent.y / gridCellSize) + 1;
+
+    // Visits all cells overlapped by the bounding box of every polygon in ascending order
+    const auto forEachCell = [this](auto&& func) {
+        for(size_t index = 0; index < boundingBoxes.size(); ++index) {
+            const auto& box = boundingBoxes[index];
+            const auto xFirst = gridCoordinate(box.xmin, gridMin.x, gridWidth);
+            const auto xLast = gridCoordinate(box.xmax, gridMin.x, gridWidth);
+            const auto yFirst = gridCoordinate(box.ymin, gridMin.y, gridHeight);
+            const auto yLast = gridCoordinate(box.ymax, gridMin.y, gridHeight);
+            for(size_t y = yFirst; y <= yLast; ++y) {
+                for(size_t x = xFirst; x <= xLast; ++x) {
+                    func(y * gridWidth + x, index);
+                }
+            }
+        }
+    };
+
+    gridOffsets.assign(gridWidth * gridHeight + 1, 0);
+    forEachCell([this](size_t cell, size_t) { ++gridOffsets[cell + 1]; });
+    std::partial_sum(gridOffsets.begin(), gridOffsets.end(), gridOffsets.begin());
+    gridPolygons.resize(gridOffsets.back());
+    std::vector<uint32_t> next(gridOffsets.begin(), gridOffsets.end() - 1);
+    forEachCell([this, &next](size_t cell, size_t index) {
+        gridPolygons[next[cell]++] = static_cast<uint32_t>(index);
+    });
+}
+
+size_t Mesh::gridCoordinate(double value, double min, size_t count) const
+{
+    const auto coordinate = std::floor((value - min) / gridCellSize);
+    return static_cast<size_t>(std::clamp(coordinate, 0., static_cast<double>(count - 1)));
+}
+
 size_t Mesh::FindContainingPolygon(const glm::dvec2& p) const
 {
-    for(size_t index = 0; index < polygons.size(); ++index) {
-        if(boundingBoxes[index].Inside({p.x, p.y}) && TriangleContains(index, p)) {
+    if(gridWidth == 0 || !(p.x >= gridMin.x && p.x <= gridMax.x) ||
+       !(p.y >= gridMin.y && p.y <= gridMax.y)) {
+        return Polygon::InvalidIndex;
+    }
+    const auto cell = gridCoordinate(p.y, gridMin.y, gridHeight) * gridWidth +
+                      gridCoordinate(p.x, gridMin.x, gridWidth);
+    for(auto entry = gridOffsets[cell]; entry < gridOffsets[cell + 1]; ++entry) {
+        const auto index = gridPolygons[entry];
+        if(boundingBoxes[index].Inside({p.x, p.y}) && convexPolygonContains(index, p)) {
             return index;
         }
     }
@@ -682,3 +752,16 @@ bool Mesh::TriangleContains(const size_t polygonIndex, glm::dvec2 p) const
     }
     return true;
 }
+
+bool Mesh::convexPolygonContains(size_t polygonIndex, glm::dvec2 p) const
+{
+    const auto& indices = polygons[polygonIndex].vertices;
+    for(size_t index = 0; index < indices.size(); ++index) {
+        const auto a = vertices[indices[index]];
+        const auto b = vertices[indices[(index + 1) % indices.size()]];
+        if(cross2D(p - a, b - a) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -34,6 +34,16 @@ private:
     /// All convex polygons in this Mesh in CCW orientation.
     std::vector<Polygon> polygons{};
     std::vector<AABB> boundingBoxes{};
+    /// Uniform grid over 'boundingBoxes' used to locate points. Cell (x, y) covers
+    /// [gridMin + (x, y) * gridCellSize, gridMin + (x + 1, y + 1) * gridCellSize) and lists all
+    /// polygons whose bounding box overlaps it in CSR layout, in ascending order.
+    glm::dvec2 gridMin{};
+    glm::dvec2 gridMax{};
+    double gridCellSize{1};
+    size_t gridWidth{0};
+    size_t gridHeight{0};
+    std::vector<uint32_t> gridOffsets{};
+    std::vector<uint32_t> gridPolygons{};
 
 public:
     explicit Mesh(const CDT& cdt);
@@ -47,6 +57,8 @@ public:
     std::vector<glm::vec2> FVertices() const;
     std::vector<uint16_t> TriangleIndices() const;
     std::vector<uint16_t> SegmentIndices() const;
+    /// Returns the index of the first polygon containing 'p' or 'Polygon::InvalidIndex'.
+    /// Only polygons listed in the grid cell of 'p' are tested.
     size_t FindContainingPolygon(const glm::dvec2& p) const;
     glm::dvec2 Vertex(size_t index) const;
     size_t CountVertices() const { return vertices.size(); }
@@ -69,4 +81,9 @@ private:
     double polygonArea(const std::vector<size_t> indices) const;
     void trimEmptyPolygons();
     void updateBoundingBoxes();
+    /// Rebuilds the grid from 'boundingBoxes', sized for about one polygon per cell.
+    void updatePolygonGrid();
+    /// Grid coordinate of 'value' along an axis starting at 'min' with 'count' cells.
+    size_t gridCoordinate(double value, double min, size_t count) const;
+    bool convexPolygonContains(size_t polygonIndex, glm::dvec2 p) const;
 };
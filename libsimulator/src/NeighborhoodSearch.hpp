@@ -1,8 +1,10 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #pragma once
+#include "AABB.hpp"
 #include "GenericAgent.hpp"
 #include "HashCombine.hpp"
 #include "Point.hpp"
+#include "SimulationError.hpp"
 
 #include <algorithm>
 #include <cmath>
@@ -10,6 +12,9 @@
 #include <cstdint>
 #include <functional>
 #include <iterator>
+#include <limits>
+#include <optional>
+#include <span>
 #include <unordered_map>
 #include <vector>
 
@@ -58,13 +63,71 @@ struct std::hash<Grid2DIndex> {
     }
 };
 
+/// Spatial index answering range queries over the values passed to 'Update'.
+/// The dense grid checks distances against the positions values had during the last 'Update' or
+/// 'RefreshPositions', the hash grid reads the current positions of the values.
+/// Until values are added or removed, queries can also report the indices of the values in the
+/// container passed to the last 'Update', see 'GetNeighborIndicesOf'.
 template <typename Value>
 class NeighborhoodSearch
 {
-    using Grid = std::unordered_map<Grid2DIndex, std::vector<const Value*>>;
+    /// Index reported for values added since the last 'Update'
+    static constexpr uint32_t NO_INDEX = std::numeric_limits<uint32_t>::max();
+
+    /// A value and its index in the container passed to the last 'Update'
+    struct Entry {
+        const Value* item;
+        uint32_t index;
+    };
+    using Grid = std::unordered_map<Grid2DIndex, std::vector<Entry>>;
+
+    /// Grid covering a bounded area, stored in compressed sparse row layout.
+    /// Cells are stored column major, hence all cells of a column overlapping a query are adjacent
+    /// in memory. Positions outside of the covered area are clamped to the border cells.
+    struct DenseGrid {
+        Point origin{};
+        int32_t columns{};
+        int32_t rows{};
+        /// Items of cell 'c' are stored in items[cellStart[c]] to items[cellStart[c + 1] - 1]
+        std::vector<uint32_t> cellStart{};
+        std::vector<const Value*> items{};
+        /// Positions of 'items', kept in a separate array so distance checks do not have to
+        /// touch the items themselves
+        std::vector<Point> positions{};
+        /// Index of 'items' in the container passed to 'Update', the inverse of 'slotOfItem'
+        std::vector<uint32_t> indices{};
+        /// Slot in 'items' of the i-th item passed to 'Update', cleared once an item is removed
+        std::vector<uint32_t> slotOfItem{};
+        /// Scratch space for the counting sort
+        std::vector<uint32_t> cellOfItem{};
+        std::vector<uint32_t> cellCursor{};
+        /// Items added since the last call to 'Update'
+        std::vector<const Value*> pending{};
+    };
+
+    /// Neighbor lists of all items built with 'cutOff + skin', valid until any item moved more
+    /// than 'skin / 2' since the lists were built.
+    struct VerletLists {
+        double cutOff{};
+        double skin{};
+        /// Set if items were added or removed since the lists were built
+        bool stale{true};
+        /// Items and their positions at the time the lists were built
+        std::vector<const Value*> items{};
+        std::vector<Point> positions{};
+        std::unordered_map<const Value*, uint32_t> indexOfItem{};
+        /// Indices into 'items' of the neighbors of items[i] are stored in
+        /// neighbors[listStart[i]] to neighbors[listStart[i + 1] - 1]
+        std::vector<uint32_t> listStart{};
+        std::vector<uint32_t> neighbors{};
+    };
 
     double _cellSize;
     Grid _grid{};
+    std::optional<DenseGrid> _denseGrid{};
+    std::optional<VerletLists> _verletLists{};
+    /// Set while no values were added or removed since the last 'Update'
+    bool _indexed{false};
 
 private:
     Grid2DIndex getIndex(const Point& pos) const
@@ -74,22 +137,266 @@ private:
         return Grid2DIndex{idx, idy};
     }
 
+    int32_t denseColumn(double x) const
+    {
+        const auto& grid = *_denseGrid;
+        const auto column = std::floor((x - grid.origin.x) / _cellSize);
+        return static_cast<int32_t>(std::clamp(column, 0.0, grid.columns - 1.0));
+    }
+
+    int32_t denseRow(double y) const
+    {
+        const auto& grid = *_denseGrid;
+        const auto row = std::floor((y - grid.origin.y) / _cellSize);
+        return static_cast<int32_t>(std::clamp(row, 0.0, grid.rows - 1.0));
+    }
+
+    size_t denseCell(const Point& pos) const
+    {
+        return static_cast<size_t>(denseColumn(pos.x)) * _denseGrid->rows + denseRow(pos.y);
+    }
+
+    void updateDense(const AgentContainer<Value>& items)
+    {
+        auto& grid = *_denseGrid;
+        grid.pending.clear();
+        std::fill(std::begin(grid.cellStart), std::end(grid.cellStart), 0);
+        grid.cellOfItem.resize(items.size());
+        grid.items.resize(items.size());
+        grid.positions.resize(items.size());
+        grid.indices.resize(items.size());
+        grid.slotOfItem.resize(items.size());
+
+        size_t index = 0;
+        for(const auto& item : items) {
+            const auto cell = denseCell(item.pos);
+            grid.cellOfItem[index++] = static_cast<uint32_t>(cell);
+            ++grid.cellStart[cell + 1];
+        }
+        for(size_t cell = 1; cell < grid.cellStart.size(); ++cell) {
+            grid.cellStart[cell] += grid.cellStart[cell - 1];
+        }
+        grid.cellCursor.assign(std::begin(grid.cellStart), std::end(grid.cellStart) - 1);
+        index = 0;
+        for(const auto& item : items) {
+            const auto slot = grid.cellCursor[grid.cellOfItem[index]]++;
+            grid.items[slot] = &item;
+            grid.positions[slot] = item.pos;
+            grid.indices[slot] = static_cast<uint32_t>(index);
+            grid.slotOfItem[index++] = slot;
+        }
+    }
+
+    /// Copies the current positions of 'items' into the dense grid without re-sorting it.
+    /// Returns false if items were added or removed since the grid was sorted.
+    bool refreshDensePositions(const AgentContainer<Value>& items)
+    {
+        auto& grid = *_denseGrid;
+        if(!grid.pending.empty() || grid.slotOfItem.size() != items.size()) {
+            return false;
+        }
+        size_t index = 0;
+        for(const auto& item : items) {
+            grid.positions[grid.slotOfItem[index++]] = item.pos;
+        }
+        return true;
+    }
+
+    bool verletListsAreValid(const AgentContainer<Value>& items) const
+    {
+        const auto& lists = *_verletLists;
+        if(lists.stale || lists.items.size() != items.size()) {
+            return false;
+        }
+        const auto maxDisplacementSquared = lists.skin * lists.skin / 4;
+        size_t index = 0;
+        for(const auto& item : items) {
+            if(lists.items[index] != &item ||
+               DistanceSquared(item.pos, lists.positions[index]) > maxDisplacementSquared) {
+                return false;
+            }
+            ++index;
+        }
+        return true;
+    }
+
+    void buildVerletLists(const AgentContainer<Value>& items)
+    {
+        auto& lists = *_verletLists;
+        lists.stale = false;
+        lists.items.clear();
+        lists.positions.clear();
+        lists.indexOfItem.clear();
+        lists.listStart.assign(1, 0);
+        lists.neighbors.clear();
+        for(const auto& item : items) {
+            lists.indexOfItem.emplace(&item, static_cast<uint32_t>(lists.items.size()));
+            lists.items.push_back(&item);
+            lists.positions.push_back(item.pos);
+            forEachInRange(
+                item.pos,
+                lists.cutOff + lists.skin,
+                [&lists](const Value* /*neighbor*/, uint32_t index) {
+                    lists.neighbors.push_back(index);
+                });
+            lists.listStart.push_back(static_cast<uint32_t>(lists.neighbors.size()));
+        }
+    }
+
+    /// Calls 'func' with a pointer to every item at most 'radius' away from 'pos' and its index in
+    /// the container passed to the last 'Update', NO_INDEX for items added since.
+    template <typename Func>
+    void forEachInRange(Point pos, double radius, Func&& func) const
+    {
+        const auto radiusSquared = radius * radius;
+        // With neighbor lists the grid is only rebuilt together with the lists, items may have
+        // moved up to half the skin away from the cell they are stored in.
+        const auto searchRadius = _verletLists ? radius + _verletLists->skin / 2 : radius;
+
+        if(_denseGrid) {
+            const auto& grid = *_denseGrid;
+            const int32_t xMin = denseColumn(pos.x - searchRadius);
+            const int32_t xMax = denseColumn(pos.x + searchRadius);
+            const int32_t yMin = denseRow(pos.y - searchRadius);
+            const int32_t yMax = denseRow(pos.y + searchRadius);
+            for(int32_t x = xMin; x <= xMax; ++x) {
+                const auto column = static_cast<size_t>(x) * grid.rows;
+                const auto first = grid.cellStart[column + yMin];
+                const auto last = grid.cellStart[column + yMax + 1];
+                for(auto slot = first; slot < last; ++slot) {
+                    if(DistanceSquared(grid.positions[slot], pos) <= radiusSquared) {
+                        func(grid.items[slot], grid.indices[slot]);
+                    }
+                }
+            }
+            for(const auto* item : grid.pending) {
+                if(DistanceSquared(item->pos, pos) <= radiusSquared) {
+                    func(item, NO_INDEX);
+                }
+            }
+            return;
+        }
+
+        const auto posIdx = getIndex(pos);
+        const auto offset = static_cast<int32_t>(std::ceil(searchRadius / _cellSize));
+        const int32_t xMin = posIdx.idx - offset;
+        const int32_t xMax = posIdx.idx + offset;
+        const int32_t yMin = posIdx.idy - offset;
+        const int32_t yMax = posIdx.idy + offset;
+
+        for(int32_t x = xMin; x <= xMax; ++x) {
+            for(int32_t y = yMin; y <= yMax; ++y) {
+                auto it = _grid.find({x, y});
+                if(it != _grid.cend()) {
+                    for(const auto& [item, index] : it->second) {
+                        if(DistanceSquared(item->pos, pos) <= radiusSquared) {
+                            func(item, index);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
 public:
+    /// Upper limit of cells for which a dense grid is used.
+    static constexpr size_t MAX_DENSE_CELLS = size_t{1} << 20;
+
+    /// Creates a neighborhood search based on a hash grid, usable for unbounded domains.
     explicit NeighborhoodSearch(double cellSize) : _cellSize(cellSize) {};
 
+    /// Creates a neighborhood search based on a dense grid covering 'bounds'.
+    /// Falls back to a hash grid if the dense grid would exceed MAX_DENSE_CELLS cells.
+    NeighborhoodSearch(double cellSize, const AABB& bounds) : _cellSize(cellSize)
+    {
+        const auto columns = std::floor((bounds.xmax - bounds.xmin) / cellSize) + 1;
+        const auto rows = std::floor((bounds.ymax - bounds.ymin) / cellSize) + 1;
+        if(!(columns >= 1 && rows >= 1) || columns * rows > MAX_DENSE_CELLS) {
+            return;
+        }
+        _denseGrid.emplace();
+        _denseGrid->origin = bounds.BottomLeft();
+        _denseGrid->columns = static_cast<int32_t>(columns);
+        _denseGrid->rows = static_cast<int32_t>(rows);
+        _denseGrid->cellStart.resize(
+            static_cast<size_t>(_denseGrid->columns) * _denseGrid->rows + 1);
+    }
+
+    /// Returns true if the dense grid is used.
+    bool IsDense() const { return _denseGrid.has_value(); }
+
+    /// Enables cached neighbor lists used by 'GetNeighboringAgentsOf' for radii up to 'cutOff'.
+    /// 'Update' only rebuilds the grid and the lists once any item moved more than 'skin / 2'
+    /// since the last rebuild or items were added or removed.
+    void EnableVerletLists(double cutOff, double skin)
+    {
+        if(cutOff < 0 || skin <= 0) {
+            throw SimulationError(
+                "Neighbor lists require a non negative cut off radius and a positive skin, got "
+                "cut off radius {} and skin {}",
+                cutOff,
+                skin);
+        }
+        _verletLists.emplace();
+        _verletLists->cutOff = cutOff;
+        _verletLists->skin = skin;
+    }
+
+    /// Returns true if cached neighbor lists are used.
+    bool UsesVerletLists() const { return _verletLists.has_value(); }
+
     void AddAgent(const Value& item)
     {
+        _indexed = false;
+        if(_verletLists) {
+            _verletLists->stale = true;
+        }
+        if(_denseGrid) {
+            _denseGrid->pending.push_back(&item);
+            return;
+        }
         auto index = getIndex(item.pos);
         auto& vec = _grid[index];
-        vec.push_back(&item);
+        vec.push_back({&item, NO_INDEX});
     }
 
     void RemoveAgent(const Value& item)
     {
+        _indexed = false;
+        if(_verletLists) {
+            _verletLists->stale = true;
+        }
+        const auto isItem = [&item](const auto* agent) { return agent->id == item.id; };
+        if(_denseGrid) {
+            auto& grid = *_denseGrid;
+            const auto pendingIter =
+                std::find_if(std::begin(grid.pending), std::end(grid.pending), isItem);
+            if(pendingIter != std::end(grid.pending)) {
+                grid.pending.erase(pendingIter);
+                return;
+            }
+            const auto iter = std::find_if(std::begin(grid.items), std::end(grid.items), isItem);
+            if(iter != std::end(grid.items)) {
+                const auto index =
+                    static_cast<uint32_t>(std::distance(std::begin(grid.items), iter));
+                grid.items.erase(iter);
+                grid.positions.erase(std::next(std::begin(grid.positions), index));
+                grid.indices.erase(std::next(std::begin(grid.indices), index));
+                // The remaining items are no longer at the indices they had in 'Update'
+                grid.slotOfItem.clear();
+                for(auto& start : grid.cellStart) {
+                    if(start > index) {
+                        --start;
+                    }
+                }
+                return;
+            }
+            throw SimulationError("Unknown agent id {}", item.id);
+        }
         for(auto& [_, agents] : _grid) {
-            const auto iter =
-                std::find_if(std::begin(agents), std::end(agents), [item](auto& agent) {
-                    return agent.id == item.id;
+            const auto iter = std::find_if(
+                std::begin(agents), std::end(agents), [&isItem](const Entry& entry) {
+                    return isItem(entry.item);
                 });
             if(iter != std::end(agents)) {
                 agents.erase(iter);
@@ -101,40 +408,128 @@ public:
 
     void Update(const AgentContainer<Value>& items)
     {
-        _grid.clear();
-        for(const auto& item : items) {
-            auto index = getIndex(item.pos);
-            auto& vec = _grid[index];
-            vec.push_back(&item);
+        if(_verletLists && verletListsAreValid(items) &&
+           (!_denseGrid || refreshDensePositions(items))) {
+            return;
+        }
+        if(_denseGrid) {
+            updateDense(items);
+        } else {
+            _grid.clear();
+            uint32_t index = 0;
+            for(const auto& item : items) {
+                auto& vec = _grid[getIndex(item.pos)];
+                vec.push_back({&item, index++});
+            }
+        }
+        _indexed = true;
+        if(_verletLists) {
+            buildVerletLists(items);
         }
     }
 
+    /// Makes range queries of the dense grid see the current positions of 'items', which have to
+    /// be the values passed to the last 'Update'. Like in the hash grid, values stay in the cells
+    /// of their position during 'Update'. Only copies positions if no values were added or removed
+    /// since, otherwise the grid is rebuilt. Does nothing for the hash grid.
+    void RefreshPositions(const AgentContainer<Value>& items)
+    {
+        if(_denseGrid && !refreshDensePositions(items)) {
+            updateDense(items);
+        }
+    }
+
+    /// Returns copies of all values at most 'radius' away from 'pos'.
+    /// Prefer 'ForEachNeighboringAgent' or the overload filling a buffer of pointers in hot code,
+    /// both do not copy values.
     std::vector<Value> GetNeighboringAgents(Point pos, double radius) const
     {
         std::vector<Value> result{};
         result.reserve(128);
+        forEachInRange(pos, radius, [&result](const Value* item, uint32_t /*index*/) {
+            result.emplace_back(*item);
+        });
+        return result;
+    }
 
-        const auto posIdx = getIndex(pos);
-        const auto offset = static_cast<int32_t>(std::ceil(radius / _cellSize));
-        const int32_t xMin = posIdx.idx - offset;
-        const int32_t xMax = posIdx.idx + offset;
-        const int32_t yMin = posIdx.idy - offset;
-        const int32_t yMax = posIdx.idy + offset;
-
-        const auto radiusSquared = radius * radius;
+    /// Replaces the content of 'result' with pointers to all values at most 'radius' away from
+    /// 'pos'. Reusing 'result' across calls avoids allocations once its capacity suffices.
+    /// The pointers are invalidated by the next modification of the search.
+    void GetNeighboringAgents(Point pos, double radius, std::vector<const Value*>& result) const
+    {
+        result.clear();
+        forEachInRange(pos, radius, [&result](const Value* item, uint32_t /*index*/) {
+            result.push_back(item);
+        });
+    }
 
-        for(int32_t x = xMin; x <= xMax; ++x) {
-            for(int32_t y = yMin; y <= yMax; ++y) {
-                auto it = _grid.find({x, y});
-                if(it != _grid.cend()) {
-                    for(const auto& item : it->second) {
-                        if(DistanceSquared(item->pos, pos) <= radiusSquared) {
-                            result.emplace_back(*item);
-                        }
+    /// Same as 'GetNeighboringAgents' for the position of 'item', which has to be part of the
+    /// container passed to the last 'Update'. Uses the cached neighbor lists if enabled and
+    /// 'radius' does not exceed their cut off radius.
+    void GetNeighboringAgentsOf(
+        const Value& item,
+        double radius,
+        std::vector<const Value*>& result) const
+    {
+        if(_verletLists && !_verletLists->stale && radius <= _verletLists->cutOff) {
+            const auto& lists = *_verletLists;
+            if(const auto iter = lists.indexOfItem.find(&item); iter != lists.indexOfItem.end()) {
+                const auto radiusSquared = radius * radius;
+                result.clear();
+                const auto last = lists.listStart[iter->second + 1];
+                for(auto index = lists.listStart[iter->second]; index < last; ++index) {
+                    const auto* neighbor = lists.items[lists.neighbors[index]];
+                    if(DistanceSquared(neighbor->pos, item.pos) <= radiusSquared) {
+                        result.push_back(neighbor);
                     }
                 }
+                return;
             }
         }
-        return result;
+        GetNeighboringAgents(item.pos, radius, result);
+    }
+
+    /// Calls 'func' with a const reference to every value at most 'radius' away from 'pos'.
+    template <typename Func>
+    void ForEachNeighboringAgent(Point pos, double radius, Func&& func) const
+    {
+        forEachInRange(
+            pos, radius, [&func](const Value* item, uint32_t /*index*/) { func(*item); });
+    }
+
+    /// Replaces the content of 'result' with the indices of all values at most 'radius' away from
+    /// the value at 'index', including 'index' itself. Indices refer to the container passed to
+    /// the last 'Update', 'positions' holds the current positions of that container in the same
+    /// order, e.g. the ones of an AgentStore gathered from it. Uses the cached neighbor lists if
+    /// enabled and 'radius' does not exceed their cut off radius.
+    /// Throws if values were added or removed since the last 'Update'.
+    void GetNeighborIndicesOf(
+        size_t index,
+        std::span<const Point> positions,
+        double radius,
+        std::vector<uint32_t>& result) const
+    {
+        if(!_indexed) {
+            throw SimulationError(
+                "Neighbor indices are unavailable after adding or removing values until the "
+                "next update");
+        }
+        result.clear();
+        const auto pos = positions[index];
+        if(_verletLists && radius <= _verletLists->cutOff) {
+            const auto& lists = *_verletLists;
+            const auto radiusSquared = radius * radius;
+            const auto last = lists.listStart[index + 1];
+            for(auto entry = lists.listStart[index]; entry < last; ++entry) {
+                const auto neighbor = lists.neighbors[entry];
+                if(DistanceSquared(positions[neighbor], pos) <= radiusSquared) {
+                    result.push_back(neighbor);
+                }
+            }
+            return;
+        }
+        forEachInRange(pos, radius, [&result](const Value* /*item*/, uint32_t neighbor) {
+            result.push_back(neighbor);
+        });
     }
 };
@@ -0,0 +1,13 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "CfgCgal.hpp"
+#include "UniqueID.hpp"
+
+/// Polygon excluded from the accessible area while the simulation is running, see
+/// 'Simulation::AddObstacle'.
+struct Obstacle {
+    using ID = jps::UniqueID<Obstacle>;
+    ID id{};
+    Poly polygon{};
+};
@@ -1,16 +1,19 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #pragma once
 
+#include "AgentStore.hpp"
 #include "CollisionGeometry.hpp"
 #include "GenericAgent.hpp"
 #include "NeighborhoodSearch.hpp"
 #include "OperationalModel.hpp"
 #include "OperationalModelType.hpp"
+#include "ThreadPool.hpp"
 
 #include <boost/iterator/zip_iterator.hpp>
 #include <boost/tuple/tuple.hpp>
 
 #include <algorithm>
+#include <cstddef>
 #include <iterator>
 #include <memory>
 #include <optional>
@@ -20,6 +23,8 @@
 class OperationalDecisionSystem
 {
     std::unique_ptr<OperationalModel> _model{};
+    /// Columns of the agents passed to 'Run', kept to reuse the allocations
+    AgentStore _agentStore{};
 
 public:
     OperationalDecisionSystem(std::unique_ptr<OperationalModel>&& model) : _model(std::move(model))
@@ -33,23 +38,31 @@ public:
 
     OperationalModelType ModelType() const { return _model->Type(); }
 
+    double NeighborhoodRadius() const { return _model->NeighborhoodRadius(); }
+
     void
     Run(double dT,
         double /*t_in_sec*/,
         const NeighborhoodSearch<GenericAgent>& neighborhoodSearch,
         const CollisionGeometry& geometry,
-        AgentContainer<GenericAgent>& agents) const
+        AgentContainer<GenericAgent>& agents,
+        ThreadPool& threadPool)
     {
-        std::vector<std::optional<OperationalModelUpdate>> updates{};
-        updates.reserve(agents.size());
+        std::vector<std::optional<OperationalModelUpdate>> updates(agents.size());
+        _agentStore.Gather(agents);
 
-        std::transform(
-            std::begin(agents),
-            std::end(agents),
-            std::back_inserter(updates),
-            [this, &dT, &geometry, &neighborhoodSearch](const auto& agent) {
-                return _model->ComputeNewPosition(dT, agent, geometry, neighborhoodSearch);
-            });
+        const auto computeUpdates = [&](size_t first, size_t last) {
+            _model->ComputeNewPositions(
+                dT, agents, _agentStore, first, last, geometry, neighborhoodSearch, updates);
+        };
+
+        // Updates are computed from the state of the previous iteration only and each one is
+        // written to its own slot, hence the result does not depend on the number of threads.
+        if(_model->SupportsConcurrentComputation()) {
+            threadPool.ParallelForRanges(agents.size(), computeUpdates);
+        } else {
+            computeUpdates(0, agents.size());
+        }
 
         std::for_each(
             boost::make_zip_iterator(boost::make_tuple(std::begin(agents), std::begin(updates))),
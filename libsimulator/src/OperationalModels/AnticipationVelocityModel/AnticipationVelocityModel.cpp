@@ -19,6 +19,7 @@
 #include <cstdlib>
 #include <limits>
 #include <numeric>
+#include <span>
 #include <vector>
 
 AnticipationVelocityModel::AnticipationVelocityModel(double pushoutStrength, uint64_t rng_seed)
@@ -37,8 +38,10 @@ OperationalModelUpdate AnticipationVelocityModel::ComputeNewPosition(
     const CollisionGeometry& geometry,
     const NeighborhoodSearchType& neighborhoodSearch) const
 {
-    auto neighborhood = neighborhoodSearch.GetNeighboringAgents(ped.pos, _cutOffRadius);
-    const auto& boundary = geometry.LineSegmentsInApproxDistanceTo(ped.pos);
+    // Reused across calls to avoid allocations
+    thread_local std::vector<const GenericAgent*> neighborhood{};
+    neighborhoodSearch.GetNeighboringAgentsOf(ped, _cutOffRadius, neighborhood);
+    const auto boundary = geometry.LineSegmentsInApproxDistanceTo(ped.pos);
 
     // Remove any agent from the neighborhood that is obstructed by geometry and the current
     // agent
@@ -46,21 +49,11 @@ OperationalModelUpdate AnticipationVelocityModel::ComputeNewPosition(
         std::remove_if(
             std::begin(neighborhood),
             std::end(neighborhood),
-            [&ped, &boundary](const auto& neighbor) {
-                if(ped.id == neighbor.id) {
+            [&ped, &boundary](const auto* neighbor) {
+                if(ped.id == neighbor->id) {
                     return true;
                 }
-                const auto agent_to_neighbor = LineSegment(ped.pos, neighbor.pos);
-                if(std::find_if(
-                       boundary.cbegin(),
-                       boundary.cend(),
-                       [&agent_to_neighbor](const auto& boundary_segment) {
-                           return intersects(agent_to_neighbor, boundary_segment);
-                       }) != boundary.end()) {
-                    return true;
-                }
-
-                return false;
+                return intersectsAny(LineSegment(ped.pos, neighbor->pos), boundary);
             }),
         std::end(neighborhood));
 
@@ -68,8 +61,8 @@ OperationalModelUpdate AnticipationVelocityModel::ComputeNewPosition(
         std::begin(neighborhood),
         std::end(neighborhood),
         Point{},
-        [&ped, this](const auto& res, const auto& neighbor) {
-            return res + NeighborRepulsion(ped, neighbor);
+        [&ped, this](const auto& res, const auto* neighbor) {
+            return res + NeighborRepulsion(ped, *neighbor);
         });
 
     const auto desiredDirection = (ped.destination - ped.pos).Normalized();
@@ -88,8 +81,8 @@ OperationalModelUpdate AnticipationVelocityModel::ComputeNewPosition(
         std::begin(neighborhood),
         std::end(neighborhood),
         std::numeric_limits<double>::max(),
-        [&ped, &direction, this](const auto& res, const auto& neighbor) {
-            return std::min(res, GetSpacing(ped, neighbor, direction));
+        [&ped, &direction, this](const auto& res, const auto* neighbor) {
+            return std::min(res, GetSpacing(ped, *neighbor, direction));
         });
 
     const auto optimal_speed = OptimalSpeed(ped, spacing, model.timeGap);
@@ -181,10 +174,9 @@ void AnticipationVelocityModel::CheckModelConstraint(
     constexpr double reactionTimeMax = 1.0;
     validateConstraint(reactionTime, reactionTimeMin, reactionTimeMax, "reactionTime", true);
 
-    const auto neighbors = neighborhoodSearch.GetNeighboringAgents(agent.pos, 2);
-    for(const auto& neighbor : neighbors) {
+    neighborhoodSearch.ForEachNeighboringAgent(agent.pos, 2, [&agent, r](const auto& neighbor) {
         if(agent.id == neighbor.id) {
-            continue;
+            return;
         }
         const auto& neighbor_model = std::get<AnticipationVelocityModelData>(neighbor.model);
         const auto contanctdDist = r + neighbor_model.radius;
@@ -196,7 +188,7 @@ void AnticipationVelocityModel::CheckModelConstraint(
                 neighbor.pos,
                 distance);
         }
-    }
+    });
 
     const auto lineSegments = geometry.LineSegmentsInDistanceTo(r, agent.pos);
     if(std::begin(lineSegments) != std::end(lineSegments)) {
@@ -311,7 +303,7 @@ Point AnticipationVelocityModel::HandleWallAvoidance(
     const Point& direction,
     const Point& agentPosition,
     double agentRadius,
-    const std::vector<LineSegment>& boundary,
+    std::span<const LineSegment> boundary,
     double wallBufferDistance) const
 {
     const double criticalWallDistance = wallBufferDistance + agentRadius;
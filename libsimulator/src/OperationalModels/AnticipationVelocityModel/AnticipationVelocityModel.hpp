@@ -10,6 +10,7 @@
 
 #include <cstdint>
 #include <random>
+#include <span>
 #include <vector>
 
 struct GenericAgent;
@@ -29,6 +30,7 @@ public:
     AnticipationVelocityModel(double pushoutStrength, uint64_t rng_seed);
     ~AnticipationVelocityModel() override = default;
     OperationalModelType Type() const override;
+    double NeighborhoodRadius() const override { return _cutOffRadius; }
     OperationalModelUpdate ComputeNewPosition(
         double dT,
         const GenericAgent& ped,
@@ -53,7 +55,7 @@ private:
         const Point& direction,
         const Point& agentPosition,
         double agentRadius,
-        const std::vector<LineSegment>& boundary,
+        std::span<const LineSegment> boundary,
         double wallBufferDistance) const;
 
     Point
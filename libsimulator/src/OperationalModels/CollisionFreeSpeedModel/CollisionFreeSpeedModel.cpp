@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #include "CollisionFreeSpeedModel.hpp"
 
+#include "AgentStore.hpp"
 #include "CollisionFreeSpeedModelData.hpp"
 #include "CollisionFreeSpeedModelUpdate.hpp"
 #include "CollisionGeometry.hpp"
@@ -11,24 +12,34 @@
 #include "OperationalModelType.hpp"
 #include "Point.hpp"
 #include "SimulationError.hpp"
+#include "WallDistanceField.hpp"
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <limits>
 #include <numeric>
+#include <span>
 #include <vector>
 
 CollisionFreeSpeedModel::CollisionFreeSpeedModel(
     double strengthNeighborRepulsion_,
     double rangeNeighborRepulsion_,
     double strengthGeometryRepulsion_,
-    double rangeGeometryRepulsion_)
+    double rangeGeometryRepulsion_,
+    double wallDistanceResolution_)
     : strengthNeighborRepulsion(strengthNeighborRepulsion_)
     , rangeNeighborRepulsion(rangeNeighborRepulsion_)
     , strengthGeometryRepulsion(strengthGeometryRepulsion_)
     , rangeGeometryRepulsion(rangeGeometryRepulsion_)
+    , wallDistanceResolution(wallDistanceResolution_)
 {
+    if(wallDistanceResolution < 0) {
+        throw SimulationError(
+            "Wall distance resolution must be >= 0, got {}",
+            wallDistanceResolution);
+    }
 }
 
 OperationalModelType CollisionFreeSpeedModel::Type() const
@@ -42,62 +53,128 @@ OperationalModelUpdate CollisionFreeSpeedModel::ComputeNewPosition(
     const CollisionGeometry& geometry,
     const NeighborhoodSearchType& neighborhoodSearch) const
 {
-    auto neighborhood = neighborhoodSearch.GetNeighboringAgents(ped.pos, _cutOffRadius);
-    const auto& boundary = geometry.LineSegmentsInApproxDistanceTo(ped.pos);
-
-    // Remove any agent from the neighborhood that is obstructed by geometry and the current
-    // agent
-    neighborhood.erase(
-        std::remove_if(
-            std::begin(neighborhood),
-            std::end(neighborhood),
-            [&ped, &boundary](const auto& neighbor) {
-                if(ped.id == neighbor.id) {
-                    return true;
-                }
-                const auto agent_to_neighbor = LineSegment(ped.pos, neighbor.pos);
-                if(std::find_if(
-                       boundary.cbegin(),
-                       boundary.cend(),
-                       [&agent_to_neighbor](const auto& boundary_segment) {
-                           return intersects(agent_to_neighbor, boundary_segment);
-                       }) != boundary.end()) {
-                    return true;
-                }
-
-                return false;
-            }),
-        std::end(neighborhood));
-
-    const auto neighborRepulsion = std::accumulate(
-        std::begin(neighborhood),
-        std::end(neighborhood),
-        Point{},
-        [&ped, this](const auto& res, const auto& neighbor) {
-            return res + NeighborRepulsion(ped, neighbor);
-        });
-
-    const auto boundaryRepulsion = std::accumulate(
-        boundary.cbegin(),
-        boundary.cend(),
-        Point(0, 0),
-        [this, &ped](const auto& acc, const auto& element) {
-            return acc + BoundaryRepulsion(ped, element);
-        });
+    auto& buffers = ThreadBuffers();
+    auto& neighborhood = buffers.neighborhood;
+    auto& offsets = buffers.offsets;
+    auto& contactDistances = buffers.contactDistances;
+    neighborhoodSearch.GetNeighboringAgentsOf(ped, _cutOffRadius, neighborhood);
+    const auto boundary = geometry.LineSegmentsInApproxDistanceTo(ped.pos);
+    const auto& model = std::get<CollisionFreeSpeedModelData>(ped.model);
+
+    // Copy all neighbors that are neither the current agent nor obstructed by geometry into
+    // contiguous arrays, the force and spacing loops then only read plain numbers.
+    offsets.clear();
+    contactDistances.clear();
+    for(const auto* neighbor : neighborhood) {
+        if(ped.id == neighbor->id) {
+            continue;
+        }
+        if(intersectsAny(LineSegment(ped.pos, neighbor->pos), boundary)) {
+            continue;
+        }
+        const auto& neighbor_model = std::get<CollisionFreeSpeedModelData>(neighbor->model);
+        offsets.push_back(neighbor->pos - ped.pos);
+        contactDistances.push_back(model.radius + neighbor_model.radius);
+    }
+    return ComputeUpdate(dT, ped, boundary, WallDistances(geometry), buffers);
+}
+
+void CollisionFreeSpeedModel::ComputeNewPositions(
+    double dT,
+    const std::deque<GenericAgent>& agents,
+    const AgentStore& agentStore,
+    size_t first,
+    size_t last,
+    const CollisionGeometry& geometry,
+    const NeighborhoodSearchType& neighborhoodSearch,
+    std::span<std::optional<OperationalModelUpdate>> updates) const
+{
+    // The wall distance field and the thread local buffers are looked up once for the whole block
+    const auto* wallDistances = WallDistances(geometry);
+    auto& buffers = ThreadBuffers();
+    auto& neighborIndices = buffers.neighborIndices;
+    auto& offsets = buffers.offsets;
+    auto& contactDistances = buffers.contactDistances;
+    // Same as 'ComputeNewPosition', but neighbors are read from the contiguous columns of the
+    // store instead of the agents
+    const auto positions = agentStore.Positions();
+    const auto radii = agentStore.Radii();
+    for(size_t index = first; index < last; ++index) {
+        const auto pos = positions[index];
+        const auto boundary = geometry.LineSegmentsInApproxDistanceTo(pos);
+        neighborhoodSearch.GetNeighborIndicesOf(index, positions, _cutOffRadius, neighborIndices);
+        offsets.clear();
+        contactDistances.clear();
+        for(const auto neighbor : neighborIndices) {
+            if(neighbor == index) {
+                continue;
+            }
+            if(intersectsAny(LineSegment(pos, positions[neighbor]), boundary)) {
+                continue;
+            }
+            offsets.push_back(positions[neighbor] - pos);
+            contactDistances.push_back(radii[index] + radii[neighbor]);
+        }
+        updates[index] = ComputeUpdate(dT, agents[index], boundary, wallDistances, buffers);
+    }
+}
+
+CollisionFreeSpeedModel::Buffers& CollisionFreeSpeedModel::ThreadBuffers()
+{
+    thread_local Buffers buffers{};
+    return buffers;
+}
+
+const WallDistanceField*
+CollisionFreeSpeedModel::WallDistances(const CollisionGeometry& geometry) const
+{
+    if(wallDistanceResolution > 0) {
+        return &geometry.WallDistances(wallDistanceResolution);
+    }
+    return nullptr;
+}
+
+OperationalModelUpdate CollisionFreeSpeedModel::ComputeUpdate(
+    double dT,
+    const GenericAgent& ped,
+    std::span<const LineSegment> boundary,
+    const WallDistanceField* wallDistances,
+    const Buffers& buffers) const
+{
+    const auto& offsets = buffers.offsets;
+    const auto& contactDistances = buffers.contactDistances;
+    const auto& model = std::get<CollisionFreeSpeedModelData>(ped.model);
+
+    auto neighborRepulsion = Point{};
+    for(size_t index = 0; index < offsets.size(); ++index) {
+        neighborRepulsion =
+            neighborRepulsion + NeighborRepulsion(offsets[index], contactDistances[index]);
+    }
+
+    // The field only knows the closest wall, see WallDistanceField for the accuracy
+    auto boundaryRepulsion = Point{};
+    if(wallDistances != nullptr) {
+        const auto sample = wallDistances->At(ped.pos);
+        boundaryRepulsion = BoundaryRepulsion(ped, sample.distance, sample.direction);
+    } else {
+        boundaryRepulsion = std::accumulate(
+            std::begin(boundary),
+            std::end(boundary),
+            Point(0, 0),
+            [this, &ped](const auto& acc, const auto& element) {
+                return acc + BoundaryRepulsion(ped, element);
+            });
+    }
 
     const auto desired_direction = (ped.destination - ped.pos).Normalized();
     auto direction = (desired_direction + neighborRepulsion + boundaryRepulsion).Normalized();
-    const auto& model = std::get<CollisionFreeSpeedModelData>(ped.model);
     if(direction == Point{}) {
         direction = model.orientation;
     }
-    const auto spacing = std::accumulate(
-        std::begin(neighborhood),
-        std::end(neighborhood),
-        std::numeric_limits<double>::max(),
-        [&ped, &direction, this](const auto& res, const auto& neighbor) {
-            return std::min(res, GetSpacing(ped, neighbor, direction));
-        });
+    auto spacing = std::numeric_limits<double>::max();
+    for(size_t index = 0; index < offsets.size(); ++index) {
+        spacing = std::min(spacing, GetSpacing(offsets[index], contactDistances[index], direction));
+    }
 
     const auto optimal_speed = OptimalSpeed(ped, spacing, model.timeGap);
     const auto velocity = direction * optimal_speed;
@@ -135,10 +212,9 @@ void CollisionFreeSpeedModel::CheckModelConstraint(
     constexpr double timeGapMax = 10.;
     validateConstraint(timeGap, timeGapMin, timeGapMax, "timeGap");
 
-    const auto neighbors = neighborhoodSearch.GetNeighboringAgents(agent.pos, 2);
-    for(const auto& neighbor : neighbors) {
+    neighborhoodSearch.ForEachNeighboringAgent(agent.pos, 2, [&agent, r](const auto& neighbor) {
         if(agent.id == neighbor.id) {
-            continue;
+            return;
         }
         const auto& neighbor_model = std::get<CollisionFreeSpeedModelData>(neighbor.model);
         const auto contanctdDist = r + neighbor_model.radius;
@@ -150,7 +226,7 @@ void CollisionFreeSpeedModel::CheckModelConstraint(
                 neighbor.pos,
                 distance);
         }
-    }
+    });
 
     const auto lineSegments = geometry.LineSegmentsInDistanceTo(r, agent.pos);
     if(std::begin(lineSegments) != std::end(lineSegments)) {
@@ -172,34 +248,26 @@ double CollisionFreeSpeedModel::OptimalSpeed(
 }
 
 double CollisionFreeSpeedModel::GetSpacing(
-    const GenericAgent& ped1,
-    const GenericAgent& ped2,
+    const Point& distp12,
+    double l,
     const Point& direction) const
 {
-    const auto& model1 = std::get<CollisionFreeSpeedModelData>(ped1.model);
-    const auto& model2 = std::get<CollisionFreeSpeedModelData>(ped2.model);
-    const auto distp12 = ped2.pos - ped1.pos;
     const auto inFront = direction.ScalarProduct(distp12) >= 0;
     if(!inFront) {
         return std::numeric_limits<double>::max();
     }
 
     const auto left = direction.Rotate90Deg();
-    const auto l = model1.radius + model2.radius;
     bool inCorridor = std::abs(left.ScalarProduct(distp12)) <= l;
     if(!inCorridor) {
         return std::numeric_limits<double>::max();
     }
     return distp12.Norm() - l;
 }
-Point CollisionFreeSpeedModel::NeighborRepulsion(const GenericAgent& ped1, const GenericAgent& ped2)
-    const
+
+Point CollisionFreeSpeedModel::NeighborRepulsion(const Point& distp12, double l) const
 {
-    const auto distp12 = ped2.pos - ped1.pos;
     const auto [distance, direction] = distp12.NormAndNormalized();
-    const auto& model1 = std::get<CollisionFreeSpeedModelData>(ped1.model);
-    const auto& model2 = std::get<CollisionFreeSpeedModelData>(ped2.model);
-    const auto l = model1.radius + model2.radius;
     return direction * -(strengthNeighborRepulsion * exp((l - distance) / rangeNeighborRepulsion));
 }
 
@@ -207,11 +275,21 @@ Point CollisionFreeSpeedModel::BoundaryRepulsion(
     const GenericAgent& ped,
     const LineSegment& boundary_segment) const
 {
-    const auto pt = boundary_segment.ShortestPoint(ped.pos);
-    const auto dist_vec = pt - ped.pos;
-    const auto [dist, e_iw] = dist_vec.NormAndNormalized();
+    const auto toWall = boundary_segment.ShortestPoint(ped.pos) - ped.pos;
+    const auto [dist, e_iw] = toWall.NormAndNormalized();
+    return BoundaryRepulsion(ped, dist, e_iw);
+}
+
+Point CollisionFreeSpeedModel::BoundaryRepulsion(
+    const GenericAgent& ped,
+    double distance,
+    const Point& direction) const
+{
+    if(direction == Point{}) {
+        return {};
+    }
     const auto& model = std::get<CollisionFreeSpeedModelData>(ped.model);
     const auto l = model.radius;
-    const auto R_iw = -strengthGeometryRepulsion * exp((l - dist) / rangeGeometryRepulsion);
-    return e_iw * R_iw;
-}
+    const auto R_iw = -strengthGeometryRepulsion * exp((l - distance) / rangeGeometryRepulsion);
+    return direction * R_iw;
+}
\ No newline at end of file
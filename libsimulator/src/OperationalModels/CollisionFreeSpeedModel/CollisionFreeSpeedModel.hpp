@@ -8,7 +8,16 @@
 #include "OperationalModelType.hpp"
 #include "Point.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <span>
+#include <vector>
+
 struct GenericAgent;
+class AgentStore;
+class WallDistanceField;
 
 class CollisionFreeSpeedModel : public OperationalModel
 {
@@ -21,20 +30,35 @@ private:
     double rangeNeighborRepulsion;
     double strengthGeometryRepulsion;
     double rangeGeometryRepulsion;
+    /// Resolution of the wall distance field used for the geometry repulsion, 0 to compute the
+    /// repulsion from all nearby walls exactly.
+    double wallDistanceResolution;
 
 public:
     CollisionFreeSpeedModel(
         double strengthNeighborRepulsion,
         double rangeNeighborRepulsion,
         double strengthGeometryRepulsion,
-        double rangeGeometryRepulsion);
+        double rangeGeometryRepulsion,
+        double wallDistanceResolution = 0);
     ~CollisionFreeSpeedModel() override = default;
     OperationalModelType Type() const override;
+    bool SupportsConcurrentComputation() const override { return true; }
+    double NeighborhoodRadius() const override { return _cutOffRadius; }
     OperationalModelUpdate ComputeNewPosition(
         double dT,
         const GenericAgent& ped,
         const CollisionGeometry& geometry,
         const NeighborhoodSearchType& neighborhoodSearch) const override;
+    void ComputeNewPositions(
+        double dT,
+        const std::deque<GenericAgent>& agents,
+        const AgentStore& agentStore,
+        size_t first,
+        size_t last,
+        const CollisionGeometry& geometry,
+        const NeighborhoodSearchType& neighborhoodSearch,
+        std::span<std::optional<OperationalModelUpdate>> updates) const override;
     void ApplyUpdate(const OperationalModelUpdate& update, GenericAgent& agent) const override;
     void CheckModelConstraint(
         const GenericAgent& agent,
@@ -42,9 +66,33 @@ public:
         const CollisionGeometry& geometry) const override;
 
 private:
+    /// Buffers reused across agents to avoid allocations, one set per thread computing updates
+    struct Buffers {
+        std::vector<const GenericAgent*> neighborhood{};
+        std::vector<uint32_t> neighborIndices{};
+        /// Offsets to and contact distances with the neighbors not hidden by walls
+        std::vector<Point> offsets{};
+        std::vector<double> contactDistances{};
+    };
+    static Buffers& ThreadBuffers();
+    /// Wall distance field of 'geometry' or nullptr if the repulsion is computed from all walls.
+    const WallDistanceField* WallDistances(const CollisionGeometry& geometry) const;
+    /// Shared by the single and the batch interface once they filled the offsets and contact
+    /// distances in 'buffers', not virtual so the batch loop can inline it. The batch interface
+    /// looks up 'wallDistances' and 'buffers' once per block of agents.
+    OperationalModelUpdate ComputeUpdate(
+        double dT,
+        const GenericAgent& ped,
+        std::span<const LineSegment> boundary,
+        const WallDistanceField* wallDistances,
+        const Buffers& buffers) const;
     double OptimalSpeed(const GenericAgent& ped, double spacing, double time_gap) const;
-    double
-    GetSpacing(const GenericAgent& ped1, const GenericAgent& ped2, const Point& direction) const;
-    Point NeighborRepulsion(const GenericAgent& ped1, const GenericAgent& ped2) const;
+    /// 'distp12' is the vector from the agent to its neighbor, 'l' the sum of both radii.
+    double GetSpacing(const Point& distp12, double l, const Point& direction) const;
+    Point NeighborRepulsion(const Point& distp12, double l) const;
     Point BoundaryRepulsion(const GenericAgent& ped, const LineSegment& boundary_segment) const;
+    /// Repulsion of a wall at 'distance' from 'ped' in the unit 'direction', none if 'direction'
+    /// is zero.
+    Point BoundaryRepulsion(const GenericAgent& ped, double distance, const Point& direction)
+        const;
 };
@@ -7,12 +7,18 @@ CollisionFreeSpeedModelBuilder::CollisionFreeSpeedModelBuilder(
     double aPed,
     double DPed,
     double aWall,
-    double DWall)
-    : _aPed(aPed), _DPed(DPed), _aWall(aWall), _DWall(DWall)
+    double DWall,
+    double wallDistanceResolution)
+    : _aPed(aPed)
+    , _DPed(DPed)
+    , _aWall(aWall)
+    , _DWall(DWall)
+    , _wallDistanceResolution(wallDistanceResolution)
 {
 }
 
 std::unique_ptr<OperationalModel> CollisionFreeSpeedModelBuilder::Build()
 {
-    return std::make_unique<CollisionFreeSpeedModel>(_aPed, _DPed, _aWall, _DWall);
+    return std::make_unique<CollisionFreeSpeedModel>(
+        _aPed, _DPed, _aWall, _DWall, _wallDistanceResolution);
 }
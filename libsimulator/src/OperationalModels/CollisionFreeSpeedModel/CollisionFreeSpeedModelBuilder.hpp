@@ -11,8 +11,14 @@ class CollisionFreeSpeedModelBuilder
     double _DPed;
     double _aWall;
     double _DWall;
+    double _wallDistanceResolution;
 
 public:
-    CollisionFreeSpeedModelBuilder(double aPed, double DPed, double aWall, double DWall);
+    CollisionFreeSpeedModelBuilder(
+        double aPed,
+        double DPed,
+        double aWall,
+        double DWall,
+        double wallDistanceResolution = 0);
     std::unique_ptr<OperationalModel> Build();
 };
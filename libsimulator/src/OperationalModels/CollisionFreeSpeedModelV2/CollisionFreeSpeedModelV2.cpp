@@ -30,8 +30,10 @@ OperationalModelUpdate CollisionFreeSpeedModelV2::ComputeNewPosition(
     const CollisionGeometry& geometry,
     const NeighborhoodSearchType& neighborhoodSearch) const
 {
-    auto neighborhood = neighborhoodSearch.GetNeighboringAgents(ped.pos, _cutOffRadius);
-    const auto& boundary = geometry.LineSegmentsInApproxDistanceTo(ped.pos);
+    // Reused across calls to avoid allocations, one buffer per thread computing updates
+    thread_local std::vector<const GenericAgent*> neighborhood{};
+    neighborhoodSearch.GetNeighboringAgentsOf(ped, _cutOffRadius, neighborhood);
+    const auto boundary = geometry.LineSegmentsInApproxDistanceTo(ped.pos);
 
     // Remove any agent from the neighborhood that is obstructed by geometry and the current
     // agent
@@ -39,21 +41,11 @@ OperationalModelUpdate CollisionFreeSpeedModelV2::ComputeNewPosition(
         std::remove_if(
             std::begin(neighborhood),
             std::end(neighborhood),
-            [&ped, &boundary](const auto& neighbor) {
-                if(ped.id == neighbor.id) {
+            [&ped, &boundary](const auto* neighbor) {
+                if(ped.id == neighbor->id) {
                     return true;
                 }
-                const auto agent_to_neighbor = LineSegment(ped.pos, neighbor.pos);
-                if(std::find_if(
-                       boundary.cbegin(),
-                       boundary.cend(),
-                       [&agent_to_neighbor](const auto& boundary_segment) {
-                           return intersects(agent_to_neighbor, boundary_segment);
-                       }) != boundary.end()) {
-                    return true;
-                }
-
-                return false;
+                return intersectsAny(LineSegment(ped.pos, neighbor->pos), boundary);
             }),
         std::end(neighborhood));
 
@@ -61,13 +53,13 @@ OperationalModelUpdate CollisionFreeSpeedModelV2::ComputeNewPosition(
         std::begin(neighborhood),
         std::end(neighborhood),
         Point{},
-        [&ped, this](const auto& res, const auto& neighbor) {
-            return res + NeighborRepulsion(ped, neighbor);
+        [&ped, this](const auto& res, const auto* neighbor) {
+            return res + NeighborRepulsion(ped, *neighbor);
         });
 
     const auto boundaryRepulsion = std::accumulate(
-        boundary.cbegin(),
-        boundary.cend(),
+        std::begin(boundary),
+        std::end(boundary),
         Point(0, 0),
         [this, &ped](const auto& acc, const auto& element) {
             return acc + BoundaryRepulsion(ped, element);
@@ -83,8 +75,8 @@ OperationalModelUpdate CollisionFreeSpeedModelV2::ComputeNewPosition(
         std::begin(neighborhood),
         std::end(neighborhood),
         std::numeric_limits<double>::max(),
-        [&ped, &direction, this](const auto& res, const auto& neighbor) {
-            return std::min(res, GetSpacing(ped, neighbor, direction));
+        [&ped, &direction, this](const auto& res, const auto* neighbor) {
+            return std::min(res, GetSpacing(ped, *neighbor, direction));
         });
 
     const auto optimal_speed = OptimalSpeed(ped, spacing, model.timeGap);
@@ -123,10 +115,9 @@ void CollisionFreeSpeedModelV2::CheckModelConstraint(
     constexpr double timeGapMax = 10.;
     validateConstraint(timeGap, timeGapMin, timeGapMax, "timeGap");
 
-    const auto neighbors = neighborhoodSearch.GetNeighboringAgents(agent.pos, 2);
-    for(const auto& neighbor : neighbors) {
+    neighborhoodSearch.ForEachNeighboringAgent(agent.pos, 2, [&agent, r](const auto& neighbor) {
         if(agent.id == neighbor.id) {
-            continue;
+            return;
         }
         const auto& neighbor_model = std::get<CollisionFreeSpeedModelV2Data>(neighbor.model);
         const auto contanctdDist = r + neighbor_model.radius;
@@ -138,7 +129,7 @@ void CollisionFreeSpeedModelV2::CheckModelConstraint(
                 neighbor.pos,
                 distance);
         }
-    }
+    });
 
     const auto lineSegments = geometry.LineSegmentsInDistanceTo(r, agent.pos);
     if(std::begin(lineSegments) != std::end(lineSegments)) {
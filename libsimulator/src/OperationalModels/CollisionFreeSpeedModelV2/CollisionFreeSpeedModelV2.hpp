@@ -22,6 +22,8 @@ public:
     CollisionFreeSpeedModelV2() = default;
     ~CollisionFreeSpeedModelV2() override = default;
     OperationalModelType Type() const override;
+    bool SupportsConcurrentComputation() const override { return true; }
+    double NeighborhoodRadius() const override { return _cutOffRadius; }
     OperationalModelUpdate ComputeNewPosition(
         double dT,
         const GenericAgent& ped,
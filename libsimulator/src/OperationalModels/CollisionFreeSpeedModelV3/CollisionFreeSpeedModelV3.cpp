@@ -29,7 +29,7 @@ constexpr double MinReverseSpeed =
     -0.01; // Deterministic tiny reverse floor [m/s] to release local blockages.
 
 double NeighborInfluence(
-    const std::vector<GenericAgent>& neighborhood,
+    const std::vector<const GenericAgent*>& neighborhood,
     const Point& pos,
     const Point& reference_direction,
     const CollisionFreeSpeedModelV3Data& model)
@@ -41,8 +41,8 @@ double NeighborInfluence(
 
     double best_influence = 0.0;
     double best_weight = 0.0;
-    for(const auto& neighbor : neighborhood) {
-        const auto relative = neighbor.pos - pos;
+    for(const auto* neighbor : neighborhood) {
+        const auto relative = neighbor->pos - pos;
         const auto x = reference_direction.ScalarProduct(relative);
         if(x <= 0.0) {
             continue;
@@ -74,23 +74,21 @@ OperationalModelUpdate CollisionFreeSpeedModelV3::ComputeNewPosition(
     const CollisionGeometry& geometry,
     const NeighborhoodSearchType& neighborhoodSearch) const
 {
-    auto neighborhood = neighborhoodSearch.GetNeighboringAgents(ped.pos, _cutOffRadius);
-    const auto& boundary = geometry.LineSegmentsInApproxDistanceTo(ped.pos);
+    // Reused across calls to avoid allocations, one buffer per thread computing updates
+    thread_local std::vector<const GenericAgent*> neighborhood{};
+    neighborhoodSearch.GetNeighboringAgentsOf(ped, _cutOffRadius, neighborhood);
+    const auto boundary = geometry.LineSegmentsInApproxDistanceTo(ped.pos);
 
-    std::erase_if(neighborhood, [&ped, &boundary](const auto& neighbor) {
-        if(ped.id == neighbor.id) {
+    std::erase_if(neighborhood, [&ped, &boundary](const auto* neighbor) {
+        if(ped.id == neighbor->id) {
             return true;
         }
-        const auto agent_to_neighbor = LineSegment(ped.pos, neighbor.pos);
-        return std::any_of(
-            boundary.cbegin(), boundary.cend(), [&agent_to_neighbor](const auto& segment) {
-                return intersects(agent_to_neighbor, segment);
-            });
+        return intersectsAny(LineSegment(ped.pos, neighbor->pos), boundary);
     });
 
     const auto boundaryRepulsion = std::accumulate(
-        boundary.cbegin(),
-        boundary.cend(),
+        std::begin(boundary),
+        std::end(boundary),
         Point(0, 0),
         [this, &ped](const auto& acc, const auto& element) {
             return acc + BoundaryRepulsion(ped, element);
@@ -117,8 +115,8 @@ OperationalModelUpdate CollisionFreeSpeedModelV3::ComputeNewPosition(
         std::begin(neighborhood),
         std::end(neighborhood),
         std::numeric_limits<double>::max(),
-        [&ped, &direction, this](const auto& res, const auto& neighbor) {
-            return std::min(res, GetSpacing(ped, neighbor, direction));
+        [&ped, &direction, this](const auto& res, const auto* neighbor) {
+            return std::min(res, GetSpacing(ped, *neighbor, direction));
         });
 
     const auto goal_direction =
@@ -127,8 +125,8 @@ OperationalModelUpdate CollisionFreeSpeedModelV3::ComputeNewPosition(
         std::begin(neighborhood),
         std::end(neighborhood),
         std::numeric_limits<double>::max(),
-        [&ped, &goal_direction, this](const auto& res, const auto& neighbor) {
-            return std::min(res, GetSpacing(ped, neighbor, goal_direction));
+        [&ped, &goal_direction, this](const auto& res, const auto* neighbor) {
+            return std::min(res, GetSpacing(ped, *neighbor, goal_direction));
         });
 
     const auto spacing =
@@ -186,22 +184,22 @@ void CollisionFreeSpeedModelV3::CheckModelConstraint(
     validateConstraint(model.thetaMaxUpperBound, 0.0, std::acos(-1.0), "thetaMaxUpperBound");
     validateConstraint(model.agentBuffer, 0.0, 100.0, "agentBuffer");
 
-    const auto neighbors = neighborhoodSearch.GetNeighboringAgents(agent.pos, 2);
-    for(const auto& neighbor : neighbors) {
-        if(agent.id == neighbor.id) {
-            continue;
-        }
-        const auto& neighbor_model = std::get<CollisionFreeSpeedModelV3Data>(neighbor.model);
-        const auto contactDist = model.radius + neighbor_model.radius;
-        const auto distance = (agent.pos - neighbor.pos).Norm();
-        if(contactDist >= distance) {
-            throw SimulationError(
-                "Model constraint violation: Agent {} too close to agent {}: distance {}",
-                agent.pos,
-                neighbor.pos,
-                distance);
-        }
-    }
+    neighborhoodSearch.ForEachNeighboringAgent(
+        agent.pos, 2, [&agent, &model](const auto& neighbor) {
+            if(agent.id == neighbor.id) {
+                return;
+            }
+            const auto& neighbor_model = std::get<CollisionFreeSpeedModelV3Data>(neighbor.model);
+            const auto contactDist = model.radius + neighbor_model.radius;
+            const auto distance = (agent.pos - neighbor.pos).Norm();
+            if(contactDist >= distance) {
+                throw SimulationError(
+                    "Model constraint violation: Agent {} too close to agent {}: distance {}",
+                    agent.pos,
+                    neighbor.pos,
+                    distance);
+            }
+        });
 
     const auto lineSegments = geometry.LineSegmentsInDistanceTo(model.radius, agent.pos);
     if(std::begin(lineSegments) != std::end(lineSegments)) {
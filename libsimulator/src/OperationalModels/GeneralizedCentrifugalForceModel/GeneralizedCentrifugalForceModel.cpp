@@ -47,18 +47,19 @@ OperationalModelUpdate GeneralizedCentrifugalForceModel::ComputeNewPosition(
     const CollisionGeometry& geometry,
     const NeighborhoodSearchType& neighborhoodSearch) const
 {
-    const double radius = 4.0; // TODO (MC) check this free parameter
-    const auto neighborhood = neighborhoodSearch.GetNeighboringAgents(agent.pos, radius);
+    // Reused across calls to avoid allocations, one buffer per thread computing updates
+    thread_local std::vector<const GenericAgent*> neighborhood{};
+    neighborhoodSearch.GetNeighboringAgentsOf(agent, _cutOffRadius, neighborhood);
     const auto p1 = agent.pos;
     Point F_rep;
-    for(const auto& neighbor : neighborhood) {
+    for(const auto* neighbor : neighborhood) {
         // TODO(schroedtert): Only use neighbors who have an unobstructed line of sight to the
         // current agent
-        if(neighbor.id == agent.id) {
+        if(neighbor->id == agent.id) {
             continue;
         }
-        if(!geometry.IntersectsAny(LineSegment(p1, neighbor.pos))) {
-            F_rep += ForceRepPed(agent, neighbor);
+        if(!geometry.IntersectsAny(LineSegment(p1, neighbor->pos))) {
+            F_rep += ForceRepPed(agent, *neighbor);
         }
     }
 
@@ -137,10 +138,9 @@ void GeneralizedCentrifugalForceModel::CheckModelConstraint(
     constexpr double BMaxMax = 2.;
     validateConstraint(BMax, BMaxMin, BMaxMax, "BMax");
 
-    const auto neighbors = neighborhoodSearch.GetNeighboringAgents(agent.pos, 2);
-    for(const auto& neighbor : neighbors) {
+    neighborhoodSearch.ForEachNeighboringAgent(agent.pos, 2, [this, &agent](const auto& neighbor) {
         if(agent.id == neighbor.id) {
-            continue;
+            return;
         }
 
         const auto contanctDist = AgentToAgentSpacing(agent, neighbor);
@@ -156,7 +156,7 @@ void GeneralizedCentrifugalForceModel::CheckModelConstraint(
                 contanctDist,
                 distance - contanctDist);
         }
-    }
+    });
 
     const auto maxRadius = std::max(AMin, BMax) / 2.;
     const auto lineSegments = geometry.LineSegmentsInDistanceTo(maxRadius, agent.pos);
@@ -318,11 +318,11 @@ inline Point GeneralizedCentrifugalForceModel::ForceRepRoom(
     const GenericAgent& ped,
     const CollisionGeometry& geometry) const
 {
-    const auto& walls = geometry.LineSegmentsInApproxDistanceTo(ped.pos);
+    const auto walls = geometry.LineSegmentsInApproxDistanceTo(ped.pos);
 
     auto f = std::accumulate(
-        walls.cbegin(),
-        walls.cend(),
+        std::begin(walls),
+        std::end(walls),
         Point(0, 0),
         [this, &ped](const auto& acc, const auto& element) {
             return acc + ForceRepWall(ped, element);
@@ -23,6 +23,7 @@ private:
     double maxGeometryInterpolationDistance;
     double maxNeighborRepulsionForce;
     double maxGeometryRepulsionForce;
+    double _cutOffRadius{4.0}; // TODO (MC) check this free parameter
 
 public:
     GeneralizedCentrifugalForceModel(
@@ -37,6 +38,8 @@ public:
     ~GeneralizedCentrifugalForceModel() override = default;
 
     OperationalModelType Type() const override;
+    bool SupportsConcurrentComputation() const override { return true; }
+    double NeighborhoodRadius() const override { return _cutOffRadius; }
     OperationalModelUpdate ComputeNewPosition(
         double dT,
         const GenericAgent& agent,
@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "OperationalModel.hpp"
+
+#include "AgentStore.hpp"
+#include "CollisionGeometry.hpp"
+#include "GenericAgent.hpp"
+#include "NeighborhoodSearch.hpp"
+
+#include <cstddef>
+#include <deque>
+#include <optional>
+#include <span>
+
+void OperationalModel::ComputeNewPositions(
+    double dT,
+    const std::deque<GenericAgent>& agents,
+    const AgentStore& /*agentStore*/,
+    size_t first,
+    size_t last,
+    const CollisionGeometry& geometry,
+    const NeighborhoodSearch<GenericAgent>& neighborhoodSearch,
+    std::span<std::optional<OperationalModelUpdate>> updates) const
+{
+    for(size_t index = first; index < last; ++index) {
+        updates[index] = ComputeNewPosition(dT, agents[index], geometry, neighborhoodSearch);
+    }
+}
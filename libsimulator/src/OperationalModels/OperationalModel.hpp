@@ -9,13 +9,17 @@
 
 #include <fmt/core.h>
 
+#include <cstddef>
+#include <deque>
 #include <optional>
+#include <span>
 #include <string>
 
 template <typename T>
 class NeighborhoodSearch;
 
 struct GenericAgent;
+class AgentStore;
 
 struct PedestrianUpdate {
     std::optional<Point> position{};
@@ -82,11 +86,33 @@ public:
     virtual ~OperationalModel() = default;
 
     virtual OperationalModelType Type() const = 0;
+    /// Returns true if 'ComputeNewPosition' may be called concurrently for different agents.
+    /// Models with shared mutable state, e.g. a random number generator, or models calling back
+    /// into an interpreter have to keep the default and are always evaluated sequentially.
+    virtual bool SupportsConcurrentComputation() const { return false; }
+    /// Largest radius in which 'ComputeNewPosition' queries neighbors, used as cut off radius of
+    /// cached neighbor lists. Models not querying neighbors keep the default.
+    virtual double NeighborhoodRadius() const { return 0.0; }
     virtual OperationalModelUpdate ComputeNewPosition(
         double dT,
         const GenericAgent& ped,
         const CollisionGeometry& geometry,
         const NeighborhoodSearch<GenericAgent>& neighborhoodSearch) const = 0;
+    /// Computes the updates of agents[first] to agents[last - 1] and stores them at the same
+    /// indices in 'updates'. Models may override this to process a block of agents at once, the
+    /// default calls 'ComputeNewPosition' for each agent. Disjoint blocks are computed
+    /// concurrently if 'SupportsConcurrentComputation' returns true.
+    /// 'agentStore' is gathered from 'agents' after the last update of 'neighborhoodSearch', so
+    /// neighbor loops can read its columns at the indices 'GetNeighborIndicesOf' reports.
+    virtual void ComputeNewPositions(
+        double dT,
+        const std::deque<GenericAgent>& agents,
+        const AgentStore& agentStore,
+        size_t first,
+        size_t last,
+        const CollisionGeometry& geometry,
+        const NeighborhoodSearch<GenericAgent>& neighborhoodSearch,
+        std::span<std::optional<OperationalModelUpdate>> updates) const;
 
     virtual void ApplyUpdate(const OperationalModelUpdate& update, GenericAgent& agent) const = 0;
     virtual void CheckModelConstraint(
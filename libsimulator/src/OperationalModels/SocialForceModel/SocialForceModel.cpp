@@ -33,20 +33,22 @@ OperationalModelUpdate SocialForceModel::ComputeNewPosition(
     SocialForceModelUpdate update{};
     auto forces = DrivingForce(ped);
 
-    const auto neighborhood = neighborhoodSearch.GetNeighboringAgents(ped.pos, this->_cutOffRadius);
+    // Reused across calls to avoid allocations, one buffer per thread computing updates
+    thread_local std::vector<const GenericAgent*> neighborhood{};
+    neighborhoodSearch.GetNeighboringAgentsOf(ped, this->_cutOffRadius, neighborhood);
     Point F_rep;
-    for(const auto& neighbor : neighborhood) {
-        if(neighbor.id == ped.id) {
+    for(const auto* neighbor : neighborhood) {
+        if(neighbor->id == ped.id) {
             continue;
         }
-        F_rep += AgentForce(ped, neighbor);
+        F_rep += AgentForce(ped, *neighbor);
     }
     forces += F_rep / model.mass;
-    const auto& walls = geometry.LineSegmentsInApproxDistanceTo(ped.pos);
+    const auto walls = geometry.LineSegmentsInApproxDistanceTo(ped.pos);
 
     const auto obstacle_f = std::accumulate(
-        walls.cbegin(),
-        walls.cend(),
+        std::begin(walls),
+        std::end(walls),
         Point(0, 0),
         [this, &ped](const auto& acc, const auto& element) {
             return acc + ObstacleForce(ped, element);
@@ -99,20 +101,20 @@ void SocialForceModel::CheckModelConstraint(
     const auto radius = model.radius;
     throwIfNegative(radius, "radius");
 
-    const auto neighbors = neighborhoodSearch.GetNeighboringAgents(agent.pos, 2);
-    for(const auto& neighbor : neighbors) {
-        const auto distance = (agent.pos - neighbor.pos).Norm();
-
-        if(model.radius >= distance) {
-            throw SimulationError(
-                "Model constraint violation: Agent {} too close to agent {}: distance {}, "
-                "radius {}",
-                agent.pos,
-                neighbor.pos,
-                distance,
-                model.radius);
-        }
-    }
+    neighborhoodSearch.ForEachNeighboringAgent(
+        agent.pos, 2, [&agent, &model](const auto& neighbor) {
+            const auto distance = (agent.pos - neighbor.pos).Norm();
+
+            if(model.radius >= distance) {
+                throw SimulationError(
+                    "Model constraint violation: Agent {} too close to agent {}: distance {}, "
+                    "radius {}",
+                    agent.pos,
+                    neighbor.pos,
+                    distance,
+                    model.radius);
+            }
+        });
     const auto maxRadius = model.radius / 2;
     const auto lineSegments = geometry.LineSegmentsInDistanceTo(maxRadius, agent.pos);
     if(std::begin(lineSegments) != std::end(lineSegments)) {
@@ -24,6 +24,8 @@ public:
     SocialForceModel(double bodyForce_, double friction_);
     ~SocialForceModel() override = default;
     OperationalModelType Type() const override;
+    bool SupportsConcurrentComputation() const override { return true; }
+    double NeighborhoodRadius() const override { return _cutOffRadius; }
     OperationalModelUpdate ComputeNewPosition(
         double dT,
         const GenericAgent& ped,
@@ -37,6 +37,7 @@
 #include <algorithm>
 #include <cmath>
 #include <variant>
+#include <vector>
 
 // ============================================================================
 // IntrinsicField
@@ -418,7 +419,9 @@ OperationalModelUpdate WarpDriverModel::ComputeNewPosition(
     const double dtSample = _timeHorizon / std::max(_numSamples - 1, 1);
 
     // === Step 2: Perceive - build collision probability field ===
-    const auto neighbors = neighborhoodSearch.GetNeighboringAgents(ped.pos, _cutOffRadius);
+    // Reused across calls to avoid allocations
+    thread_local std::vector<const GenericAgent*> neighbors{};
+    neighborhoodSearch.GetNeighboringAgentsOf(ped, _cutOffRadius, neighbors);
 
     // Short-range repulsion: not part of the original Wolinski et al. (2016)
     // model, which is purely anticipatory. Added as a practical safety net
@@ -426,15 +429,15 @@ OperationalModelUpdate WarpDriverModel::ComputeNewPosition(
     // when agents are already close (dense crowds, late reactions).
     // Similar to the pushout mechanisms in CFS and AVM.
     Point repulsion{0.0, 0.0};
-    for(const auto& neighbor : neighbors) {
-        if(neighbor.id == ped.id) {
+    for(const auto* neighbor : neighbors) {
+        if(neighbor->id == ped.id) {
             continue;
         }
-        const auto* nbData = std::get_if<WarpDriverModelData>(&neighbor.model);
+        const auto* nbData = std::get_if<WarpDriverModelData>(&neighbor->model);
         if(!nbData) {
             continue;
         }
-        Point diff = ped.pos - neighbor.pos;
+        Point diff = ped.pos - neighbor->pos;
         const double dist = diff.Norm();
         const double combinedRadius = agentData.radius + nbData->radius;
         if(dist < combinedRadius * 3.0 && dist > 1e-6) {
@@ -466,12 +469,12 @@ OperationalModelUpdate WarpDriverModel::ComputeNewPosition(
             Sample{t, STP{speed * t, lateralPerturbation, t}, 0.0, STP{0, 0, 0}};
     }
 
-    for(const auto& neighbor : neighbors) {
-        if(neighbor.id == ped.id) {
+    for(const auto* neighbor : neighbors) {
+        if(neighbor->id == ped.id) {
             continue;
         }
 
-        const auto* nbData = std::get_if<WarpDriverModelData>(&neighbor.model);
+        const auto* nbData = std::get_if<WarpDriverModelData>(&neighbor->model);
         if(!nbData) {
             continue;
         }
@@ -494,7 +497,7 @@ OperationalModelUpdate WarpDriverModel::ComputeNewPosition(
         WarpParams wp{};
         wp.posA = ped.pos;
         wp.orientA = effectiveOrient;
-        wp.posB = neighbor.pos;
+        wp.posB = neighbor->pos;
         wp.orientB = nbOrient;
         wp.speedB = nbSpeed;
         wp.radiusB = agentData.radius + nbData->radius; // Minkowski sum
@@ -598,7 +601,7 @@ OperationalModelUpdate WarpDriverModel::ComputeNewPosition(
     newVelWorld = newVelWorld + repulsion;
 
     // Boundary avoidance: steer agents away from walls
-    const auto& walls = geometry.LineSegmentsInApproxDistanceTo(ped.pos);
+    const auto walls = geometry.LineSegmentsInApproxDistanceTo(ped.pos);
     for(const auto& wall : walls) {
         const Point wallVec = wall.p2 - wall.p1;
         const double wallLen2 = wallVec.ScalarProduct(wallVec);
@@ -71,6 +71,7 @@ public:
     ~WarpDriverModel() override = default;
 
     OperationalModelType Type() const override;
+    double NeighborhoodRadius() const override { return _cutOffRadius; }
 
     OperationalModelUpdate ComputeNewPosition(
         double dT,
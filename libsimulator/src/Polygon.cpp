@@ -4,6 +4,7 @@
 #include "Point.hpp"
 #include "SimulationError.hpp"
 
+#include <CGAL/Boolean_set_operations_2.h>
 #include <CGAL/enum.h>
 #include <CGAL/number_utils.h>
 
@@ -46,6 +47,11 @@ bool Polygon::IsInside(Point p) const
     return side != CGAL::Bounded_side::ON_UNBOUNDED_SIDE;
 }
 
+bool Polygon::Overlaps(const Polygon& other) const
+{
+    return CGAL::do_intersect(_polygon, other._polygon);
+}
+
 Point Polygon::Centroid() const
 {
     Point sum{};
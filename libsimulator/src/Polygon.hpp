@@ -21,6 +21,9 @@ public:
     Polygon& operator=(Polygon&& other) = default;
     bool IsConvex() const;
     bool IsInside(Point p) const;
+    /// Returns true if the interiors of both polygons share any point. Polygons that only touch
+    /// along their boundaries do not overlap.
+    bool Overlaps(const Polygon& other) const;
     Point Centroid() const;
     std::tuple<Point, double> ContainingCircle() const;
 
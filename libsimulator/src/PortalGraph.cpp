@@ -0,0 +1,407 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "PortalGraph.hpp"
+
+#include "GenerationStamps.hpp"
+#include "Mesh.hpp"
+#include "SimulationError.hpp"
+#include "ThreadPool.hpp"
+#include "glm/ext/vector_double2.hpp"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace
+{
+constexpr double Infinity{std::numeric_limits<double>::infinity()};
+
+/// Per thread state of the coarse search over the portals, reused between queries, see
+/// 'GenerationStamps'.
+struct CoarseScratch {
+    /// Estimated total length, length so far and node
+    using Entry = std::tuple<double, double, size_t>;
+
+    GenerationStamps stamps{};
+    std::vector<double> g{};
+    std::vector<size_t> parent{};
+    /// Cluster the way from 'parent' to the node passes through
+    std::vector<size_t> cluster{};
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> open{};
+
+    void Begin(size_t nodeCount)
+    {
+        stamps.Begin(nodeCount);
+        if(g.size() < nodeCount) {
+            g.resize(nodeCount);
+            parent.resize(nodeCount);
+            cluster.resize(nodeCount);
+        }
+        open = {};
+    }
+
+    double Cost(size_t node) const { return stamps.IsValid(node) ? g[node] : Infinity; }
+
+    /// Records a way of length 'length' to 'node' coming from 'previous' through 'via'.
+    /// Returns false if a way at least as short is known.
+    bool Improve(size_t node, double length, size_t previous, size_t via)
+    {
+        if(length >= Cost(node)) {
+            return false;
+        }
+        stamps.Mark(node);
+        g[node] = length;
+        parent[node] = previous;
+        cluster[node] = via;
+        return true;
+    }
+};
+
+thread_local CoarseScratch coarseScratch{};
+} // namespace
+
+PortalGraph::PortalGraph(Mesh navigationMesh, size_t threadCount, size_t polygonsPerCluster)
+    : mesh(std::move(navigationMesh))
+{
+    if(polygonsPerCluster == 0) {
+        throw SimulationError("Clusters need to contain at least 1 polygon");
+    }
+    partition(polygonsPerCluster);
+    findPortals();
+    linkPortals(threadCount);
+}
+
+PortalGraph::Route
+PortalGraph::ComputeRoute(glm::dvec2 from, size_t fromPolygon, glm::dvec2 to, size_t toPolygon)
+    const
+{
+    Route route{};
+    if(fromPolygon == toPolygon) {
+        route.polygons.push_back(fromPolygon);
+        return route;
+    }
+    const auto startCluster = clusterOfPolygon.at(fromPolygon);
+    const auto targetCluster = clusterOfPolygon.at(toPolygon);
+    const auto startField = localSearch(from, fromPolygon);
+    const auto targetField = localSearch(to, toPolygon);
+
+    // Nodes are all portals followed by start and destination
+    const size_t start = portals.size();
+    const size_t target = start + 1;
+    auto& scratch = coarseScratch;
+    scratch.Begin(target + 1);
+    scratch.Improve(start, 0, start, startCluster);
+
+    const auto relax = [&](size_t node, double length, size_t previous, size_t via) {
+        if(length == Infinity || !scratch.Improve(node, length, previous, via)) {
+            return;
+        }
+        const auto estimate = node == target ? 0. : glm::distance(portals[node].center, to);
+        scratch.open.emplace(length + estimate, length, node);
+    };
+
+    if(startCluster == targetCluster) {
+        relax(target, distanceTo(startField, toPolygon, to), start, startCluster);
+    }
+    for(const auto portal : clusters[startCluster].portals) {
+        const auto& p = portals[portal];
+        relax(
+            portal,
+            distanceTo(startField, p.polygons[side(p, startCluster)], p.center),
+            start,
+            startCluster);
+    }
+
+    while(!scratch.open.empty()) {
+        const auto [estimate, length, node] = scratch.open.top();
+        scratch.open.pop();
+        if(length > scratch.Cost(node)) {
+            continue;
+        }
+        if(node == target) {
+            break;
+        }
+        ++route.expandedNodes;
+        for(size_t index = linkOffsets[node]; index < linkOffsets[node + 1]; ++index) {
+            const auto& link = links[index];
+            relax(link.portal, length + link.distance, node, link.cluster);
+        }
+        const auto& portal = portals[node];
+        for(size_t s = 0; s < 2; ++s) {
+            if(portal.clusters[s] == targetCluster) {
+                relax(
+                    target,
+                    length + distanceTo(targetField, portal.polygons[s], portal.center),
+                    node,
+                    targetCluster);
+            }
+        }
+    }
+    if(scratch.Cost(target) == Infinity) {
+        return route;
+    }
+
+    std::vector<size_t> nodes{target};
+    while(nodes.back() != start) {
+        nodes.push_back(scratch.parent[nodes.back()]);
+    }
+    std::reverse(nodes.begin(), nodes.end());
+
+    // Refine every leg between two nodes into the polygons of the cluster it passes through.
+    // Consecutive legs either continue in the same polygon or on both sides of a portal.
+    std::vector<size_t> leg{};
+    for(size_t index = 1; index < nodes.size(); ++index) {
+        const auto head = nodes[index - 1];
+        const auto tail = nodes[index];
+        const auto cluster = scratch.cluster[tail];
+        const auto polygonOf = [&](size_t node) {
+            if(node == start) {
+                return fromPolygon;
+            }
+            if(node == target) {
+                return toPolygon;
+            }
+            return portals[node].polygons[side(portals[node], cluster)];
+        };
+        leg.clear();
+        if(tail == target && head != start) {
+            appendTowardsSource(targetField, polygonOf(head), leg);
+        } else if(head == start) {
+            appendTowardsSource(startField, polygonOf(tail), leg);
+            std::reverse(leg.begin(), leg.end());
+        } else {
+            const auto field = localSearch(portals[head].center, polygonOf(head), polygonOf(tail));
+            appendTowardsSource(field, polygonOf(tail), leg);
+            std::reverse(leg.begin(), leg.end());
+        }
+        for(const auto polygon : leg) {
+            if(route.polygons.empty() || route.polygons.back() != polygon) {
+                route.polygons.push_back(polygon);
+            }
+        }
+    }
+    return route;
+}
+
+void PortalGraph::partition(size_t polygonsPerCluster)
+{
+    const auto polygonCount = mesh.CountPolygons();
+    clusterOfPolygon.assign(polygonCount, Mesh::InvalidIndex);
+    localIndex.assign(polygonCount, Mesh::InvalidIndex);
+    if(polygonCount == 0) {
+        return;
+    }
+
+    std::vector<glm::dvec2> centroids{};
+    centroids.reserve(polygonCount);
+    glm::dvec2 min{Infinity, Infinity};
+    glm::dvec2 max{-Infinity, -Infinity};
+    for(size_t index = 0; index < polygonCount; ++index) {
+        const auto& polygon = mesh.Polygons(index);
+        glm::dvec2 centroid{0, 0};
+        for(const auto vertex : polygon.vertices) {
+            centroid = centroid + mesh.Vertex(vertex);
+        }
+        centroid = centroid / static_cast<double>(polygon.vertices.size());
+        centroids.push_back(centroid);
+        min = {std::min(min.x, centroid.x), std::min(min.y, centroid.y)};
+        max = {std::max(max.x, centroid.x), std::max(max.y, centroid.y)};
+    }
+
+    // Cells are sized to hold 'polygonsPerCluster' polygons if the mesh covers its bounds
+    const auto extent = max - min;
+    const double share = static_cast<double>(polygonsPerCluster) / polygonCount;
+    double cellSize = extent.x * extent.y > 0 ? std::sqrt(extent.x * extent.y * share)
+                                              : std::max(extent.x, extent.y) * share;
+    if(!(cellSize > 0)) {
+        cellSize = 1;
+    }
+    const auto cellOf = [&](size_t polygon) {
+        return std::make_pair(
+            static_cast<int64_t>(std::floor((centroids[polygon].x - min.x) / cellSize)),
+            static_cast<int64_t>(std::floor((centroids[polygon].y - min.y) / cellSize)));
+    };
+
+    // Every connected set of polygons inside of one cell becomes a cluster
+    std::vector<size_t> pending{};
+    for(size_t seed = 0; seed < polygonCount; ++seed) {
+        if(clusterOfPolygon[seed] != Mesh::InvalidIndex) {
+            continue;
+        }
+        const auto clusterIndex = clusters.size();
+        auto& cluster = clusters.emplace_back();
+        const auto cell = cellOf(seed);
+        clusterOfPolygon[seed] = clusterIndex;
+        pending.push_back(seed);
+        while(!pending.empty()) {
+            const auto polygon = pending.back();
+            pending.pop_back();
+            localIndex[polygon] = cluster.polygons.size();
+            cluster.polygons.push_back(polygon);
+            for(const auto neighbor : mesh.Polygons(polygon).neighbors) {
+                if(neighbor == Mesh::Polygon::InvalidIndex ||
+                   clusterOfPolygon[neighbor] != Mesh::InvalidIndex || cellOf(neighbor) != cell) {
+                    continue;
+                }
+                clusterOfPolygon[neighbor] = clusterIndex;
+                pending.push_back(neighbor);
+            }
+        }
+    }
+}
+
+void PortalGraph::findPortals()
+{
+    for(size_t polygon = 0; polygon < mesh.CountPolygons(); ++polygon) {
+        const auto& neighbors = mesh.Polygons(polygon).neighbors;
+        for(size_t edge = 0; edge < neighbors.size(); ++edge) {
+            const auto neighbor = neighbors[edge];
+            if(neighbor == Mesh::Polygon::InvalidIndex || neighbor < polygon ||
+               clusterOfPolygon[neighbor] == clusterOfPolygon[polygon]) {
+                continue;
+            }
+            const Portal portal{
+                {polygon, neighbor},
+                {clusterOfPolygon[polygon], clusterOfPolygon[neighbor]},
+                edge,
+                edgeCenter(polygon, edge)};
+            clusters[portal.clusters[0]].portals.push_back(portals.size());
+            clusters[portal.clusters[1]].portals.push_back(portals.size());
+            portals.push_back(portal);
+        }
+    }
+}
+
+void PortalGraph::linkPortals(size_t threadCount)
+{
+    // Links found in cluster c from its i-th portal are 'clusterLinks[c][i]'
+    std::vector<std::vector<std::vector<Link>>> clusterLinks(clusters.size());
+    ThreadPool pool(threadCount);
+    pool.ParallelFor(
+        clusters.size(),
+        [this, &clusterLinks](size_t clusterIndex) {
+            const auto& cluster = clusters[clusterIndex];
+            auto& result = clusterLinks[clusterIndex];
+            result.resize(cluster.portals.size());
+            for(size_t index = 0; index < cluster.portals.size(); ++index) {
+                const auto& from = portals[cluster.portals[index]];
+                const auto field =
+                    localSearch(from.center, from.polygons[side(from, clusterIndex)]);
+                for(const auto other : cluster.portals) {
+                    if(other == cluster.portals[index]) {
+                        continue;
+                    }
+                    const auto& to = portals[other];
+                    const auto distance =
+                        distanceTo(field, to.polygons[side(to, clusterIndex)], to.center);
+                    if(distance != Infinity) {
+                        result[index].push_back({other, clusterIndex, distance});
+                    }
+                }
+            }
+        },
+        1);
+
+    std::vector<std::vector<Link>> portalLinks(portals.size());
+    for(size_t clusterIndex = 0; clusterIndex < clusters.size(); ++clusterIndex) {
+        const auto& cluster = clusters[clusterIndex];
+        for(size_t index = 0; index < cluster.portals.size(); ++index) {
+            auto& target = portalLinks[cluster.portals[index]];
+            const auto& found = clusterLinks[clusterIndex][index];
+            target.insert(target.end(), found.begin(), found.end());
+        }
+    }
+    linkOffsets.clear();
+    linkOffsets.reserve(portals.size() + 1);
+    linkOffsets.push_back(0);
+    for(const auto& found : portalLinks) {
+        links.insert(links.end(), found.begin(), found.end());
+        linkOffsets.push_back(links.size());
+    }
+}
+
+glm::dvec2 PortalGraph::edgeCenter(size_t polygon, size_t edge) const
+{
+    const auto& vertices = mesh.Polygons(polygon).vertices;
+    return (mesh.Vertex(vertices[edge]) + mesh.Vertex(vertices[(edge + 1) % vertices.size()])) /
+           2.;
+}
+
+size_t PortalGraph::side(const Portal& portal, size_t cluster) const
+{
+    return portal.clusters[0] == cluster ? 0 : 1;
+}
+
+PortalGraph::LocalField
+PortalGraph::localSearch(glm::dvec2 source, size_t polygon, size_t stopPolygon) const
+{
+    const auto clusterIndex = clusterOfPolygon[polygon];
+    const auto& cluster = clusters[clusterIndex];
+    const auto count = cluster.polygons.size();
+    LocalField field{
+        std::vector<double>(count, Infinity),
+        std::vector<size_t>(count, Mesh::InvalidIndex),
+        std::vector<glm::dvec2>(count)};
+
+    using Entry = std::pair<double, size_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> open{};
+    const auto first = localIndex[polygon];
+    field.distance[first] = 0;
+    field.entry[first] = source;
+    open.emplace(0, first);
+    while(!open.empty()) {
+        const auto [distance, local] = open.top();
+        open.pop();
+        if(distance > field.distance[local]) {
+            continue;
+        }
+        const auto current = cluster.polygons[local];
+        if(current == stopPolygon) {
+            break;
+        }
+        const auto& neighbors = mesh.Polygons(current).neighbors;
+        for(size_t edge = 0; edge < neighbors.size(); ++edge) {
+            const auto neighbor = neighbors[edge];
+            if(neighbor == Mesh::Polygon::InvalidIndex ||
+               clusterOfPolygon[neighbor] != clusterIndex) {
+                continue;
+            }
+            const auto center = edgeCenter(current, edge);
+            const auto candidate = distance + glm::distance(field.entry[local], center);
+            const auto next = localIndex[neighbor];
+            if(candidate < field.distance[next]) {
+                field.distance[next] = candidate;
+                field.previous[next] = local;
+                field.entry[next] = center;
+                open.emplace(candidate, next);
+            }
+        }
+    }
+    return field;
+}
+
+double PortalGraph::distanceTo(const LocalField& field, size_t polygon, glm::dvec2 position) const
+{
+    const auto local = localIndex[polygon];
+    return field.distance[local] + glm::distance(field.entry[local], position);
+}
+
+void PortalGraph::appendTowardsSource(
+    const LocalField& field,
+    size_t polygon,
+    std::vector<size_t>& route) const
+{
+    const auto& cluster = clusters[clusterOfPolygon[polygon]];
+    for(auto local = localIndex[polygon]; local != Mesh::InvalidIndex;
+        local = field.previous[local]) {
+        route.push_back(cluster.polygons[local]);
+    }
+}
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "Mesh.hpp"
+#include "glm/ext/vector_double2.hpp"
+
+#include <cstddef>
+#include <vector>
+
+/// Hierarchical abstraction of a Mesh for long-range routing.
+///
+/// The polygons are partitioned into clusters, each cluster is a connected set of polygons whose
+/// centroids lie in the same cell of a uniform grid. Edges between polygons of different clusters
+/// are portals. For every cluster the distances between all of its portals are precomputed, so a
+/// query only searches the polygons of the clusters containing start and destination plus the
+/// graph of portals, and afterwards refines the portals it passes into a sequence of polygons.
+/// Distances are measured along edge midpoints like in 'NavigationField', routes are therefore
+/// close to but not always the shortest ones.
+class PortalGraph
+{
+public:
+    /// Number of polygons a cluster contains on average if the mesh fills its bounds.
+    static constexpr size_t DEFAULT_POLYGONS_PER_CLUSTER = 128;
+
+    /// Result of one query.
+    struct Route {
+        /// Adjacent polygons from the start to the destination, empty if unreachable
+        std::vector<size_t> polygons{};
+        /// Number of portals expanded by the coarse search
+        size_t expandedNodes{0};
+    };
+
+private:
+    /// Edge between two polygons of different clusters, side 0 is the polygon whose edge
+    /// 'edge' it is
+    struct Portal {
+        size_t polygons[2];
+        size_t clusters[2];
+        size_t edge;
+        glm::dvec2 center;
+    };
+    /// Precomputed distance from one portal to another through 'cluster'
+    struct Link {
+        size_t portal;
+        size_t cluster;
+        double distance;
+    };
+    struct Cluster {
+        std::vector<size_t> polygons{};
+        std::vector<size_t> portals{};
+    };
+    /// Walking distances from one position to the polygons of one cluster
+    struct LocalField {
+        std::vector<double> distance{};
+        /// Local index of the previous polygon on the way to the position
+        std::vector<size_t> previous{};
+        /// Position through which the way to the position leaves each polygon
+        std::vector<glm::dvec2> entry{};
+    };
+
+    Mesh mesh;
+    std::vector<size_t> clusterOfPolygon{};
+    /// Index of each polygon in 'Cluster::polygons' of its cluster
+    std::vector<size_t> localIndex{};
+    std::vector<Cluster> clusters{};
+    std::vector<Portal> portals{};
+    /// Links of portal i are 'links[linkOffsets[i]]' to 'links[linkOffsets[i + 1] - 1]'
+    std::vector<size_t> linkOffsets{};
+    std::vector<Link> links{};
+
+public:
+    /// Partitions 'navigationMesh' and precomputes all portal distances on 'threadCount' threads.
+    /// The result does not depend on the number of threads.
+    PortalGraph(
+        Mesh navigationMesh,
+        size_t threadCount,
+        size_t polygonsPerCluster = DEFAULT_POLYGONS_PER_CLUSTER);
+    ~PortalGraph() = default;
+    PortalGraph(const PortalGraph& other) = default;
+    PortalGraph& operator=(const PortalGraph& other) = default;
+    PortalGraph(PortalGraph&& other) = default;
+    PortalGraph& operator=(PortalGraph&& other) = default;
+
+    /// Computes the route from 'from' inside of polygon 'fromPolygon' to 'to' inside of polygon
+    /// 'toPolygon'. Safe to call concurrently.
+    Route ComputeRoute(glm::dvec2 from, size_t fromPolygon, glm::dvec2 to, size_t toPolygon) const;
+
+    size_t CountClusters() const { return clusters.size(); }
+    size_t CountPortals() const { return portals.size(); }
+    size_t ClusterOf(size_t polygon) const { return clusterOfPolygon.at(polygon); }
+    const Mesh& MeshData() const { return mesh; }
+
+private:
+    void partition(size_t polygonsPerCluster);
+    void findPortals();
+    void linkPortals(size_t threadCount);
+    glm::dvec2 edgeCenter(size_t polygon, size_t edge) const;
+    /// Side of 'portal' that belongs to 'cluster'
+    size_t side(const Portal& portal, size_t cluster) const;
+    /// Distances from 'source' inside of 'polygon' to all polygons of the cluster of 'polygon'.
+    /// Stops once 'stopPolygon' is reached if it is part of the cluster.
+    LocalField localSearch(
+        glm::dvec2 source,
+        size_t polygon,
+        size_t stopPolygon = Mesh::Polygon::InvalidIndex) const;
+    /// Distance from the source of 'field' in 'cluster' to 'position' inside of 'polygon'
+    double distanceTo(const LocalField& field, size_t polygon, glm::dvec2 position) const;
+    /// Appends the polygons from 'polygon' to the source of 'field' to 'route'
+    void appendTowardsSource(const LocalField& field, size_t polygon, std::vector<size_t>& route)
+        const;
+};
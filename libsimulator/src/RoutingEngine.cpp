@@ -1,12 +1,17 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #include "RoutingEngine.hpp"
 
+#include "AABB.hpp"
+#include "AnyAngleSearch.hpp"
 #include "CfgCgal.hpp"
+#include "GenerationStamps.hpp"
 #include "GeometricFunctions.hpp"
 #include "LineSegment.hpp"
 #include "Mesh.hpp"
 #include "Point.hpp"
+#include "PortalGraph.hpp"
 #include "SimulationError.hpp"
+#include "ThreadPool.hpp"
 
 #include <CGAL/Constrained_Delaunay_triangulation_2.h>
 #include <CGAL/Distance_2/Point_2_Segment_2.h>
@@ -16,8 +21,13 @@
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
-#include <deque>
+#include <cstdint>
+#include <functional>
 #include <limits>
+#include <optional>
+#include <queue>
+#include <span>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -37,71 +47,207 @@ RoutingEngine::RoutingEngine(const PolyWithHoles& poly)
         cdt.insert_constraint(p.vertices_begin(), p.vertices_end(), true);
     }
     CGAL::mark_domain_in_triangulation(cdt);
-    mesh = std::make_unique<Mesh>(cdt);
+    indexFaces();
 }
 
 std::unique_ptr<RoutingEngine> RoutingEngine::Clone() const
 {
     auto clone = std::make_unique<RoutingEngine>();
     clone->cdt = cdt;
-    clone->mesh = mesh->Clone();
+    clone->indexFaces();
+    if(mesh) {
+        clone->mesh = mesh->Clone();
+    }
+    clone->algorithm = algorithm;
+    clone->threadCount = threadCount;
+    if(anyAngleSearch) {
+        clone->anyAngleSearch = std::make_unique<AnyAngleSearch>(*anyAngleSearch);
+    }
+    if(portalGraph) {
+        clone->portalGraph = std::make_unique<PortalGraph>(*portalGraph);
+    }
     return clone;
 }
 
+void RoutingEngine::SetAlgorithm(RoutingAlgorithm newAlgorithm, size_t newThreadCount)
+{
+    if(newAlgorithm == algorithm && newThreadCount == threadCount) {
+        return;
+    }
+    algorithm = newAlgorithm;
+    threadCount = newThreadCount;
+    updateSearchStructures();
+}
+
+RoutingAlgorithm RoutingEngine::Algorithm() const
+{
+    return algorithm;
+}
+
+const Mesh* RoutingEngine::MeshData() const
+{
+    if(!mesh) {
+        mesh = std::make_unique<Mesh>(cdt);
+    }
+    return mesh.get();
+}
+
 Point RoutingEngine::ComputeWaypoint(Point currentPosition, Point destination)
 {
     return ComputeAllWaypoints(currentPosition, destination)[1];
 }
 
-struct SearchState {
-    double g_value{};
-    double h_value{};
-    CDT::Face_handle id{};
-    SearchState* parent{};
+namespace
+{
+/// Scratch memory of the search in 'RoutingEngine::ComputeCorridor', one instance per thread.
+/// All per-face arrays are indexed by the dense face index of the RoutingEngine, see
+/// 'GenerationStamps'.
+class SearchScratch
+{
+public:
+    static constexpr uint32_t NoFace{std::numeric_limits<uint32_t>::max()};
+
+private:
+    static constexpr uint32_t Closed{std::numeric_limits<uint32_t>::max()};
+    GenerationStamps stamps{};
+    std::vector<double> g{};
+    std::vector<double> h{};
+    std::vector<uint32_t> parent{};
+    /// Position of an open face in 'heap' or 'Closed'
+    std::vector<uint32_t> heapPosition{};
+    /// Binary min heap of all open faces ordered by f-value, ties are broken by face index
+    std::vector<uint32_t> heap{};
+
+public:
+    /// Reusable buffer for the faces of a candidate corridor
+    std::vector<CDT::Face_handle> path{};
+
+    void Begin(size_t faceCount)
+    {
+        stamps.Begin(faceCount);
+        if(g.size() < faceCount) {
+            g.resize(faceCount);
+            h.resize(faceCount);
+            parent.resize(faceCount);
+            heapPosition.resize(faceCount);
+            heap.reserve(faceCount);
+        }
+        heap.clear();
+    }
+
+    bool IsOpen(uint32_t face) const
+    {
+        return stamps.IsValid(face) && heapPosition[face] != Closed;
+    }
+    bool IsClosed(uint32_t face) const
+    {
+        return stamps.IsValid(face) && heapPosition[face] == Closed;
+    }
+    bool Empty() const { return heap.empty(); }
+    double G(uint32_t face) const { return g[face]; }
+    double H(uint32_t face) const { return h[face]; }
+    double F(uint32_t face) const { return g[face] + h[face]; }
+    uint32_t Parent(uint32_t face) const { return parent[face]; }
+
+    /// Adds a face that was not seen in this search to the open faces.
+    void Open(uint32_t face, double gValue, double hValue, uint32_t parentFace)
+    {
+        stamps.Mark(face);
+        g[face] = gValue;
+        h[face] = hValue;
+        parent[face] = parentFace;
+        heapPosition[face] = static_cast<uint32_t>(heap.size());
+        heap.push_back(face);
+        siftUp(heapPosition[face]);
+    }
 
-    SearchState(double g, double h, CDT::Face_handle _id, SearchState* _parent)
-        : g_value(g), h_value(h), id(_id), parent(_parent)
+    /// Lowers the g-value of an open face, O(log n).
+    void Improve(uint32_t face, double gValue, uint32_t parentFace)
     {
+        g[face] = gValue;
+        parent[face] = parentFace;
+        siftUp(heapPosition[face]);
     }
 
-    double f_value() const { return g_value + h_value; }
-    bool parents_contain(CDT::Face_handle ancestor_id) const
+    /// Removes the open face with the smallest f-value and marks it as closed.
+    uint32_t PopClosed()
     {
-        const SearchState* pivot = this;
-        while(pivot != nullptr) {
-            if(pivot->id == ancestor_id) {
-                return true;
-            }
-            pivot = pivot->parent;
+        const auto face = heap.front();
+        heapPosition[face] = Closed;
+        heap.front() = heap.back();
+        heap.pop_back();
+        if(!heap.empty()) {
+            heapPosition[heap.front()] = 0;
+            siftDown(0);
         }
-        return false;
+        return face;
+    }
+
+private:
+    bool less(uint32_t a, uint32_t b) const
+    {
+        const auto fa = F(a);
+        const auto fb = F(b);
+        return fa < fb || (fa == fb && a < b);
+    }
+
+    void place(size_t position, uint32_t face)
+    {
+        heap[position] = face;
+        heapPosition[face] = static_cast<uint32_t>(position);
     }
-    std::vector<CDT::Face_handle> path() const
+
+    void siftUp(size_t position)
     {
-        std::vector<CDT::Face_handle> p{};
-        p.reserve(16);
-        const SearchState* pivot = this;
-        while(pivot != nullptr) {
-            p.emplace_back(pivot->id);
-            pivot = pivot->parent;
+        const auto face = heap[position];
+        while(position > 0) {
+            const auto up = (position - 1) / 2;
+            if(!less(face, heap[up])) {
+                break;
+            }
+            place(position, heap[up]);
+            position = up;
         }
-        std::reverse(std::begin(p), std::end(p));
-        return p;
+        place(position, face);
     }
-};
 
-struct FaceHandleHash {
-    std::size_t operator()(CDT::Face_handle fh) const noexcept
+    void siftDown(size_t position)
     {
-        // Face_handle is an iterator, therefore use "&*"-pattern to get the address.
-        return std::hash<decltype(&*fh)>{}(&*fh);
+        const auto face = heap[position];
+        while(true) {
+            auto down = 2 * position + 1;
+            if(down >= heap.size()) {
+                break;
+            }
+            if(down + 1 < heap.size() && less(heap[down + 1], heap[down])) {
+                ++down;
+            }
+            if(!less(heap[down], face)) {
+                break;
+            }
+            place(position, heap[down]);
+            position = down;
+        }
+        place(position, face);
     }
 };
 
-bool CompareSearchStatesGt(const SearchState* a, const SearchState* b)
+thread_local SearchScratch searchScratch{};
+
+/// Returns true if 'p' is inside of or on the boundary of 'face'.
+bool faceContains(CDT::Face_handle face, const K::Point_2& p)
 {
-    return a->f_value() > b->f_value();
+    // Faces of the triangulation are oriented CCW, points on an edge belong to both faces.
+    for(int idx = 0; idx < 3; ++idx) {
+        const auto& a = face->vertex(idx)->point();
+        const auto& b = face->vertex(CDT::ccw(idx))->point();
+        if(CGAL::orientation(a, b, p) == CGAL::RIGHT_TURN) {
+            return false;
+        }
+    }
+    return true;
 }
+} // namespace
 
 double length_of_path(const std::vector<Point>& path)
 {
@@ -114,63 +260,149 @@ double length_of_path(const std::vector<Point>& path)
 
 std::vector<Point> RoutingEngine::ComputeAllWaypoints(Point currentPosition, Point destination)
 {
-    const auto from_pos = CDT::Point{currentPosition.x, currentPosition.y};
-    const auto to_pos = CDT::Point{destination.x, destination.y};
-    const auto from = find_face(from_pos);
-    const auto to = find_face(to_pos);
+    return ComputeCorridor(currentPosition, destination).waypoints;
+}
+
+Corridor RoutingEngine::ComputeCorridor(Point currentPosition, Point destination)
+{
+    return ComputeCorridor(currentPosition, destination, NoFaceHint, NoFaceHint);
+}
+
+Corridor RoutingEngine::ComputeCorridor(
+    Point currentPosition,
+    Point destination,
+    size_t currentHint,
+    size_t destinationHint)
+{
+    const auto from = find_face({currentPosition.x, currentPosition.y}, currentHint);
+    const auto to = find_face({destination.x, destination.y}, destinationHint);
 
     if(from == to) {
-        return std::vector<Point>{currentPosition, destination};
+        return Corridor{destination, {from}, {currentPosition, destination}};
+    }
+    if(algorithm == RoutingAlgorithm::AnyAngle) {
+        if(auto corridor = computeAnyAngleCorridor(currentPosition, destination, from); corridor) {
+            return std::move(*corridor);
+        }
+    }
+    if(algorithm == RoutingAlgorithm::Hierarchical) {
+        if(auto corridor = computeHierarchicalCorridor(currentPosition, destination, from, to);
+           corridor) {
+            return std::move(*corridor);
+        }
+    }
+    return computeTriangleCorridor(currentPosition, destination, from, to);
+}
+
+RoutingBatch RoutingEngine::ComputeBatch(
+    std::span<const Point> origins,
+    std::span<const Point> destinations,
+    size_t threadCount,
+    bool withWaypoints)
+{
+    if(origins.size() != destinations.size()) {
+        throw SimulationError(
+            "Expected as many destinations as origins, got {} origins and {} destinations",
+            origins.size(),
+            destinations.size());
+    }
+    const auto count = origins.size();
+    RoutingBatch batch{};
+    batch.lengths.resize(count, std::numeric_limits<double>::infinity());
+    std::vector<std::vector<Point>> paths(withWaypoints ? count : 0);
+
+    // Positions are located without hints, so every query finds the same triangles no matter
+    // which queries ran before it on the same thread
+    ThreadPool pool(threadCount);
+    pool.ParallelFor(count, [&](size_t index) {
+        const auto& origin = origins[index];
+        const auto& destination = destinations[index];
+        size_t originFace{};
+        size_t destinationFace{};
+        try {
+            originFace = Locate(origin);
+            destinationFace = Locate(destination);
+        } catch(const SimulationError&) {
+            return;
+        }
+        auto corridor = ComputeCorridor(origin, destination, originFace, destinationFace);
+        if(corridor.faces.empty()) {
+            return;
+        }
+        batch.lengths[index] = length_of_path(corridor.waypoints);
+        if(withWaypoints) {
+            paths[index] = std::move(corridor.waypoints);
+        }
+    });
+
+    if(withWaypoints) {
+        batch.offsets.reserve(count + 1);
+        batch.offsets.push_back(0);
+        for(const auto& path : paths) {
+            batch.offsets.push_back(batch.offsets.back() + path.size());
+        }
+        batch.waypoints.reserve(batch.offsets.back());
+        for(const auto& path : paths) {
+            batch.waypoints.insert(batch.waypoints.end(), path.begin(), path.end());
+        }
     }
+    return batch;
+}
 
-    // Hold all search states inside a deque which never invalidates pointers and grows within O(1)
-    std::deque<SearchState> all_search_states{};
-    std::vector<SearchState*> open_states{};
-    all_search_states.emplace_back(0.0, Distance(currentPosition, destination), from, nullptr);
-    open_states.push_back(&all_search_states.back());
+Corridor RoutingEngine::computeTriangleCorridor(
+    Point currentPosition,
+    Point destination,
+    CDT::Face_handle from,
+    CDT::Face_handle to)
+{
+    const auto from_pos = CDT::Point{currentPosition.x, currentPosition.y};
+    const auto to_pos = CDT::Point{destination.x, destination.y};
 
-    std::unordered_map<CDT::Face_handle, SearchState*, FaceHandleHash> closed_states{};
+    // Search over the dense face indices with per-thread scratch arrays, see 'SearchScratch'
+    auto& scratch = searchScratch;
+    scratch.Begin(faces.size());
+    scratch.Open(
+        static_cast<uint32_t>(from->get_index()),
+        0.0,
+        Distance(currentPosition, destination),
+        SearchScratch::NoFace);
 
-    std::vector<Point> path{};
+    Corridor corridor{destination, {}, {}};
     double path_length = std::numeric_limits<double>::infinity();
 
-    while(!open_states.empty()) {
-        std::pop_heap(open_states.begin(), open_states.end(), CompareSearchStatesGt);
-        SearchState* current_state = open_states.back();
-        open_states.pop_back();
-        closed_states.emplace(current_state->id, current_state);
+    while(!scratch.Empty()) {
+        const auto current = scratch.PopClosed();
+        const auto current_face = faces[current];
 
-        if(current_state->f_value() >= path_length) {
+        if(scratch.F(current) >= path_length) {
             // This search node's f-value already exceeds our path's length, and since the f-value
             // is underestimation of the path length the exact path cannot be shorter than what we
             // have
-            return path;
+            return corridor;
         }
 
         // Generate successors
         for(int idx = 0; idx < 3; ++idx) {
-            const auto target = current_state->id->neighbor(idx);
+            const auto target = current_face->neighbor(idx);
             if(!target->get_in_domain()) {
                 // Not a neighboring triangle.
                 continue;
             }
-            // Do not add search nodes for nodes already in the ancestor list of this path
-            if(current_state->parents_contain(target)) {
-                continue;
-            }
+            const auto target_index = static_cast<uint32_t>(target->get_index());
 
-            // Skip successors for nodes already in the closed list
-            if(closed_states.contains(target)) {
+            // Skip successors for nodes already in the closed list. Closed nodes are never
+            // reopened, so this also skips all nodes in the ancestor list of this path.
+            if(scratch.IsClosed(target_index)) {
                 continue;
             }
 
-            // The shared edge between `current_state->id` and `target` is the edge
+            // The shared edge between `current_face` and `target` is the edge
             // opposite vertex `idx` of the CURRENT face. CGAL's neighbor indexing is
             // not symmetric: the index of `target` in current's neighbor list differs
             // from the index of `current` in target's neighbor list, so querying
             // `cdt.segment(target, idx)` returns an unrelated edge of `target` and
             // produces bogus g/h values that mis-rank successors in A*.
-            const auto edge = cdt.segment(current_state->id, idx);
+            const auto edge = cdt.segment(current_face, idx);
 
             // For all remaining nodes compute g/h values
             // The h-value is the distance between the goal and the closest point on the edge
@@ -194,19 +426,19 @@ std::vector<Point> RoutingEngine::ComputeAllWaypoints(Point currentPosition, Poi
             // by these edges. Thus, if the entry edges of the triangles corresponding to s′ and
             // s form an angle θ, this estimate is calculated as g(s) + rθ. NOTE: Right now this
             // is always g(s) + zero as we assume point size agents (for now)
-            const double g_value_2 = current_state->g_value + 0;
+            const double g_value_2 = scratch.G(current) + 0;
 
             //  Another lower bound value for g(s′) is g(s)+(h(s)−h(s′)), or the parent state’s
             //  g-value plus the difference between its h-value and that of the child state.
             //  This is an underestimate because the Euclidean distance metric used for the
             //  heuristic is consistent.
-            const double g_value_3 = current_state->g_value + current_state->h_value - h_value;
+            const double g_value_3 = scratch.G(current) + scratch.H(current) - h_value;
 
             const double g_value = std::max(g_value_1, std::max(g_value_2, g_value_3));
 
             // Evaluate every route that reaches the destination inline so that all
             // candidate routes have their funnel computed — not just the first one
-            // (minimum-f_value) to arrive.  The closed_states guard would otherwise
+            // (minimum-f_value) to arrive.  The closed list guard would otherwise
             // block all subsequent routes from being evaluated.
             if(target == to) {
                 // g_value + h_value is f_value which is a lower bound and therefore needs
@@ -215,75 +447,415 @@ std::vector<Point> RoutingEngine::ComputeAllWaypoints(Point currentPosition, Poi
                     // Unlike in A* this is only a first candidate solution
                     // Now compute the actual path length via funnel algorithm
                     // store path and length if this variant is the shortest found so far
-                    const SearchState dest_state{g_value, h_value, to, current_state};
-                    const auto vertex_ids = dest_state.path();
-                    const auto found_path =
-                        straightenPath(currentPosition, destination, vertex_ids);
+                    auto& path = scratch.path;
+                    path.clear();
+                    path.push_back(to);
+                    for(auto face = current; face != SearchScratch::NoFace;
+                        face = scratch.Parent(face)) {
+                        path.push_back(faces[face]);
+                    }
+                    std::reverse(std::begin(path), std::end(path));
+                    auto found_path = straightenPath(currentPosition, destination, path);
                     const double found_path_length = length_of_path(found_path);
                     if(found_path_length < path_length) {
-                        path = found_path;
+                        corridor.faces.assign(std::begin(path), std::end(path));
+                        corridor.waypoints = std::move(found_path);
                         path_length = found_path_length;
                     }
                 }
                 continue;
             }
 
-            // NOTE(kkratz): Clang16 seems to be confused with capturing a structured binding
-            // and emits a warning when capturing 'target' directly. As of C++20 this SHOULD(TM)
-            // be valid code but see:
-            // https://stackoverflow.com/questions/46114214/lambda-implicit-capture-fails-with-variable-declared-from-structured-binding
-            auto t2 = target;
-
-            // TODO(kkratz): replace this find on unsorted vector with something with a better
-            // runtime
-            if(auto iter = std::find_if(
-                   std::begin(open_states),
-                   std::end(open_states),
-                   [t2](const auto& s) { return s->id == t2; });
-               iter != std::end(open_states)) {
-                if(auto* s = *iter; s->g_value > g_value) {
-                    s->g_value = g_value;
-                    s->parent = current_state;
-                    // As the g_value got modified, the heap needs to be entirely remade.
-                    std::make_heap(open_states.begin(), open_states.end(), CompareSearchStatesGt);
-                }
-            } else if(auto iter = closed_states.find(target); iter != closed_states.end()) {
-                auto* s = iter->second;
-                if(s->g_value > g_value) {
-                    s->g_value = g_value;
-                    s->parent = current_state;
-                    open_states.push_back(s);
-                    std::push_heap(open_states.begin(), open_states.end(), CompareSearchStatesGt);
-                    closed_states.erase(s->id);
+            if(scratch.IsOpen(target_index)) {
+                if(scratch.G(target_index) > g_value) {
+                    scratch.Improve(target_index, g_value, current);
                 }
             } else {
-                all_search_states.emplace_back(g_value, h_value, target, current_state);
-                open_states.push_back(&all_search_states.back());
-                std::push_heap(open_states.begin(), open_states.end(), CompareSearchStatesGt);
+                scratch.Open(target_index, g_value, h_value, current);
             }
         }
     }
 
-    return path;
+    return corridor;
 }
 
-bool RoutingEngine::IsRoutable(Point p) const
+std::optional<Corridor> RoutingEngine::computeAnyAngleCorridor(
+    Point currentPosition,
+    Point destination,
+    CDT::Face_handle from) const
+{
+    const auto path = anyAngleSearch->ComputePath(currentPosition, destination);
+    if(path.waypoints.empty()) {
+        return std::nullopt;
+    }
+    // The shortest path inside of the triangles it crosses is the path itself, so the funnel
+    // reproduces it with the same clearance at corners as for all other corridors
+    Corridor corridor{destination, {from}, {}};
+    if(!traceFaces(path.waypoints, corridor.faces)) {
+        return std::nullopt;
+    }
+    corridor.waypoints = straightenPath(currentPosition, destination, corridor.faces);
+    return corridor;
+}
+
+std::optional<Corridor> RoutingEngine::computeHierarchicalCorridor(
+    Point currentPosition,
+    Point destination,
+    CDT::Face_handle from,
+    CDT::Face_handle to) const
+{
+    const auto route = portalGraph->ComputeRoute(
+        {currentPosition.x, currentPosition.y},
+        from->get_index(),
+        {destination.x, destination.y},
+        to->get_index());
+    if(route.polygons.empty()) {
+        return std::nullopt;
+    }
+    Corridor corridor{destination, {}, {}};
+    corridor.faces.reserve(route.polygons.size());
+    for(const auto polygon : route.polygons) {
+        corridor.faces.push_back(faces[polygon]);
+    }
+    corridor.waypoints = straightenPath(currentPosition, destination, corridor.faces);
+    return corridor;
+}
+
+bool RoutingEngine::traceFaces(
+    std::span<const Point> path,
+    std::vector<CDT::Face_handle>& corridor) const
+{
+    for(size_t index = 1; index < path.size(); ++index) {
+        const K::Point_2 p{path[index - 1].x, path[index - 1].y};
+        const K::Point_2 q{path[index].x, path[index].y};
+        // Every step adds at least one triangle, the bound only guards against inconsistent
+        // predicates on nearly degenerate triangles
+        for(size_t step = 0; !faceContains(corridor.back(), q); ++step) {
+            if(step > faces.size()) {
+                return false;
+            }
+            const auto face = corridor.back();
+            std::optional<int> exit{};
+            std::optional<int> pivot{};
+            double pivotDistance{};
+            for(int idx = 0; idx < 3; ++idx) {
+                // The segment leaves through the edge opposite 'idx' if the edge end points lie
+                // on different sides of it, seen in CCW order of the face
+                const auto& a = face->vertex(CDT::ccw(idx))->point();
+                const auto& b = face->vertex(CDT::cw(idx))->point();
+                if(CGAL::orientation(p, q, a) == CGAL::RIGHT_TURN &&
+                   CGAL::orientation(p, q, b) == CGAL::LEFT_TURN) {
+                    exit = idx;
+                }
+                // Otherwise it leaves through the vertex furthest along the segment
+                const auto& v = face->vertex(idx)->point();
+                if(CGAL::orientation(p, q, v) == CGAL::COLLINEAR) {
+                    const auto distance = CGAL::to_double(
+                        (v.x() - p.x()) * (q.x() - p.x()) + (v.y() - p.y()) * (q.y() - p.y()));
+                    if(distance >= 0 && (!pivot || distance > pivotDistance)) {
+                        pivot = idx;
+                        pivotDistance = distance;
+                    }
+                }
+            }
+            if(exit) {
+                const auto next = face->neighbor(*exit);
+                if(cdt.is_infinite(next) || !next->get_in_domain()) {
+                    return false;
+                }
+                corridor.push_back(next);
+            } else if(!pivot || !turnAround(face->vertex(*pivot), q, corridor)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool RoutingEngine::turnAround(
+    CDT::Vertex_handle vertex,
+    const K::Point_2& target,
+    std::vector<CDT::Face_handle>& corridor) const
+{
+    const auto& v = vertex->point();
+    // Faces are CCW, so the face spans the wedge from its next to its previous vertex around 'v'
+    const auto opensTowardsTarget = [&](CDT::Face_handle face) {
+        const auto idx = face->index(vertex);
+        return CGAL::orientation(v, face->vertex(CDT::ccw(idx))->point(), target) !=
+                   CGAL::RIGHT_TURN &&
+               CGAL::orientation(v, face->vertex(CDT::cw(idx))->point(), target) !=
+                   CGAL::LEFT_TURN;
+    };
+    const auto start = corridor.back();
+    std::optional<std::vector<CDT::Face_handle>> best{};
+    for(const bool counterclockwise : {true, false}) {
+        std::vector<CDT::Face_handle> walked{};
+        auto face = start;
+        bool blocked{false};
+        while(!opensTowardsTarget(face)) {
+            const auto idx = face->index(vertex);
+            face = face->neighbor(counterclockwise ? CDT::ccw(idx) : CDT::cw(idx));
+            if(face == start || cdt.is_infinite(face) || !face->get_in_domain()) {
+                blocked = true;
+                break;
+            }
+            walked.push_back(face);
+        }
+        if(!blocked && !walked.empty() && (!best || walked.size() < best->size())) {
+            best = std::move(walked);
+        }
+    }
+    if(!best) {
+        return false;
+    }
+    corridor.insert(corridor.end(), best->begin(), best->end());
+    return true;
+}
+
+std::optional<size_t>
+RoutingEngine::LocateInCorridor(const Corridor& corridor, size_t hint, Point position) const
+{
+    const auto p = K::Point_2{position.x, position.y};
+    const auto contains = [&p](CDT::Face_handle face) { return faceContains(face, p); };
+
+    for(size_t index = hint; index < corridor.faces.size(); ++index) {
+        if(contains(corridor.faces[index])) {
+            return index;
+        }
+    }
+    if(hint > 0 && hint <= corridor.faces.size() && contains(corridor.faces[hint - 1])) {
+        return hint - 1;
+    }
+    return std::nullopt;
+}
+
+Point RoutingEngine::NextWaypointInCorridor(
+    const Corridor& corridor,
+    size_t face,
+    Point position) const
+{
+    const auto remaining = std::span<const CDT::Face_handle>(corridor.faces).subspan(face);
+    return straightenPath(position, corridor.destination, remaining, true)[1];
+}
+
+NavigationField RoutingEngine::ComputeNavigationField(Point destination) const
+{
+    const auto to = find_face({destination.x, destination.y});
+
+    NavigationField field{
+        destination,
+        std::vector<double>(faces.size(), std::numeric_limits<double>::infinity()),
+        std::vector<size_t>(faces.size(), NavigationField::InvalidIndex)};
+    // Position through which the shortest path enters each face
+    std::vector<Point> entry(faces.size());
+
+    using QueueEntry = std::pair<double, size_t>;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<>> open{};
+    field.distance[to->get_index()] = 0.0;
+    entry[to->get_index()] = destination;
+    open.emplace(0.0, to->get_index());
+
+    while(!open.empty()) {
+        const auto [distance, index] = open.top();
+        open.pop();
+        if(distance > field.distance[index]) {
+            continue;
+        }
+        const auto face = faces[index];
+        for(int idx = 0; idx < 3; ++idx) {
+            const auto neighbor = face->neighbor(idx);
+            if(!neighbor->get_in_domain()) {
+                continue;
+            }
+            const auto edge = cdt.segment(face, idx);
+            const auto portal_center = Point{
+                CGAL::to_double(edge.source().x() + edge.target().x()) / 2,
+                CGAL::to_double(edge.source().y() + edge.target().y()) / 2};
+            const double neighbor_distance = distance + Distance(entry[index], portal_center);
+            const auto neighbor_index = neighbor->get_index();
+            if(neighbor_distance < field.distance[neighbor_index]) {
+                field.distance[neighbor_index] = neighbor_distance;
+                field.next[neighbor_index] = index;
+                entry[neighbor_index] = portal_center;
+                open.emplace(neighbor_distance, neighbor_index);
+            }
+        }
+    }
+    return field;
+}
+
+Corridor RoutingEngine::ComputeCorridor(
+    const NavigationField& field,
+    Point currentPosition,
+    size_t currentHint) const
+{
+    auto index = Locate(currentPosition, currentHint);
+    if(field.distance[index] == std::numeric_limits<double>::infinity()) {
+        return Corridor{field.destination, {}, {}};
+    }
+
+    Corridor corridor{field.destination, {faces[index]}, {}};
+    while(field.next[index] != NavigationField::InvalidIndex) {
+        index = field.next[index];
+        corridor.faces.push_back(faces[index]);
+    }
+    corridor.waypoints = straightenPath(currentPosition, field.destination, corridor.faces);
+    return corridor;
+}
+
+size_t RoutingEngine::Locate(Point position, size_t hint) const
+{
+    return find_face({position.x, position.y}, hint)->get_index();
+}
+
+bool RoutingEngine::IsRoutable(Point p, size_t hint) const
 {
     try {
-        find_face({p.x, p.y});
+        find_face({p.x, p.y}, hint);
     } catch(const SimulationError&) {
         return false;
     }
     return true;
 }
 
-void RoutingEngine::Update()
+template <typename Change>
+AABB RoutingEngine::changeTriangulation(Change&& change)
 {
+    // Vertices and domain of a finite face
+    using FaceState = std::tuple<K::Point_2, K::Point_2, K::Point_2, bool>;
+    const auto stateOf = [](CDT::Face_handle face) {
+        return FaceState{
+            face->vertex(0)->point(),
+            face->vertex(1)->point(),
+            face->vertex(2)->point(),
+            face->get_in_domain()};
+    };
+    std::unordered_map<CDT::Face_handle, FaceState> before{};
+    before.reserve(cdt.number_of_faces());
+    for(const CDT::Face_handle face : cdt.finite_face_handles()) {
+        before.emplace(face, stateOf(face));
+    }
+
+    change();
+    CGAL::mark_domain_in_triangulation(cdt);
+
+    AABB bounds{};
+    for(const CDT::Face_handle face : cdt.finite_face_handles()) {
+        const auto old = before.find(face);
+        if(old != before.end() && old->second == stateOf(face)) {
+            continue;
+        }
+        for(int idx = 0; idx < 3; ++idx) {
+            const auto& p = face->vertex(idx)->point();
+            bounds.Extend(Point{CGAL::to_double(p.x()), CGAL::to_double(p.y())});
+        }
+    }
+    indexFaces();
+    mesh.reset();
+    updateSearchStructures();
+    return bounds;
 }
 
-CDT::Face_handle RoutingEngine::find_face(K::Point_2 p) const
+AABB RoutingEngine::AddObstacle(const Poly& obstacle)
 {
-    const auto face = cdt.locate(p);
+    // The obstacle is a hole of the routable area once its boundary is constrained
+    return changeTriangulation([this, &obstacle]() {
+        std::vector<CDT::Vertex_handle> vertices{};
+        vertices.reserve(obstacle.size());
+        for(auto iter = obstacle.vertices_begin(); iter != obstacle.vertices_end(); ++iter) {
+            vertices.push_back(cdt.insert(*iter));
+        }
+        for(size_t index = 0; index < vertices.size(); ++index) {
+            cdt.insert_constraint(vertices[index], vertices[(index + 1) % vertices.size()]);
+        }
+    });
+}
+
+AABB RoutingEngine::RemoveObstacle(const Poly& obstacle)
+{
+    std::vector<CDT::Vertex_handle> vertices{};
+    vertices.reserve(obstacle.size());
+    for(auto iter = obstacle.vertices_begin(); iter != obstacle.vertices_end(); ++iter) {
+        CDT::Locate_type type{};
+        int vertexIndex{};
+        const auto face = cdt.locate(*iter, type, vertexIndex);
+        if(type != CDT::VERTEX) {
+            throw SimulationError("Obstacle is not part of the routable area");
+        }
+        vertices.push_back(face->vertex(vertexIndex));
+    }
+    const auto constrainedEdge = [this, &vertices](size_t index) -> std::optional<CDT::Edge> {
+        CDT::Face_handle face{};
+        int edgeIndex{};
+        const auto next = vertices[(index + 1) % vertices.size()];
+        if(!cdt.is_edge(vertices[index], next, face, edgeIndex) ||
+           !cdt.is_constrained({face, edgeIndex})) {
+            return std::nullopt;
+        }
+        return CDT::Edge{face, edgeIndex};
+    };
+    for(size_t index = 0; index < vertices.size(); ++index) {
+        if(!constrainedEdge(index)) {
+            throw SimulationError("Obstacle is not part of the routable area");
+        }
+    }
+
+    return changeTriangulation([this, &vertices, &constrainedEdge]() {
+        // Removing a constraint flips faces, so each edge is looked up again
+        for(size_t index = 0; index < vertices.size(); ++index) {
+            const auto [face, edgeIndex] = *constrainedEdge(index);
+            cdt.remove_constrained_edge(face, edgeIndex);
+        }
+        for(const auto vertex : vertices) {
+            cdt.remove(vertex);
+        }
+    });
+}
+
+void RoutingEngine::indexFaces()
+{
+    faces.clear();
+    for(const CDT::Face_handle face : cdt.finite_face_handles()) {
+        if(face->get_in_domain()) {
+            face->set_index(faces.size());
+            faces.push_back(face);
+        }
+    }
+}
+
+void RoutingEngine::updateSearchStructures()
+{
+    anyAngleSearch.reset();
+    portalGraph.reset();
+    if(algorithm == RoutingAlgorithm::AnyAngle) {
+        Mesh navigationMesh(cdt);
+        navigationMesh.MergeGreedy();
+        anyAngleSearch = std::make_unique<AnyAngleSearch>(std::move(navigationMesh));
+    } else if(algorithm == RoutingAlgorithm::Hierarchical) {
+        // The unmerged mesh lists the in-domain faces in the same order as 'indexFaces'
+        portalGraph = std::make_unique<PortalGraph>(Mesh(cdt), threadCount);
+    }
+}
+
+CDT::Face_handle RoutingEngine::find_face(K::Point_2 p, size_t hint) const
+{
+    CDT::Face_handle face{};
+    if(hint < faces.size()) {
+        const auto start = faces[hint];
+        if(faceContains(start, p)) {
+            return start;
+        }
+        for(int idx = 0; idx < 3; ++idx) {
+            const auto neighbor = start->neighbor(idx);
+            if(!cdt.is_infinite(neighbor) && neighbor->get_in_domain() &&
+               faceContains(neighbor, p)) {
+                return neighbor;
+            }
+        }
+        face = cdt.locate(p, start);
+    } else {
+        face = cdt.locate(p);
+    }
     if(face == nullptr || cdt.is_infinite(face) || !face->get_in_domain()) {
         throw SimulationError(
             "Point ({}, {}) is outside of accessible area",
@@ -293,8 +865,11 @@ CDT::Face_handle RoutingEngine::find_face(K::Point_2 p) const
     return face;
 }
 
-std::vector<Point>
-RoutingEngine::straightenPath(Point from, Point to, const std::vector<CDT::Face_handle>& path)
+std::vector<Point> RoutingEngine::straightenPath(
+    Point from,
+    Point to,
+    std::span<const CDT::Face_handle> path,
+    bool firstCornerOnly) const
 {
     // TODO(kkratz): Remove the 0.2m edge width adjustment and replace this with p[roper
     // arc-paths from the "Efficient Triangulation-Based Pathfinding" publication
@@ -344,6 +919,9 @@ RoutingEngine::straightenPath(Point from, Point to, const std::vector<CDT::Face_
                 index_right = index_portal;
             } else {
                 waypoints.emplace_back(portal_left);
+                if(firstCornerOnly) {
+                    return waypoints;
+                }
                 apex = portal_left;
                 index_apex = index_left;
                 portal_left = apex;
@@ -360,6 +938,9 @@ RoutingEngine::straightenPath(Point from, Point to, const std::vector<CDT::Face_
                 index_left = index_portal;
             } else {
                 waypoints.emplace_back(portal_right);
+                if(firstCornerOnly) {
+                    return waypoints;
+                }
                 apex = portal_right;
                 index_apex = index_right;
                 portal_left = apex;
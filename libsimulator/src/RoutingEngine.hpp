@@ -1,25 +1,97 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #pragma once
 
+#include "AABB.hpp"
+#include "AnyAngleSearch.hpp"
 #include "CfgCgal.hpp"
 #include "Clonable.hpp"
 #include "Mesh.hpp"
 #include "Point.hpp"
+#include "PortalGraph.hpp"
 
 #include <cstddef>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <span>
 #include <variant>
 #include <vector>
 
 using LocationID = size_t;
 using Location = std::variant<Point, LocationID>;
 
+/// Sequence of adjacent triangles leading from a start position to a destination.
+struct Corridor {
+    /// Destination this corridor leads to
+    Point destination{};
+    /// Triangles from the one containing the start position to the one containing the destination
+    std::vector<CDT::Face_handle> faces{};
+    /// Straightened path through 'faces' starting at the start position
+    std::vector<Point> waypoints{};
+};
+
+/// Approximated shortest distances from all triangles of a RoutingEngine to one destination.
+/// A field is computed once and can then be used to create corridors for any number of agents
+/// heading to the same destination without running a search per agent. Distances are measured
+/// along edge midpoints, corridors from a field may therefore differ from the corridors of the
+/// A* search.
+struct NavigationField {
+    static constexpr size_t InvalidIndex{std::numeric_limits<size_t>::max()};
+    /// Destination all distances are measured to
+    Point destination{};
+    /// Walking distance to 'destination' per triangle, measured along portal midpoints
+    std::vector<double> distance{};
+    /// Adjacent triangle on the shortest path to 'destination' per triangle
+    std::vector<size_t> next{};
+};
+
+/// Results of 'RoutingEngine::ComputeBatch' in flat arrays, one entry per query.
+struct RoutingBatch {
+    /// Length of the path per query, infinity if origin or destination is not routable or the
+    /// destination cannot be reached
+    std::vector<double> lengths{};
+    /// Waypoints of query i are 'waypoints[offsets[i]]' up to 'waypoints[offsets[i + 1]]'
+    /// exclusive. Both are empty unless waypoints were requested.
+    std::vector<Point> waypoints{};
+    std::vector<size_t> offsets{};
+};
+
+/// Search used by 'RoutingEngine::ComputeCorridor' to select the triangles of a corridor.
+enum class RoutingAlgorithm {
+    /// A* over the triangles, stops once no other sequence of triangles can lead to a shorter
+    /// straightened path than the best one found
+    Triangulation,
+    /// Any-angle search over the triangles merged into convex polygons, the corridor contains the
+    /// Euclidean shortest path, see 'AnyAngleSearch'
+    AnyAngle,
+    /// Coarse search over the portals between clusters of triangles followed by a local search
+    /// per cluster, see 'PortalGraph'. Query time grows with the length of the path instead of
+    /// the size of the geometry, corridors are close to but not always the shortest ones
+    Hierarchical
+};
+
 class RoutingEngine : public Clonable<RoutingEngine>
 {
     CDT cdt{};
-    std::unique_ptr<Mesh> mesh{};
+    /// Built on first access, changes of the triangulation drop it
+    mutable std::unique_ptr<Mesh> mesh{};
+    /// All in-domain faces of 'cdt' ordered by their index
+    std::vector<CDT::Face_handle> faces{};
+    RoutingAlgorithm algorithm{RoutingAlgorithm::Triangulation};
+    /// Number of threads used to build the search structures of 'algorithm'
+    size_t threadCount{1};
+    /// Only exists for 'RoutingAlgorithm::AnyAngle', rebuilt with every change of the triangulation
+    std::unique_ptr<AnyAngleSearch> anyAngleSearch{};
+    /// Only exists for 'RoutingAlgorithm::Hierarchical', rebuilt with every change of the
+    /// triangulation. Polygon i of its mesh is the face with index i.
+    std::unique_ptr<PortalGraph> portalGraph{};
+
+    friend class GeometryCache;
 
 public:
+    /// Face hint that makes 'Locate' search without a start triangle.
+    static constexpr size_t NoFaceHint{std::numeric_limits<size_t>::max()};
+
     RoutingEngine();
     explicit RoutingEngine(const PolyWithHoles& poly);
     ~RoutingEngine() override = default;
@@ -31,15 +103,114 @@ public:
     RoutingEngine& operator=(RoutingEngine&& other) = default;
 
     std::unique_ptr<RoutingEngine> Clone() const override;
+    /// Selects the search used by 'ComputeCorridor'. Selecting 'RoutingAlgorithm::AnyAngle'
+    /// builds the merged navigation mesh, which takes time proportional to the triangle count.
+    /// Selecting 'RoutingAlgorithm::Hierarchical' precomputes the portal graph on 'newThreadCount'
+    /// threads, the same number is used to rebuild it after changes of the routable area.
+    void SetAlgorithm(RoutingAlgorithm newAlgorithm, size_t newThreadCount = 1);
+    RoutingAlgorithm Algorithm() const;
     Point ComputeWaypoint(Point currentPosition, Point destination);
     std::vector<Point> ComputeAllWaypoints(Point currentPosition, Point destination);
-    bool IsRoutable(Point p) const;
-    void Update();
+    Corridor ComputeCorridor(Point currentPosition, Point destination);
+    /// Same as 'ComputeCorridor(currentPosition, destination)' but locates both positions starting
+    /// at the triangles with index 'currentHint' and 'destinationHint', see 'Locate'.
+    Corridor ComputeCorridor(
+        Point currentPosition,
+        Point destination,
+        size_t currentHint,
+        size_t destinationHint);
+    /// Computes the paths from 'origins[i]' to 'destinations[i]' for all i on 'threadCount'
+    /// threads. Pairs with a position outside of the routable area get an infinite length and no
+    /// waypoints instead of failing the whole batch. The result does not depend on the number of
+    /// threads.
+    RoutingBatch ComputeBatch(
+        std::span<const Point> origins,
+        std::span<const Point> destinations,
+        size_t threadCount,
+        bool withWaypoints);
+    NavigationField ComputeNavigationField(Point destination) const;
+    /// Creates the corridor from 'currentPosition' to the destination of 'field' by following the
+    /// field. Returns an empty corridor if the destination cannot be reached.
+    /// 'currentHint' is passed on to 'Locate'.
+    Corridor ComputeCorridor(
+        const NavigationField& field,
+        Point currentPosition,
+        size_t currentHint = NoFaceHint) const;
+    /// Returns the index of the triangle containing 'position'.
+    /// The search checks the triangle with index 'hint' and its neighbors first and otherwise
+    /// walks from there, so a hint close to 'position' makes the lookup constant time. Any
+    /// index is accepted as hint, stale or invalid hints only make the lookup slower.
+    /// Throws if 'position' is outside of the routable area.
+    size_t Locate(Point position, size_t hint = NoFaceHint) const;
+    /// Finds the triangle of 'corridor' containing 'position'.
+    /// The search starts at 'hint' and only walks forward, except for the triangle directly before
+    /// 'hint'. Returns nothing if 'position' is not inside the remaining corridor.
+    std::optional<size_t>
+    LocateInCorridor(const Corridor& corridor, size_t hint, Point position) const;
+    /// Computes the next waypoint from 'position' located in triangle 'face' of 'corridor'.
+    /// Only the funnel up to the first corner is evaluated.
+    Point NextWaypointInCorridor(const Corridor& corridor, size_t face, Point position) const;
+    /// Returns true if 'p' is inside the routable area, 'hint' is passed on to 'Locate'.
+    bool IsRoutable(Point p, size_t hint = NoFaceHint) const;
+
+    /// Excludes 'obstacle' from the routable area. 'obstacle' has to lie strictly inside of the
+    /// routable area, i.e. it may not touch any boundary.
+    /// Only the triangles around 'obstacle' are changed, corridors and navigation fields that do
+    /// not touch the returned bounds of all changed triangles stay valid. The search structures of
+    /// 'RoutingAlgorithm::AnyAngle' and 'RoutingAlgorithm::Hierarchical' are rebuilt for the whole
+    /// routable area, which costs as much as selecting the algorithm again.
+    AABB AddObstacle(const Poly& obstacle);
+    /// Reverts 'AddObstacle(obstacle)' and returns the bounds of all changed triangles. Rebuilds
+    /// the search structures like 'AddObstacle'.
+    AABB RemoveObstacle(const Poly& obstacle);
 
-    const Mesh* MeshData() const { return mesh.get(); };
+    /// Returns the triangulation merged into convex polygons, built on first access after each
+    /// change of the routable area. Not safe to call concurrently.
+    const Mesh* MeshData() const;
 
 private:
-    CDT::Face_handle find_face(K::Point_2) const;
-    std::vector<Point>
-    straightenPath(Point from, Point to, const std::vector<CDT::Face_handle>& path);
+    /// Applies 'change' to the triangulation, determines the domain of all faces again, indexes
+    /// them and drops the mesh. Returns the bounds of all faces whose vertices or domain changed.
+    /// CGAL reuses faces in place on insertions and flips, so faces are compared by their
+    /// vertices instead of their handles.
+    template <typename Change>
+    AABB changeTriangulation(Change&& change);
+    void indexFaces();
+    /// Builds the search structures needed by 'algorithm' and drops all others.
+    void updateSearchStructures();
+    /// A* over the triangles from 'from' containing 'currentPosition' to 'to' containing
+    /// 'destination'.
+    Corridor computeTriangleCorridor(
+        Point currentPosition,
+        Point destination,
+        CDT::Face_handle from,
+        CDT::Face_handle to);
+    /// Corridor along the path found by 'anyAngleSearch', nothing if the search fails or the
+    /// path cannot be traced through the triangulation.
+    std::optional<Corridor>
+    computeAnyAngleCorridor(Point currentPosition, Point destination, CDT::Face_handle from) const;
+    /// Corridor through the triangles found by 'portalGraph', nothing if the search fails.
+    std::optional<Corridor> computeHierarchicalCorridor(
+        Point currentPosition,
+        Point destination,
+        CDT::Face_handle from,
+        CDT::Face_handle to) const;
+    /// Appends the triangles crossed by the polyline 'path' to 'corridor', the last triangle of
+    /// 'corridor' has to contain the first point of 'path'. Returns false if the polyline leaves
+    /// the routable area.
+    bool traceFaces(std::span<const Point> path, std::vector<CDT::Face_handle>& corridor) const;
+    /// Appends the triangles around 'vertex' from the last triangle of 'corridor' up to the first
+    /// one that contains the start of the segment from 'vertex' to 'target'. Walks around 'vertex'
+    /// in the direction that stays inside of the routable area and passes fewer triangles.
+    /// Returns false if no such direction exists.
+    bool turnAround(
+        CDT::Vertex_handle vertex,
+        const K::Point_2& target,
+        std::vector<CDT::Face_handle>& corridor) const;
+    CDT::Face_handle find_face(K::Point_2 p, size_t hint = NoFaceHint) const;
+    std::vector<Point> straightenPath(
+        Point from,
+        Point to,
+        std::span<const CDT::Face_handle> path,
+        bool firstCornerOnly = false) const;
 };
@@ -1,11 +1,13 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #include "Simulation.hpp"
 
+#include "AABB.hpp"
 #include "CollisionGeometry.hpp"
 #include "GeneralizedCentrifugalForceModelData.hpp"
 #include "GenericAgent.hpp"
 #include "IteratorPair.hpp"
 #include "Journey.hpp"
+#include "Obstacle.hpp"
 #include "OperationalModel.hpp"
 #include "OperationalModelType.hpp"
 #include "Point.hpp"
@@ -15,6 +17,7 @@
 #include "SimulationError.hpp"
 #include "Stage.hpp"
 #include "StageDescription.hpp"
+#include "ThreadPool.hpp"
 #include "Tracing.hpp"
 #include "Visitor.hpp"
 
@@ -33,12 +36,28 @@
 Simulation::Simulation(
     std::unique_ptr<OperationalModel>&& operationalModel,
     std::unique_ptr<CollisionGeometry>&& geometry,
-    double dT)
+    double dT,
+    size_t threadCount,
+    double neighborListSkin,
+    RoutingAlgorithm routingAlgorithm,
+    bool useNavigationFields)
     : _clock(dT)
+    , _tacticalDecisionSystem(useNavigationFields)
     , _operationalDecisionSystem(std::move(operationalModel))
+    , _neighborhoodSearch(2.2, AABB(std::get<0>(geometry->AccessibleArea())))
     , _geometry(std::move(geometry))
-    , _routingEngine(std::make_unique<RoutingEngine>(_geometry->Polygon()))
+    , _routingEngine(_geometry->CreateRoutingEngine())
+    , _threadPool(threadCount)
+    , _neighborListSkin(neighborListSkin)
 {
+    if(neighborListSkin < 0) {
+        throw SimulationError("Neighbor list skin must not be negative, got {}", neighborListSkin);
+    }
+    if(neighborListSkin > 0) {
+        _neighborhoodSearch.EnableVerletLists(
+            _operationalDecisionSystem.NeighborhoodRadius(), neighborListSkin);
+    }
+    _routingEngine->SetAlgorithm(routingAlgorithm, threadCount);
 }
 
 const SimulationClock& Simulation::Clock() const
@@ -61,7 +80,8 @@ void Simulation::Iterate()
 
     {
         JPS_SCOPED_TIMER_AND_TRACE(_timer, "Agent Removal System", Detailed);
-        _agentRemovalSystem.Run(_agents, _removedAgentsInLastIteration, _stageManager);
+        _tacticalDecisionSystem.RemoveAgents(_removedAgentsInLastIteration);
+        _agentRemovalSystem.Run(_agents, _removedAgentsInLastIteration, _stageManager, _agentIndex);
     }
 
     {
@@ -81,13 +101,21 @@ void Simulation::Iterate()
 
     {
         JPS_SCOPED_TIMER_AND_TRACE(_timer, "Tactical Decision System", General);
+        _tacticalDecisionSystem.UpdateNavigationFields(*_routingEngine, _agents);
         _tacticalDecisionSystem.Run(*_routingEngine, _agents);
     }
 
     {
         JPS_SCOPED_TIMER_AND_TRACE(_timer, "Operational Decision System", General);
         _operationalDecisionSystem.Run(
-            _clock.dT(), _clock.ElapsedTime(), _neighborhoodSearch, *_geometry, _agents);
+            _clock.dT(),
+            _clock.ElapsedTime(),
+            _neighborhoodSearch,
+            *_geometry,
+            _agents,
+            _threadPool);
+        // Range queries until the next iteration see the new positions
+        _neighborhoodSearch.RefreshPositions(_agents);
     }
     _clock.Advance();
 }
@@ -207,6 +235,49 @@ BaseStage::ID Simulation::AddStage(const StageDescription stageDescription)
     return _stageManager.AddStage(stageDescription, _removedAgentsInLastIteration);
 }
 
+Obstacle::ID Simulation::AddObstacle(const std::vector<Point>& polygon)
+{
+    JPS_SCOPED_TIMER_AND_TRACE(_timer, "Add Obstacle", Detailed);
+    const Polygon obstacle(polygon);
+    for(const auto& agent : _agents) {
+        if(obstacle.IsInside(agent.pos) || obstacle.IsInside(agent.target)) {
+            throw SimulationError("Obstacle covers agent {} or its target", agent.id);
+        }
+    }
+    for(const auto& [id, stage] : _stageManager.Stages()) {
+        if(stage->IsCoveredBy(obstacle)) {
+            throw SimulationError("Obstacle covers stage {}", id);
+        }
+    }
+
+    auto geometry = std::make_shared<const CollisionGeometry>(_geometry->WithObstacle(obstacle));
+    // Adding an obstacle makes no route shorter, routes around the obstacle stay valid
+    _tacticalDecisionSystem.Invalidate(_routingEngine->AddObstacle(obstacle));
+    _geometry = std::move(geometry);
+    ++_geometryGeneration;
+    _obstacles.push_back({Obstacle::ID{}, obstacle});
+    return _obstacles.back().id;
+}
+
+void Simulation::RemoveObstacle(Obstacle::ID id)
+{
+    JPS_SCOPED_TIMER_AND_TRACE(_timer, "Remove Obstacle", Detailed);
+    const auto iter = std::find_if(
+        std::begin(_obstacles), std::end(_obstacles), [id](const auto& o) { return o.id == id; });
+    if(iter == std::end(_obstacles)) {
+        throw SimulationError("Unknown obstacle id: {}", id);
+    }
+
+    auto geometry = std::make_shared<const CollisionGeometry>(
+        _geometry->WithoutObstacle(iter->polygon));
+    _routingEngine->RemoveObstacle(iter->polygon);
+    // The freed area may shorten routes that never touched the obstacle
+    _tacticalDecisionSystem.Invalidate();
+    _geometry = std::move(geometry);
+    ++_geometryGeneration;
+    _obstacles.erase(iter);
+}
+
 GenericAgent::ID Simulation::AddAgent(GenericAgent agent)
 {
     JPS_SCOPED_TIMER_AND_TRACE(_timer, "Add Agent", Detailed);
@@ -234,6 +305,7 @@ GenericAgent::ID Simulation::AddAgent(GenericAgent agent)
 
     _stageManager.HandleNewAgent(agent.stageId);
     _agents.emplace_back(std::move(agent));
+    _agentIndex.Set(_agents.back().id, _agents.size() - 1);
     _neighborhoodSearch.AddAgent(_agents.back());
 
     auto v = IteratorPair(std::prev(std::end(_agents)), std::end(_agents));
@@ -245,9 +317,7 @@ GenericAgent::ID Simulation::AddAgent(GenericAgent agent)
 void Simulation::MarkAgentForRemoval(GenericAgent::ID id)
 {
     JPS_TRACE_FUNC;
-    const auto iter = std::find_if(
-        std::begin(_agents), std::end(_agents), [id](auto& agent) { return agent.id == id; });
-    if(iter == std::end(_agents)) {
+    if(!_agentIndex.Contains(id)) {
         throw SimulationError("Unknown agent id {}", id);
     }
 
@@ -257,23 +327,21 @@ void Simulation::MarkAgentForRemoval(GenericAgent::ID id)
 const GenericAgent& Simulation::Agent(GenericAgent::ID id) const
 {
     JPS_TRACE_FUNC;
-    const auto iter =
-        std::find_if(_agents.begin(), _agents.end(), [id](auto& ped) { return id == ped.id; });
-    if(iter == _agents.end()) {
+    const auto position = _agentIndex.Find(id);
+    if(!position) {
         throw SimulationError("Trying to access unknown Agent {}", id);
     }
-    return *iter;
+    return _agents[*position];
 }
 
 GenericAgent& Simulation::Agent(GenericAgent::ID id)
 {
     JPS_TRACE_FUNC;
-    const auto iter =
-        std::find_if(_agents.begin(), _agents.end(), [id](auto& ped) { return id == ped.id; });
-    if(iter == _agents.end()) {
+    const auto position = _agentIndex.Find(id);
+    if(!position) {
         throw SimulationError("Trying to access unknown Agent {}", id);
     }
-    return *iter;
+    return _agents[*position];
 }
 
 const std::vector<GenericAgent::ID>& Simulation::RemovedAgents() const
@@ -291,6 +359,26 @@ double Simulation::DT() const
     return _clock.dT();
 }
 
+size_t Simulation::ThreadCount() const
+{
+    return _threadPool.ThreadCount();
+}
+
+double Simulation::NeighborListSkin() const
+{
+    return _neighborListSkin;
+}
+
+RoutingAlgorithm Simulation::Routing() const
+{
+    return _routingEngine->Algorithm();
+}
+
+bool Simulation::UsesNavigationFields() const
+{
+    return _tacticalDecisionSystem.UsesNavigationFields();
+}
+
 uint64_t Simulation::Iteration() const
 {
     return _clock.Iteration();
@@ -329,15 +417,9 @@ void Simulation::SwitchAgentJourney(
 std::vector<GenericAgent::ID> Simulation::AgentsInRange(Point p, double distance)
 {
     JPS_SCOPED_TIMER_AND_TRACE(_timer, "Agents in Range", Debug);
-    const auto neighbors = _neighborhoodSearch.GetNeighboringAgents(p, distance);
-
     std::vector<GenericAgent::ID> neighborIds{};
-    neighborIds.reserve(neighbors.size());
-    std::transform(
-        std::begin(neighbors),
-        std::end(neighbors),
-        std::back_inserter(neighborIds),
-        [](const auto& agent) { return agent.id; });
+    _neighborhoodSearch.ForEachNeighboringAgent(
+        p, distance, [&neighborIds](const auto& agent) { neighborIds.push_back(agent.id); });
     return neighborIds;
 }
 
@@ -350,15 +432,12 @@ std::vector<GenericAgent::ID> Simulation::AgentsInPolygon(const std::vector<Poin
     }
     const auto [p, dist] = poly.ContainingCircle();
 
-    const auto candidates = _neighborhoodSearch.GetNeighboringAgents(p, dist);
     std::vector<GenericAgent::ID> result{};
-    result.reserve(candidates.size());
-    std::for_each(
-        std::begin(candidates), std::end(candidates), [&result, &poly](const auto& agent) {
-            if(poly.IsInside(agent.pos)) {
-                result.push_back(agent.id);
-            }
-        });
+    _neighborhoodSearch.ForEachNeighboringAgent(p, dist, [&result, &poly](const auto& agent) {
+        if(poly.IsInside(agent.pos)) {
+            result.push_back(agent.id);
+        }
+    });
     return result;
 }
 
@@ -371,9 +450,14 @@ StageProxy Simulation::Stage(BaseStage::ID stageId)
 {
     return _stageManager.Stage(stageId)->Proxy(this);
 }
-CollisionGeometry Simulation::Geo() const
+std::shared_ptr<const CollisionGeometry> Simulation::Geo() const
+{
+    return _geometry;
+}
+
+uint64_t Simulation::GeometryGeneration() const
 {
-    return *_geometry;
+    return _geometryGeneration;
 }
 
 void Simulation::PushTimer(const std::string_view name, size_t probe_log_level)
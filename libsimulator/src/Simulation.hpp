@@ -1,11 +1,13 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #pragma once
 
+#include "AgentIndex.hpp"
 #include "AgentRemovalSystem.hpp"
 #include "CollisionGeometry.hpp"
 #include "GenericAgent.hpp"
 #include "Journey.hpp"
 #include "NeighborhoodSearch.hpp"
+#include "Obstacle.hpp"
 #include "OperationalDecisionSystem.hpp"
 #include "OperationalModel.hpp"
 #include "OperationalModelType.hpp"
@@ -18,6 +20,7 @@
 #include "StageSystem.hpp"
 #include "StrategicalDesicionSystem.hpp"
 #include "TacticalDecisionSystem.hpp"
+#include "ThreadPool.hpp"
 #include "Timing.hpp"
 #include "Tracing.hpp"
 
@@ -33,17 +36,22 @@ class Simulation
 {
     SimulationClock _clock;
     StrategicalDecisionSystem _stategicalDecisionSystem{};
-    TacticalDecisionSystem _tacticalDecisionSystem{};
+    TacticalDecisionSystem _tacticalDecisionSystem;
     OperationalDecisionSystem _operationalDecisionSystem;
     AgentRemovalSystem<GenericAgent> _agentRemovalSystem{};
     StageManager _stageManager{};
     StageSystem _stageSystem{};
-    NeighborhoodSearch<GenericAgent> _neighborhoodSearch{2.2};
-    std::unique_ptr<CollisionGeometry> _geometry{};
+    NeighborhoodSearch<GenericAgent> _neighborhoodSearch;
+    std::shared_ptr<const CollisionGeometry> _geometry{};
+    uint64_t _geometryGeneration{0};
+    std::vector<Obstacle> _obstacles{};
     std::unique_ptr<RoutingEngine> _routingEngine{};
     AgentContainer<GenericAgent> _agents;
+    AgentIndex _agentIndex{};
     std::vector<GenericAgent::ID> _removedAgentsInLastIteration;
     std::unordered_map<Journey::ID, std::unique_ptr<Journey>> _journeys;
+    ThreadPool _threadPool;
+    double _neighborListSkin;
     Timer _timer{};
     enum LogLevel { General = 1, Detailed = 2, Debug = 3 };
 
@@ -51,7 +59,11 @@ public:
     Simulation(
         std::unique_ptr<OperationalModel>&& operationalModel,
         std::unique_ptr<CollisionGeometry>&& geometry,
-        double dT);
+        double dT,
+        size_t threadCount = 1,
+        double neighborListSkin = 0.0,
+        RoutingAlgorithm routingAlgorithm = RoutingAlgorithm::Triangulation,
+        bool useNavigationFields = false);
     Simulation(const Simulation& other) = delete;
     Simulation& operator=(const Simulation& other) = delete;
     Simulation(Simulation&& other) = delete;
@@ -62,11 +74,27 @@ public:
     void Iterate();
     Journey::ID AddJourney(const std::map<BaseStage::ID, TransitionDescription>& stages);
     BaseStage::ID AddStage(const StageDescription stageDescription);
+    /// Excludes 'polygon' from the accessible area until the obstacle is removed again.
+    /// The obstacle has to lie strictly inside of the accessible area and may neither cover an
+    /// agent, its current target nor any waypoint, exit, waiting set or queue slot. Only the
+    /// geometry and routing data around the obstacle is updated, except for the any-angle and
+    /// hierarchical routing algorithms which rebuild their search structures for the whole
+    /// geometry.
+    Obstacle::ID AddObstacle(const std::vector<Point>& polygon);
+    /// Gives the area of an obstacle added with 'AddObstacle' back to the accessible area.
+    void RemoveObstacle(Obstacle::ID id);
     void MarkAgentForRemoval(GenericAgent::ID id);
     const std::vector<GenericAgent::ID>& RemovedAgents() const;
     size_t AgentCount() const;
     double ElapsedTime() const;
     double DT() const;
+    size_t ThreadCount() const;
+    /// Returns the skin of the cached neighbor lists or 0 if they are not used.
+    double NeighborListSkin() const;
+    /// Returns the search used to route agents to their targets.
+    RoutingAlgorithm Routing() const;
+    /// Returns true if agents heading to the same target share navigation fields.
+    bool UsesNavigationFields() const;
     void
     SwitchAgentJourney(GenericAgent::ID agent_id, Journey::ID journey_id, BaseStage::ID stage_id);
     uint64_t Iteration() const;
@@ -80,7 +108,11 @@ public:
     AgentContainer<GenericAgent>& Agents();
     OperationalModelType ModelType() const;
     StageProxy Stage(BaseStage::ID stageId);
-    CollisionGeometry Geo() const;
+    /// Returns the current geometry. The geometry is never modified in place, changes replace it
+    /// with a new instance, so the returned handle stays valid and unchanged.
+    std::shared_ptr<const CollisionGeometry> Geo() const;
+    /// Returns a counter that is incremented whenever the geometry is replaced.
+    uint64_t GeometryGeneration() const;
     void PushTimer(const std::string_view name, size_t probe_log_level = 0);
     void PopTimer(const std::string_view name);
     void SetTimerLogLevel(int level) { _timer.setLogLevel(level); };
@@ -97,6 +97,11 @@ Point Waypoint::Target(const GenericAgent&)
     return position;
 }
 
+bool Waypoint::IsCoveredBy(const Polygon& area) const
+{
+    return area.IsInside(position);
+}
+
 StageProxy Waypoint::Proxy(Simulation* simulation)
 {
     return WaypointProxy(simulation, this);
@@ -127,6 +132,12 @@ Point Exit::Target(const GenericAgent&)
     return area.Centroid();
 }
 
+bool Exit::IsCoveredBy(const Polygon& coveringArea) const
+{
+    // An exit only touching 'coveringArea' can still be entered through its interior
+    return coveringArea.Overlaps(area);
+}
+
 StageProxy Exit::Proxy(Simulation* simulation)
 {
     return ExitProxy(simulation, this);
@@ -186,6 +197,12 @@ WaitingSetState NotifiableWaitingSet::State() const
     return state;
 }
 
+bool NotifiableWaitingSet::IsCoveredBy(const Polygon& area) const
+{
+    return std::any_of(
+        std::begin(slots), std::end(slots), [&area](const auto& p) { return area.IsInside(p); });
+}
+
 StageProxy NotifiableWaitingSet::Proxy(Simulation* simulation)
 {
     return NotifiableWaitingSetProxy(simulation, this);
@@ -234,6 +251,12 @@ void NotifiableQueue::Pop(size_t count)
     }
 }
 
+bool NotifiableQueue::IsCoveredBy(const Polygon& area) const
+{
+    return std::any_of(
+        std::begin(slots), std::end(slots), [&area](const auto& p) { return area.IsInside(p); });
+}
+
 StageProxy NotifiableQueue::Proxy(Simulation* simulation)
 {
     return NotifiableQueueProxy(simulation, this);
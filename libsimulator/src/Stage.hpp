@@ -114,6 +114,8 @@ public:
     virtual bool IsCompleted(const GenericAgent& agent) = 0;
     virtual Point Target(const GenericAgent& agent) = 0;
     virtual StageProxy Proxy(Simulation* simulation_) = 0;
+    /// Returns true if 'area' covers any position this stage sends agents to.
+    virtual bool IsCoveredBy(const Polygon& area) const = 0;
     ID Id() const { return id; }
     size_t CountTargeting() const { return targeting; }
     void IncreaseTargeting() { targeting = targeting + 1; }
@@ -147,6 +149,7 @@ public:
     bool IsCompleted(const GenericAgent& agent) override;
     Point Target(const GenericAgent& agent) override;
     StageProxy Proxy(Simulation* simulation_) override;
+    bool IsCoveredBy(const Polygon& area) const override;
     Point Position() const { return position; };
 };
 
@@ -162,6 +165,7 @@ public:
     bool IsCompleted(const GenericAgent& agent) override;
     Point Target(const GenericAgent& agent) override;
     StageProxy Proxy(Simulation* simulation_) override;
+    bool IsCoveredBy(const Polygon& area) const override;
     Polygon Position() const { return area; };
 };
 
@@ -177,6 +181,7 @@ public:
     bool IsCompleted(const GenericAgent& agent) override;
     Point Target(const GenericAgent& agent) override;
     StageProxy Proxy(Simulation* simulation_) override;
+    bool IsCoveredBy(const Polygon& area) const override;
     void State(WaitingSetState s);
     WaitingSetState State() const;
     template <typename T>
@@ -200,41 +205,27 @@ void NotifiableWaitingSet::Update(
 
     for(size_t index = count_occupants; index < slots.size(); ++index) {
         const auto slot_pos = slots[index];
-        const auto& boundary = geometry.LineSegmentsInApproxDistanceTo(slot_pos);
-        auto candidates = neighborhoodSearch.GetNeighboringAgents(slot_pos, 2);
-        candidates.erase(
-            std::remove_if(
-                std::begin(candidates),
-                std::end(candidates),
-                [&slot_pos, &boundary](const auto& neighbor) {
-                    const auto agent_to_neighbor = LineSegment(slot_pos, neighbor.pos);
-                    if(std::find_if(
-                           boundary.cbegin(),
-                           boundary.cend(),
-                           [&agent_to_neighbor](const auto& boundary_segment) {
-                               return intersects(agent_to_neighbor, boundary_segment);
-                           }) != boundary.end()) {
-                        return true;
-                    }
-
-                    return false;
-                }),
-            std::end(candidates));
-
+        const auto boundary = geometry.LineSegmentsInApproxDistanceTo(slot_pos);
         GenericAgent::ID occupant = GenericAgent::ID::Invalid;
         double min_distance = std::numeric_limits<double>::max();
-        for(const auto& agent : candidates) {
-            if(agent.stageId == id) {
-                if(std::find(std::begin(occupants), std::end(occupants), agent.id) ==
-                   std::end(occupants)) {
-                    const auto distance = (agent.pos - slots[index]).Norm();
-                    if(distance < min_distance) {
-                        min_distance = distance;
-                        occupant = agent.id;
-                    }
+        neighborhoodSearch.ForEachNeighboringAgent(
+            slot_pos,
+            2,
+            [this, &slot_pos, &boundary, &occupant, &min_distance](const auto& agent) {
+                if(agent.stageId != id ||
+                   std::find(std::begin(occupants), std::end(occupants), agent.id) !=
+                       std::end(occupants)) {
+                    return;
                 }
-            }
-        }
+                if(intersectsAny(LineSegment(slot_pos, agent.pos), boundary)) {
+                    return;
+                }
+                const auto distance = (agent.pos - slot_pos).Norm();
+                if(distance < min_distance) {
+                    min_distance = distance;
+                    occupant = agent.id;
+                }
+            });
         if(occupant != GenericAgent::ID::Invalid) {
             occupants.push_back(occupant);
         } else {
@@ -257,6 +248,7 @@ public:
     bool IsCompleted(const GenericAgent& agent) override;
     Point Target(const GenericAgent& agent) override;
     StageProxy Proxy(Simulation* simulation_) override;
+    bool IsCoveredBy(const Polygon& area) const override;
     template <typename T>
     void Update(const NeighborhoodSearch<T>& neighborhoodSearch, const CollisionGeometry& geometry);
     void Pop(size_t count);
@@ -276,40 +268,26 @@ void NotifiableQueue::Update(
 
     for(size_t index = count_occupants; index < slots.size(); ++index) {
         const auto slot_pos = slots[index];
-        const auto& boundary = geometry.LineSegmentsInApproxDistanceTo(slot_pos);
-        auto candidates = neighborhoodSearch.GetNeighboringAgents(slot_pos, 2);
-        candidates.erase(
-            std::remove_if(
-                std::begin(candidates),
-                std::end(candidates),
-                [&slot_pos, &boundary](const auto& neighbor) {
-                    const auto agent_to_neighbor = LineSegment(slot_pos, neighbor.pos);
-                    if(std::find_if(
-                           boundary.cbegin(),
-                           boundary.cend(),
-                           [&agent_to_neighbor](const auto& boundary_segment) {
-                               return intersects(agent_to_neighbor, boundary_segment);
-                           }) != boundary.end()) {
-                        return true;
-                    }
-
-                    return false;
-                }),
-            std::end(candidates));
-
+        const auto boundary = geometry.LineSegmentsInApproxDistanceTo(slot_pos);
         GenericAgent::ID occupant = GenericAgent::ID::Invalid;
         double min_distance = std::numeric_limits<double>::max();
-        for(const auto& agent : candidates) {
-            if(agent.stageId != id || Contains(occupants, agent.id) ||
-               exitingThisUpdate.contains(agent.id)) {
-                continue;
-            }
-            const auto distance = (agent.pos - slots[index]).Norm();
-            if(distance < min_distance) {
-                min_distance = distance;
-                occupant = agent.id;
-            }
-        }
+        neighborhoodSearch.ForEachNeighboringAgent(
+            slot_pos,
+            2,
+            [this, &slot_pos, &boundary, &occupant, &min_distance](const auto& agent) {
+                if(agent.stageId != id || Contains(occupants, agent.id) ||
+                   exitingThisUpdate.contains(agent.id)) {
+                    return;
+                }
+                if(intersectsAny(LineSegment(slot_pos, agent.pos), boundary)) {
+                    return;
+                }
+                const auto distance = (agent.pos - slot_pos).Norm();
+                if(distance < min_distance) {
+                    min_distance = distance;
+                    occupant = agent.id;
+                }
+            });
         if(occupant != GenericAgent::ID::Invalid) {
             occupants.emplace_back(occupant);
         } else {
@@ -329,4 +307,6 @@ public:
     {
         return DirectSteeringProxy(simulation, this);
     };
+    /// Targets are set per agent and checked together with the agents.
+    bool IsCoveredBy(const Polygon&) const override { return false; };
 };
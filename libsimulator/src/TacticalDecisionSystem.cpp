@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "TacticalDecisionSystem.hpp"
+
+#include "AABB.hpp"
+#include "GenericAgent.hpp"
+#include "Point.hpp"
+#include "RoutingEngine.hpp"
+#include "SimulationError.hpp"
+
+#include <CGAL/number_utils.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+void TacticalDecisionSystem::RemoveAgents(const std::vector<GenericAgent::ID>& ids)
+{
+    for(const auto id : ids) {
+        _corridors.erase(id);
+        _faceHints.erase(id);
+    }
+}
+
+void TacticalDecisionSystem::Invalidate()
+{
+    _corridors.clear();
+    _navigationFields.clear();
+    _faceHints.clear();
+    _targetFaces.clear();
+}
+
+void TacticalDecisionSystem::Invalidate(const AABB& changed)
+{
+    // Navigation fields refer to triangles by index, which changes with every update
+    _navigationFields.clear();
+    std::erase_if(
+        _corridors, [&changed](const auto& entry) { return entry.second.bounds.Overlap(changed); });
+}
+
+void TacticalDecisionSystem::updateNavigationFields(
+    const RoutingEngine& routingEngine,
+    const std::map<Point, size_t>& agentsPerTarget)
+{
+    // Fields lead along triangle midpoints, with any-angle routing every agent gets the corridor
+    // along its shortest path instead
+    const bool useFields =
+        _useNavigationFields && routingEngine.Algorithm() == RoutingAlgorithm::Triangulation;
+    std::erase_if(_navigationFields, [&agentsPerTarget, useFields](const auto& entry) {
+        const auto iter = agentsPerTarget.find(entry.first);
+        return !useFields || iter == agentsPerTarget.end() ||
+               iter->second < NAVIGATION_FIELD_MIN_AGENTS;
+    });
+    std::erase_if(_targetFaces, [&agentsPerTarget](const auto& entry) {
+        return !agentsPerTarget.contains(entry.first);
+    });
+    for(const auto& [target, count] : agentsPerTarget) {
+        if(useFields && count >= NAVIGATION_FIELD_MIN_AGENTS &&
+           !_navigationFields.contains(target)) {
+            _navigationFields.emplace(target, routingEngine.ComputeNavigationField(target));
+        }
+    }
+}
+
+Point TacticalDecisionSystem::nextWaypoint(
+    RoutingEngine& routingEngine,
+    GenericAgent::ID id,
+    Point position,
+    Point target)
+{
+    auto positionHint = RoutingEngine::NoFaceHint;
+    if(const auto iter = _faceHints.find(id); iter != _faceHints.end()) {
+        positionHint = iter->second;
+    }
+    if(auto iter = _corridors.find(id); iter != _corridors.end()) {
+        auto& cached = iter->second;
+        if(cached.corridor.destination == target) {
+            if(cached.position == position) {
+                return cached.waypoint;
+            }
+            if(const auto face =
+                   routingEngine.LocateInCorridor(cached.corridor, cached.face, position);
+               face) {
+                cached.face = *face;
+                cached.position = position;
+                cached.waypoint =
+                    routingEngine.NextWaypointInCorridor(cached.corridor, *face, position);
+                return cached.waypoint;
+            }
+        }
+        // The triangle the agent was last located in is closer than the one the corridor
+        // started in
+        if(cached.face < cached.corridor.faces.size()) {
+            positionHint = cached.corridor.faces[cached.face]->get_index();
+        }
+    }
+
+    const auto field = _navigationFields.find(target);
+    Corridor corridor{};
+    if(field != _navigationFields.end()) {
+        corridor = routingEngine.ComputeCorridor(field->second, position, positionHint);
+    } else {
+        const auto targetFace = _targetFaces.find(target);
+        corridor = routingEngine.ComputeCorridor(
+            position,
+            target,
+            positionHint,
+            targetFace != _targetFaces.end() ? targetFace->second : RoutingEngine::NoFaceHint);
+    }
+    if(corridor.faces.empty() || corridor.waypoints.size() < 2) {
+        throw SimulationError(
+            "Target ({}, {}) cannot be reached from ({}, {})",
+            target.x,
+            target.y,
+            position.x,
+            position.y);
+    }
+    if(field == _navigationFields.end()) {
+        _targetFaces.insert_or_assign(target, corridor.faces.back()->get_index());
+    }
+    _faceHints.insert_or_assign(id, corridor.faces.front()->get_index());
+    const auto waypoint = corridor.waypoints[1];
+    AABB bounds{};
+    for(const auto& face : corridor.faces) {
+        for(int idx = 0; idx < 3; ++idx) {
+            const auto& p = face->vertex(idx)->point();
+            bounds.Extend(Point{CGAL::to_double(p.x()), CGAL::to_double(p.y())});
+        }
+    }
+    _corridors.insert_or_assign(
+        id, CachedCorridor{std::move(corridor), 0, position, waypoint, bounds});
+    return waypoint;
+}
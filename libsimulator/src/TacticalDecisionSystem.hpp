@@ -1,23 +1,101 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #pragma once
 
+#include "AABB.hpp"
+#include "GenericAgent.hpp"
+#include "Point.hpp"
 #include "RoutingEngine.hpp"
 
+#include <cstddef>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
 class TacticalDecisionSystem
 {
+    /// Corridor an agent follows together with the last funnel evaluation inside of it.
+    struct CachedCorridor {
+        Corridor corridor{};
+        /// Index of the triangle in 'corridor' the agent was last located in
+        size_t face{0};
+        /// Position the waypoint was computed for
+        Point position{};
+        Point waypoint{};
+        /// Bounds of all triangles of 'corridor'
+        AABB bounds{};
+    };
+    std::unordered_map<GenericAgent::ID, CachedCorridor> _corridors{};
+    std::map<Point, NavigationField> _navigationFields{};
+    /// Index of the triangle each agent was located in when its corridor was last computed.
+    /// Used as start of the next point location, see 'RoutingEngine::Locate'.
+    std::unordered_map<GenericAgent::ID, size_t> _faceHints{};
+    /// Index of the triangle each target was located in when a corridor to it was last computed.
+    std::map<Point, size_t> _targetFaces{};
+    bool _useNavigationFields{false};
+
 public:
-    TacticalDecisionSystem() = default;
+    /// Minimum number of agents sharing a target before a navigation field is used for it.
+    static constexpr size_t NAVIGATION_FIELD_MIN_AGENTS = 16;
+
+    /// Shares navigation fields between agents heading to the same target if
+    /// 'useNavigationFields' is set, see 'UpdateNavigationFields'.
+    explicit TacticalDecisionSystem(bool useNavigationFields = false)
+        : _useNavigationFields(useNavigationFields)
+    {
+    }
     ~TacticalDecisionSystem() = default;
     TacticalDecisionSystem(const TacticalDecisionSystem& other) = delete;
     TacticalDecisionSystem& operator=(const TacticalDecisionSystem& other) = delete;
     TacticalDecisionSystem(TacticalDecisionSystem&& other) = delete;
     TacticalDecisionSystem& operator=(TacticalDecisionSystem&& other) = delete;
 
-    void Run(RoutingEngine& routingEngine, auto&& agents) const
+    void Run(RoutingEngine& routingEngine, auto&& agents)
     {
         for(auto& agent : agents) {
-            const auto dest = agent.target;
-            agent.destination = routingEngine.ComputeWaypoint(agent.pos, dest);
+            agent.destination = nextWaypoint(routingEngine, agent.id, agent.pos, agent.target);
+        }
+    }
+
+    /// Returns true if navigation fields are shared between agents.
+    bool UsesNavigationFields() const { return _useNavigationFields; }
+
+    /// Creates navigation fields for all targets shared by at least NAVIGATION_FIELD_MIN_AGENTS
+    /// agents and drops fields for targets that are no longer used by as many agents. Fields are
+    /// only used if enabled and with 'RoutingAlgorithm::Triangulation'.
+    /// Fields measure distances along triangle edge midpoints, agents following a field may
+    /// therefore take a different route than the A* search would select for them.
+    void UpdateNavigationFields(const RoutingEngine& routingEngine, const auto& agents)
+    {
+        std::map<Point, size_t> agentsPerTarget{};
+        for(const auto& agent : agents) {
+            ++agentsPerTarget[agent.target];
         }
+        updateNavigationFields(routingEngine, agentsPerTarget);
     }
+
+    /// Drops the cached corridors and face hints of removed agents.
+    void RemoveAgents(const std::vector<GenericAgent::ID>& ids);
+
+    /// Drops all cached corridors, navigation fields and face hints, required whenever the routing
+    /// engine changes.
+    void Invalidate();
+
+    /// Drops all navigation fields and the cached corridors passing through 'changed', required
+    /// whenever triangles of the routing engine inside of 'changed' were replaced and no route
+    /// became shorter. Face hints are kept, a hint to a replaced triangle only slows down the
+    /// next point location.
+    void Invalidate(const AABB& changed);
+
+private:
+    void updateNavigationFields(
+        const RoutingEngine& routingEngine,
+        const std::map<Point, size_t>& agentsPerTarget);
+    /// Returns the next waypoint towards 'target' from 'position'.
+    /// The corridor of the agent is only recomputed if the target changed or the agent is no
+    /// longer inside its corridor.
+    Point nextWaypoint(
+        RoutingEngine& routingEngine,
+        GenericAgent::ID id,
+        Point position,
+        Point target);
 };
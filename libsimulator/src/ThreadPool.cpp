@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "ThreadPool.hpp"
+
+#include "SimulationError.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+    if(threadCount == 0) {
+        throw SimulationError("Thread count needs to be at least 1");
+    }
+    _workers.reserve(threadCount - 1);
+    for(size_t workerIndex = 0; workerIndex < threadCount - 1; ++workerIndex) {
+        _workers.emplace_back([this, workerIndex]() { workerLoop(workerIndex); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::scoped_lock lock(_mutex);
+        _stop = true;
+    }
+    _wakeup.notify_all();
+    for(auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::ChunkCount(size_t count, size_t minChunkSize) const
+{
+    const auto maxChunks = count / std::max<size_t>(minChunkSize, 1);
+    return std::max<size_t>(std::min(ThreadCount(), maxChunks), 1);
+}
+
+void ThreadPool::run(const std::function<void(size_t)>& chunk, size_t chunkCount)
+{
+    _errors.assign(chunkCount, nullptr);
+    {
+        std::scoped_lock lock(_mutex);
+        _task = &chunk;
+        _chunkCount = chunkCount;
+        _pending = chunkCount - 1;
+        ++_generation;
+    }
+    _wakeup.notify_all();
+
+    execute(chunk, 0);
+
+    {
+        std::unique_lock lock(_mutex);
+        _done.wait(lock, [this]() { return _pending == 0; });
+        _task = nullptr;
+    }
+
+    for(const auto& error : _errors) {
+        if(error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+void ThreadPool::execute(const std::function<void(size_t)>& chunk, size_t chunkIndex)
+{
+    try {
+        chunk(chunkIndex);
+    } catch(...) {
+        _errors[chunkIndex] = std::current_exception();
+    }
+}
+
+void ThreadPool::workerLoop(size_t workerIndex)
+{
+    const size_t chunkIndex = workerIndex + 1;
+    uint64_t seenGeneration = 0;
+    std::unique_lock lock(_mutex);
+    while(true) {
+        _wakeup.wait(lock, [this, seenGeneration]() {
+            return _stop || _generation != seenGeneration;
+        });
+        if(_stop) {
+            return;
+        }
+        seenGeneration = _generation;
+        if(chunkIndex >= _chunkCount) {
+            continue;
+        }
+        const auto* task = _task;
+        lock.unlock();
+        execute(*task, chunkIndex);
+        lock.lock();
+        if(--_pending == 0) {
+            _done.notify_one();
+        }
+    }
+}
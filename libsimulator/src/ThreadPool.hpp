@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Fixed size pool of worker threads used to run data parallel loops.
+///
+/// Work is split into contiguous chunks, one per thread, and the chunk boundaries only depend on
+/// the number of items and the number of threads. The calling thread always processes the first
+/// chunk itself, so a pool with a thread count of 1 does not spawn any workers and executes the
+/// loop inline.
+class ThreadPool
+{
+    std::vector<std::thread> _workers{};
+    std::mutex _mutex{};
+    std::condition_variable _wakeup{};
+    std::condition_variable _done{};
+    const std::function<void(size_t)>* _task{nullptr};
+    std::vector<std::exception_ptr> _errors{};
+    uint64_t _generation{0};
+    size_t _chunkCount{0};
+    size_t _pending{0};
+    bool _stop{false};
+
+public:
+    /// Minimum number of items a chunk has to contain before additional threads are used.
+    static constexpr size_t MIN_CHUNK_SIZE = 16;
+
+    explicit ThreadPool(size_t threadCount = 1);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool& other) = delete;
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+    ThreadPool(ThreadPool&& other) = delete;
+    ThreadPool& operator=(ThreadPool&& other) = delete;
+
+    /// Number of threads taking part in a parallel loop, including the calling thread.
+    size_t ThreadCount() const { return _workers.size() + 1; }
+
+    /// Calls 'func(index)' for every index in [0, count).
+    /// Indices are distributed across threads in contiguous chunks of at least 'minChunkSize'
+    /// items. If any invocation throws, the exception of the lowest chunk is rethrown on the
+    /// calling thread after all chunks finished.
+    template <typename Func>
+    void ParallelFor(size_t count, Func&& func, size_t minChunkSize = MIN_CHUNK_SIZE)
+    {
+        ParallelForRanges(
+            count,
+            [&func](size_t begin, size_t end) {
+                for(size_t index = begin; index < end; ++index) {
+                    func(index);
+                }
+            },
+            minChunkSize);
+    }
+
+    /// Calls 'func(begin, end)' once for every chunk [begin, end) of [0, count).
+    /// Chunks and error handling are the same as for 'ParallelFor'.
+    template <typename Func>
+    void ParallelForRanges(size_t count, Func&& func, size_t minChunkSize = MIN_CHUNK_SIZE)
+    {
+        const size_t chunkCount = ChunkCount(count, minChunkSize);
+        if(chunkCount <= 1) {
+            func(size_t{0}, count);
+            return;
+        }
+        const std::function<void(size_t)> chunk = [count, chunkCount, &func](size_t chunkIndex) {
+            func(count * chunkIndex / chunkCount, count * (chunkIndex + 1) / chunkCount);
+        };
+        run(chunk, chunkCount);
+    }
+
+    /// Number of chunks 'count' items are split into if every chunk needs at least
+    /// 'minChunkSize' items.
+    size_t ChunkCount(size_t count, size_t minChunkSize = MIN_CHUNK_SIZE) const;
+
+private:
+    void run(const std::function<void(size_t)>& chunk, size_t chunkCount);
+    void execute(const std::function<void(size_t)>& chunk, size_t chunkIndex);
+    void workerLoop(size_t workerIndex);
+};
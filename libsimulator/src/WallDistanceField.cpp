@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "WallDistanceField.hpp"
+
+#include "AABB.hpp"
+#include "CollisionGeometry.hpp"
+#include "Point.hpp"
+#include "SimulationError.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+WallDistanceField::WallDistanceField(const CollisionGeometry& geometry, double resolution)
+    : _resolution(resolution)
+{
+    if(!(resolution > 0)) {
+        throw SimulationError("Wall distance field resolution must be > 0, got {}", resolution);
+    }
+
+    // One additional node on each side so all accessible positions have four surrounding nodes
+    const AABB bounds(std::get<0>(geometry.AccessibleArea()));
+    _origin = Point{bounds.xmin - resolution, bounds.ymin - resolution};
+    _width = static_cast<size_t>(std::ceil((bounds.xmax - bounds.xmin) / resolution)) + 3;
+    _height = static_cast<size_t>(std::ceil((bounds.ymax - bounds.ymin) / resolution)) + 3;
+    _distances.resize(_width * _height);
+    _toWallX.resize(_width * _height);
+    _toWallY.resize(_width * _height);
+
+    for(size_t row = 0; row < _height; ++row) {
+        for(size_t column = 0; column < _width; ++column) {
+            computeNode(geometry, row, column);
+        }
+    }
+}
+
+WallDistanceField::WallDistanceField(
+    const WallDistanceField& base,
+    const CollisionGeometry& geometry,
+    const AABB& changed)
+    : WallDistanceField(base)
+{
+    // Walls further away than 'MaxDistance' do not contribute to a node
+    const auto nodeIndex = [this](double coordinate, double origin, size_t count) {
+        const auto index = std::floor((coordinate - origin) / _resolution);
+        return static_cast<size_t>(std::clamp(index, 0.0, static_cast<double>(count - 1)));
+    };
+    const auto firstColumn = nodeIndex(changed.xmin - MaxDistance, _origin.x, _width);
+    const auto lastColumn = nodeIndex(changed.xmax + MaxDistance, _origin.x, _width) + 1;
+    const auto firstRow = nodeIndex(changed.ymin - MaxDistance, _origin.y, _height);
+    const auto lastRow = nodeIndex(changed.ymax + MaxDistance, _origin.y, _height) + 1;
+    for(size_t row = firstRow; row <= std::min(lastRow, _height - 1); ++row) {
+        for(size_t column = firstColumn; column <= std::min(lastColumn, _width - 1); ++column) {
+            computeNode(geometry, row, column);
+        }
+    }
+}
+
+void WallDistanceField::computeNode(const CollisionGeometry& geometry, size_t row, size_t column)
+{
+    const Point node{
+        _origin.x + static_cast<double>(column) * _resolution,
+        _origin.y + static_cast<double>(row) * _resolution};
+    double distance = MaxDistance;
+    Point toWall{};
+    for(const auto& wall : geometry.LineSegmentsInApproxDistanceTo(node)) {
+        const auto candidate = wall.ShortestPoint(node) - node;
+        const auto candidateDistance = candidate.Norm();
+        if(candidateDistance < distance) {
+            distance = candidateDistance;
+            toWall = candidate;
+        }
+    }
+    const auto index = row * _width + column;
+    _distances[index] = static_cast<float>(geometry.InsideGeometry(node) ? distance : -distance);
+    _toWallX[index] = static_cast<float>(toWall.x);
+    _toWallY[index] = static_cast<float>(toWall.y);
+}
+
+WallDistanceField::Sample WallDistanceField::At(Point p) const
+{
+    const auto gridX = (p.x - _origin.x) / _resolution;
+    const auto gridY = (p.y - _origin.y) / _resolution;
+    if(!(gridX >= 0 && gridY >= 0 && gridX <= static_cast<double>(_width - 1) &&
+         gridY <= static_cast<double>(_height - 1))) {
+        return {-MaxDistance, {}};
+    }
+
+    // Clamp so positions on the last row or column interpolate within the last cell
+    const auto column = std::min(static_cast<size_t>(gridX), _width - 2);
+    const auto row = std::min(static_cast<size_t>(gridY), _height - 2);
+    const auto fx = gridX - static_cast<double>(column);
+    const auto fy = gridY - static_cast<double>(row);
+    const auto index = row * _width + column;
+    const double bottom = _distances[index] * (1 - fx) + _distances[index + 1] * fx;
+    const double top = _distances[index + _width] * (1 - fx) + _distances[index + _width + 1] * fx;
+    const auto distance = bottom * (1 - fy) + top * fy;
+
+    // Surrounding nodes by their interpolation weight, the largest weight is the closest node
+    const std::array<std::pair<double, size_t>, 4> nodes{
+        {{(1 - fx) * (1 - fy), index},
+         {fx * (1 - fy), index + 1},
+         {(1 - fx) * fy, index + _width},
+         {fx * fy, index + _width + 1}}};
+    Point direction{};
+    double bestWeight = -1;
+    for(const auto& [weight, node] : nodes) {
+        const auto toWall = Point{_toWallX[node], _toWallY[node]}.Normalized();
+        if(weight <= bestWeight || toWall == Point{}) {
+            continue;
+        }
+        // Outside of the accessible area the wall lies between the node and the position
+        direction = _distances[node] < 0 ? -toWall : toWall;
+        bestWeight = weight;
+    }
+    return {distance, direction};
+}
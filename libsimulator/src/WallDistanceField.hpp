@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "Point.hpp"
+
+#include <cstddef>
+#include <vector>
+
+class CollisionGeometry;
+struct AABB;
+
+/// Distance and direction to the closest wall, precomputed on a regular grid of nodes over the
+/// accessible area.
+///
+/// The signed distance is interpolated bilinearly, which is exact for points whose closest wall
+/// is the same straight segment at all four surrounding nodes and off by up to the resolution
+/// where the closest wall changes between nodes, e.g. close to corners or on the medial axis of a
+/// corridor. The direction is not interpolated, since the wall vectors of nodes with walls on
+/// opposite sides cancel. It is taken from the closest surrounding node that knows a wall.
+/// Only the single closest wall is recorded, models summing the influence of all nearby walls see
+/// the influence of one wall instead.
+class WallDistanceField
+{
+public:
+    /// Walls further away than this are not recorded, see 'Sample'.
+    static constexpr double MaxDistance = 4.0;
+
+    struct Sample {
+        /// Distance to the closest wall, negative outside of the accessible area.
+        double distance{MaxDistance};
+        /// Unit vector from the sampled position towards the closest wall, zero if no node around
+        /// the position knows a wall.
+        Point direction{};
+    };
+
+private:
+    Point _origin{};
+    double _resolution{};
+    size_t _width{};
+    size_t _height{};
+    // Stored as floats per node to keep fine fields small, all values are bounded by MaxDistance.
+    std::vector<float> _distances{};
+    std::vector<float> _toWallX{};
+    std::vector<float> _toWallY{};
+
+public:
+    /// Computes the field for all nodes of a grid with 'resolution' meters between nodes covering
+    /// the accessible area of 'geometry'.
+    WallDistanceField(const CollisionGeometry& geometry, double resolution);
+
+    /// Copies 'base', computed for a geometry whose walls only differ from the walls of 'geometry'
+    /// inside of 'changed', and recomputes all nodes within 'MaxDistance' of 'changed'. The
+    /// accessible areas of both geometries have to share their bounding box.
+    WallDistanceField(
+        const WallDistanceField& base,
+        const CollisionGeometry& geometry,
+        const AABB& changed);
+
+    double Resolution() const { return _resolution; }
+
+    /// Samples distance and direction to the closest wall at 'p'.
+    /// Nodes without a wall within 'MaxDistance' report a distance of +/-'MaxDistance' and no wall
+    /// direction. The grid only extends one node beyond the bounding box of the accessible area,
+    /// positions further outside report '-MaxDistance'.
+    Sample At(Point p) const;
+
+private:
+    /// Computes distance and wall vector of the node in 'row' and 'column'.
+    void computeNode(const CollisionGeometry& geometry, size_t row, size_t column);
+};
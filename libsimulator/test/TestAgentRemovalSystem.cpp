@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "AgentIndex.hpp"
+#include "AgentRemovalSystem.hpp"
+#include "CollisionFreeSpeedModelData.hpp"
+#include "GenericAgent.hpp"
+#include "Journey.hpp"
+#include "Point.hpp"
+#include "StageDescription.hpp"
+#include "StageManager.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+class AgentRemoval : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        stage = stageManager.AddStage(WaypointDescription{{0, 0}, 1}, removedAgents);
+        for(size_t index = 0; index < 10; ++index) {
+            agents.emplace_back(
+                GenericAgent::ID::Invalid,
+                jps::UniqueID<Journey>::Invalid,
+                stage,
+                Point{static_cast<double>(index), 0},
+                CollisionFreeSpeedModelData{});
+            agentIndex.Set(agents.back().id, agents.size() - 1);
+            stageManager.HandleNewAgent(stage);
+        }
+    }
+
+protected:
+    StageManager stageManager{};
+    BaseStage::ID stage{BaseStage::ID::Invalid};
+    AgentContainer<GenericAgent> agents{};
+    AgentIndex agentIndex{};
+    std::vector<GenericAgent::ID> removedAgents{};
+    AgentRemovalSystem<GenericAgent> removalSystem{};
+};
+
+TEST_F(AgentRemoval, RemovesMarkedAgentsAndKeepsIndexInSync)
+{
+    const auto first = agents[0].id;
+    const auto middle = agents[4].id;
+    const auto last = agents[9].id;
+    removedAgents = {middle, last, first};
+
+    removalSystem.Run(agents, removedAgents, stageManager, agentIndex);
+
+    ASSERT_TRUE(removedAgents.empty());
+    ASSERT_EQ(agents.size(), 7);
+    ASSERT_EQ(agentIndex.Size(), 7);
+    ASSERT_EQ(stageManager.Stage(stage)->CountTargeting(), 7);
+    for(const auto id : {first, middle, last}) {
+        ASSERT_FALSE(agentIndex.Contains(id));
+    }
+    for(size_t position = 0; position < agents.size(); ++position) {
+        ASSERT_EQ(agentIndex.Find(agents[position].id), position);
+    }
+}
+
+TEST_F(AgentRemoval, DoesNothingWithoutMarkedAgents)
+{
+    const auto before = agents.size();
+
+    removalSystem.Run(agents, removedAgents, stageManager, agentIndex);
+
+    ASSERT_EQ(agents.size(), before);
+    ASSERT_EQ(agentIndex.Size(), before);
+    ASSERT_EQ(stageManager.Stage(stage)->CountTargeting(), before);
+}
+
+TEST_F(AgentRemoval, IgnoresAgentsMarkedTwice)
+{
+    const auto id = agents[2].id;
+    removedAgents = {id, id};
+
+    removalSystem.Run(agents, removedAgents, stageManager, agentIndex);
+
+    ASSERT_EQ(agents.size(), 9);
+    ASSERT_EQ(agentIndex.Size(), 9);
+    ASSERT_EQ(stageManager.Stage(stage)->CountTargeting(), 9);
+}
+
+TEST_F(AgentRemoval, CanRemoveAllAgents)
+{
+    for(const auto& agent : agents) {
+        removedAgents.push_back(agent.id);
+    }
+
+    removalSystem.Run(agents, removedAgents, stageManager, agentIndex);
+
+    ASSERT_TRUE(agents.empty());
+    ASSERT_EQ(agentIndex.Size(), 0);
+    ASSERT_EQ(stageManager.Stage(stage)->CountTargeting(), 0);
+}
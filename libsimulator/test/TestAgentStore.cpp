@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "AgentStore.hpp"
+#include "CollisionFreeSpeedModelData.hpp"
+#include "GenericAgent.hpp"
+#include "Journey.hpp"
+#include "Point.hpp"
+#include "SimulationError.hpp"
+#include "SocialForceModelData.hpp"
+#include "Stage.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <utility>
+#include <variant>
+
+namespace
+{
+GenericAgent makeAgent(Point pos, GenericAgent::Model model)
+{
+    return GenericAgent{
+        GenericAgent::ID::Invalid,
+        jps::UniqueID<Journey>::Invalid,
+        BaseStage::ID::Invalid,
+        pos,
+        std::move(model)};
+}
+} // namespace
+
+TEST(AgentStore, GathersColumnsInContainerOrder)
+{
+    AgentContainer<GenericAgent> agents{};
+    for(size_t index = 0; index < 5; ++index) {
+        agents.push_back(makeAgent(
+            Point(static_cast<double>(index), 1),
+            CollisionFreeSpeedModelData{.orientation = {1, 0}, .radius = 0.1 * index}));
+    }
+
+    AgentStore store{};
+    store.Gather(agents);
+
+    ASSERT_EQ(store.Size(), agents.size());
+    const auto models = store.Models<CollisionFreeSpeedModelData>();
+    for(size_t index = 0; index < agents.size(); ++index) {
+        EXPECT_EQ(store.Ids()[index], agents[index].id);
+        EXPECT_EQ(store.Positions()[index], agents[index].pos);
+        EXPECT_EQ(store.Orientations()[index], Point(1, 0));
+        EXPECT_EQ(store.Velocities()[index], Point());
+        EXPECT_DOUBLE_EQ(store.Radii()[index], 0.1 * index);
+        EXPECT_DOUBLE_EQ(models[index].radius, 0.1 * index);
+    }
+    EXPECT_THROW(store.Models<SocialForceModelData>(), std::bad_variant_access);
+}
+
+TEST(AgentStore, GatherReplacesPreviousContent)
+{
+    AgentContainer<GenericAgent> agents{};
+    agents.push_back(makeAgent({0, 0}, CollisionFreeSpeedModelData{.radius = 0.2}));
+    agents.push_back(makeAgent({1, 0}, CollisionFreeSpeedModelData{.radius = 0.3}));
+
+    AgentStore store{};
+    store.Gather(agents);
+    ASSERT_EQ(store.Size(), 2);
+
+    agents.clear();
+    agents.push_back(makeAgent({5, 5}, SocialForceModelData{.velocity = {0, 1}, .radius = 0.4}));
+    store.Gather(agents);
+
+    ASSERT_EQ(store.Size(), 1);
+    EXPECT_EQ(store.Positions()[0], Point(5, 5));
+    EXPECT_EQ(store.Velocities()[0], Point(0, 1));
+    EXPECT_DOUBLE_EQ(store.Radii()[0], 0.4);
+    EXPECT_EQ(store.Models<SocialForceModelData>()[0].velocity, Point(0, 1));
+    EXPECT_THROW(store.Models<CollisionFreeSpeedModelData>(), std::bad_variant_access);
+}
+
+TEST(AgentStore, RejectsMixedModels)
+{
+    AgentContainer<GenericAgent> agents{};
+    agents.push_back(makeAgent({0, 0}, SocialForceModelData{}));
+    agents.push_back(makeAgent({1, 0}, CollisionFreeSpeedModelData{}));
+
+    AgentStore store{};
+    EXPECT_THROW(store.Gather(agents), SimulationError);
+}
@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "AnyAngleSearch.hpp"
+
+#include "GeometryBuilder.hpp"
+#include "Mesh.hpp"
+#include "Point.hpp"
+#include "RoutingEngine.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace
+{
+double pathLength(const std::vector<Point>& path)
+{
+    double length = 0;
+    for(size_t index = 1; index < path.size(); ++index) {
+        length += Distance(path[index - 1], path[index]);
+    }
+    return length;
+}
+
+/// Room with two walls, one from the bottom and one from the top, forcing a zig-zag path.
+std::unique_ptr<RoutingEngine> buildZigZag()
+{
+    GeometryBuilder builder{};
+    builder.AddAccessibleArea({{0, 0}, {30, 0}, {30, 10}, {0, 10}});
+    builder.ExcludeFromAccessibleArea({{9, 0}, {11, 0}, {11, 8}, {9, 8}});
+    builder.ExcludeFromAccessibleArea({{19, 2}, {21, 2}, {21, 10}, {19, 10}});
+    return std::make_unique<RoutingEngine>(builder.Build().Polygon());
+}
+
+AnyAngleSearch buildSearch(const RoutingEngine& engine, bool merge)
+{
+    Mesh mesh = *engine.MeshData();
+    if(merge) {
+        mesh.MergeGreedy();
+    }
+    return AnyAngleSearch(std::move(mesh));
+}
+} // namespace
+
+class ZigZag : public ::testing::TestWithParam<bool>
+{
+public:
+    void SetUp() override { engine = buildZigZag(); }
+
+protected:
+    std::unique_ptr<RoutingEngine> engine{};
+};
+
+TEST_P(ZigZag, StraightPathInsideOfOneRoom)
+{
+    const auto search = buildSearch(*engine, GetParam());
+    const auto path = search.ComputePath({1, 1}, {8, 9});
+    ASSERT_EQ(path.waypoints, (std::vector<Point>{{1, 1}, {8, 9}}));
+}
+
+TEST_P(ZigZag, PathTurnsAtWallCorners)
+{
+    const auto search = buildSearch(*engine, GetParam());
+    const auto path = search.ComputePath({2, 2}, {28, 8});
+    ASSERT_EQ(
+        path.waypoints,
+        (std::vector<Point>{{2, 2}, {9, 8}, {11, 8}, {19, 2}, {21, 2}, {28, 8}}));
+    EXPECT_GT(path.expandedNodes, 0);
+}
+
+TEST_P(ZigZag, PathStartingOnCornerDoesNotRepeatIt)
+{
+    const auto search = buildSearch(*engine, GetParam());
+    const auto path = search.ComputePath({11, 8}, {28, 8});
+    ASSERT_EQ(path.waypoints, (std::vector<Point>{{11, 8}, {19, 2}, {21, 2}, {28, 8}}));
+}
+
+TEST_P(ZigZag, NoPathForPositionsOutsideOfMesh)
+{
+    const auto search = buildSearch(*engine, GetParam());
+    EXPECT_TRUE(search.ComputePath({10, 1}, {28, 8}).waypoints.empty());
+    EXPECT_TRUE(search.ComputePath({2, 2}, {31, 8}).waypoints.empty());
+}
+
+TEST_P(ZigZag, PathIsNeverLongerThanTriangleCorridor)
+{
+    const auto search = buildSearch(*engine, GetParam());
+    const std::vector<Point> positions{
+        {1, 1}, {5, 9}, {10, 9}, {15, 1}, {15, 9}, {20, 1}, {25, 5}, {29, 9}};
+    for(const auto from : positions) {
+        for(const auto to : positions) {
+            const auto path = search.ComputePath(from, to);
+            ASSERT_FALSE(path.waypoints.empty());
+            EXPECT_LE(
+                pathLength(path.waypoints),
+                pathLength(engine->ComputeAllWaypoints(from, to)) + 1e-9);
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(AnyAngleSearch, ZigZag, ::testing::Values(false, true));
+
+TEST(AnyAngleSearch, MergedMeshNeedsFewerExpansions)
+{
+    const auto engine = buildZigZag();
+    const auto triangles = buildSearch(*engine, false).ComputePath({2, 2}, {28, 8});
+    const auto merged = buildSearch(*engine, true).ComputePath({2, 2}, {28, 8});
+    EXPECT_EQ(merged.waypoints, triangles.waypoints);
+    EXPECT_LE(merged.expandedNodes, triangles.expandedNodes);
+}
+
+TEST(AnyAngleRouting, CorridorContainsShortestPath)
+{
+    const auto engine = buildZigZag();
+    engine->SetAlgorithm(RoutingAlgorithm::AnyAngle);
+    const Point start{2, 2};
+    const Point destination{28, 8};
+    const auto corridor = engine->ComputeCorridor(start, destination);
+    ASSERT_FALSE(corridor.faces.empty());
+    EXPECT_EQ(engine->LocateInCorridor(corridor, 0, start), 0);
+    EXPECT_TRUE(engine->LocateInCorridor(corridor, 0, destination));
+    EXPECT_EQ(corridor.waypoints.front(), start);
+    EXPECT_EQ(corridor.waypoints.back(), destination);
+    // Waypoints keep a clearance of up to 0.2m to the four wall corners
+    const auto shortest = 2 * std::sqrt(7. * 7. + 6. * 6.) + 2 + 10 + 2;
+    EXPECT_GE(pathLength(corridor.waypoints), shortest - 1e-9);
+    EXPECT_LT(pathLength(corridor.waypoints), shortest + 4 * 0.2);
+}
+
+TEST(AnyAngleRouting, CloneKeepsAlgorithm)
+{
+    const auto engine = buildZigZag();
+    engine->SetAlgorithm(RoutingAlgorithm::AnyAngle);
+    const auto clone = engine->Clone();
+    EXPECT_EQ(clone->Algorithm(), RoutingAlgorithm::AnyAngle);
+    EXPECT_EQ(
+        clone->ComputeAllWaypoints({2, 2}, {28, 8}), engine->ComputeAllWaypoints({2, 2}, {28, 8}));
+}
@@ -1,12 +1,20 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #include "CollisionGeometry.hpp"
+#include "GeometricFunctions.hpp"
 #include "LineSegment.hpp"
+#include "SimulationError.hpp"
 #include "gtest/gtest.h"
 
 #include <fmt/format.h>
 #include <fmt/ranges.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <set>
+#include <vector>
+
 struct CellAdjacencyTestData {
     Cell c;
     Cell neighbor;
@@ -74,6 +82,22 @@ TEST_P(CellsFromLSTest, All)
     EXPECT_EQ(expected, cellsFromLineSegment(reverseInput));
 }
 
+TEST_P(CellsFromLSTest, TraversalVisitsAllCells)
+{
+    const auto [input, expected] = GetParam();
+    for(const auto& ls : {input, LineSegment{input.p2, input.p1}}) {
+        std::set<Cell> visited{};
+        anyCellOnLineSegment(ls, [&visited](int64_t x, int64_t y) {
+            visited.emplace(
+                static_cast<double>(x) * CELL_EXTEND, static_cast<double>(y) * CELL_EXTEND);
+            return false;
+        });
+        for(const auto& cell : expected) {
+            EXPECT_TRUE(visited.contains(cell)) << fmt::format("{} {}", ls, cell);
+        }
+    }
+}
+
 // clang-format off
 INSTANTIATE_TEST_SUITE_P(
     CellComputation,
@@ -325,3 +349,233 @@ TEST_F(LongDiagonalRectangle, CellsWithTwoLSMiddle)
         ASSERT_EQ(actual, expected);
     }
 }
+
+TEST_F(LongDiagonalRectangle, ApproxDistanceOutsideOfGridIsEmpty)
+{
+    EXPECT_TRUE(collisionGeometry.LineSegmentsInApproxDistanceTo({1000, 1000}).empty());
+    EXPECT_TRUE(collisionGeometry.LineSegmentsInApproxDistanceTo({-1000, 0}).empty());
+}
+
+TEST_F(LongDiagonalRectangle, IntersectsAnyMatchesAllSegments)
+{
+    const std::vector<LineSegment> walls{
+        {{-11., -13.}, {5., 11.}},
+        {{5., 11.}, {6., 10.}},
+        {{6., 10.}, {-10., -14.}},
+        {{-10., -14.}, {-11., -13.}}};
+    const std::vector<LineSegment> candidates{
+        {{-2, 0}, {2, 0}},
+        {{-0.5, -0.5}, {0.5, -0.5}},
+        {{-20, -20}, {20, 20}},
+        {{-11, -13}, {-12, -20}},
+        {{4, 4}, {8, 8}},
+        {{-16, 12}, {-8, 12}},
+        {{-30, 0}, {30, 1}},
+        {{5.5, 10.5}, {5.5, 10.5}}};
+    for(const auto& candidate : candidates) {
+        const bool expected =
+            std::any_of(walls.cbegin(), walls.cend(), [&candidate](const auto& wall) {
+                return intersects(candidate, wall);
+            });
+        EXPECT_EQ(collisionGeometry.IntersectsAny(candidate), expected)
+            << fmt::format("{}", candidate);
+    }
+}
+
+TEST_F(LongDiagonalRectangle, LineSegmentsInDistanceToMatchesAllSegments)
+{
+    const std::vector<LineSegment> walls{
+        {{-11., -13.}, {5., 11.}},
+        {{5., 11.}, {6., 10.}},
+        {{6., 10.}, {-10., -14.}},
+        {{-10., -14.}, {-11., -13.}}};
+    const std::vector<Point> positions{{0, 0}, {-10.5, -13.5}, {5.5, 10.5}, {20, 0}, {-100, 100}};
+    for(const auto& position : positions) {
+        for(const double distance : {0.0, 0.5, 1.0, 3.0, 10.0, 1000.0}) {
+            std::vector<LineSegment> expected{};
+            std::copy_if(
+                walls.cbegin(),
+                walls.cend(),
+                std::back_inserter(expected),
+                [&position, distance](const auto& wall) {
+                    return wall.DistTo(position) <= distance;
+                });
+            EXPECT_EQ(collisionGeometry.LineSegmentsInDistanceTo(distance, position), expected)
+                << fmt::format("{} {}", position, distance);
+        }
+    }
+}
+
+TEST(InsideGeometry, MatchesExactTestWithHoles)
+{
+    const auto outer = constructPolyFromPoints({{0, 0}, {30, 0}, {30, 20}, {0, 20}});
+    const std::vector<Poly> holes{
+        constructPolyFromPoints({{10, 10}, {10, 14}, {14, 14}, {14, 10}}).outer_boundary(),
+        constructPolyFromPoints({{20, 2}, {20, 3}, {21, 3}, {21, 2}}).outer_boundary()};
+    const PolyWithHoles polygon(outer.outer_boundary(), holes.begin(), holes.end());
+    const CollisionGeometry geometry(polygon);
+
+    for(double x = -10; x <= 40; x += 0.25) {
+        for(double y = -10; y <= 30; y += 0.25) {
+            const bool expected =
+                CGAL::oriented_side(K::Point_2(x, y), polygon) != CGAL::ON_NEGATIVE_SIDE;
+            ASSERT_EQ(geometry.InsideGeometry({x, y}), expected) << fmt::format("{}, {}", x, y);
+        }
+    }
+}
+
+TEST(SparseGrid, MatchesExactQueries)
+{
+    // The spike stretches the bounds beyond 'MAX_DENSE_CELLS' cells
+    const auto polygon =
+        constructPolyFromPoints({{0, 0}, {30, 0}, {30, 20}, {5000, 5000}, {0, 20}});
+    const std::vector<LineSegment> walls{
+        {{0, 0}, {30, 0}},
+        {{30, 0}, {30, 20}},
+        {{30, 20}, {5000, 5000}},
+        {{5000, 5000}, {0, 20}},
+        {{0, 20}, {0, 0}}};
+    const CollisionGeometry geometry(polygon);
+    ASSERT_FALSE(geometry.IsDense());
+
+    std::vector<Point> positions{};
+    for(double x = -6; x <= 36; x += 0.5) {
+        for(double y = -6; y <= 26; y += 0.5) {
+            positions.emplace_back(x, y);
+        }
+    }
+    for(double t = 0; t <= 1; t += 0.01) {
+        positions.emplace_back(30 + t * 4970, 20 + t * 4980);
+        positions.emplace_back(2000 * t, 4000 * t);
+    }
+    for(const auto& p : positions) {
+        const bool inside =
+            CGAL::oriented_side(K::Point_2(p.x, p.y), polygon) != CGAL::ON_NEGATIVE_SIDE;
+        ASSERT_EQ(geometry.InsideGeometry(p), inside) << fmt::format("{}", p);
+        std::vector<LineSegment> expected{};
+        std::copy_if(
+            walls.cbegin(), walls.cend(), std::back_inserter(expected), [&p](const auto& wall) {
+                return wall.DistTo(p) <= 2;
+            });
+        ASSERT_EQ(geometry.LineSegmentsInDistanceTo(2, p), expected) << fmt::format("{}", p);
+        const auto approx = geometry.LineSegmentsInApproxDistanceTo(p);
+        for(const auto& wall : expected) {
+            ASSERT_NE(std::find(approx.begin(), approx.end(), wall), approx.end())
+                << fmt::format("{}", p);
+        }
+        const LineSegment candidate{p, p + Point{3, 1}};
+        ASSERT_EQ(
+            geometry.IntersectsAny(candidate),
+            std::any_of(walls.cbegin(), walls.cend(), [&candidate](const auto& wall) {
+                return intersects(candidate, wall);
+            }))
+            << fmt::format("{}", p);
+    }
+}
+
+class CollisionGeometryWithObstacle : public ::testing::Test
+{
+protected:
+    const Poly outer{
+        constructPolyFromPoints({{0, 0}, {30, 0}, {30, 20}, {0, 20}}).outer_boundary()};
+    const Poly hole{
+        constructPolyFromPoints({{20, 2}, {20, 3}, {21, 3}, {21, 2}}).outer_boundary()};
+    const Poly obstacle{
+        constructPolyFromPoints({{9.5, 10}, {14, 10}, {14, 13.5}, {9.5, 13.5}}).outer_boundary()};
+
+    static void
+    ExpectSameQueries(const CollisionGeometry& actual, const CollisionGeometry& expected)
+    {
+        for(double x = -6; x <= 36; x += 0.5) {
+            for(double y = -6; y <= 26; y += 0.5) {
+                const Point p{x, y};
+                const auto actualApprox = actual.LineSegmentsInApproxDistanceTo(p);
+                const auto expectedApprox = expected.LineSegmentsInApproxDistanceTo(p);
+                ASSERT_TRUE(std::equal(
+                    actualApprox.begin(),
+                    actualApprox.end(),
+                    expectedApprox.begin(),
+                    expectedApprox.end()))
+                    << fmt::format("{}", p);
+                ASSERT_EQ(
+                    actual.LineSegmentsInDistanceTo(2, p), expected.LineSegmentsInDistanceTo(2, p))
+                    << fmt::format("{}", p);
+                ASSERT_EQ(actual.InsideGeometry(p), expected.InsideGeometry(p))
+                    << fmt::format("{}", p);
+                ASSERT_EQ(
+                    actual.IntersectsAny({p, p + Point{3, 1}}),
+                    expected.IntersectsAny({p, p + Point{3, 1}}))
+                    << fmt::format("{}", p);
+            }
+        }
+    }
+};
+
+TEST_F(CollisionGeometryWithObstacle, MatchesGeometryBuiltWithHole)
+{
+    const std::vector<Poly> holes{hole};
+    const CollisionGeometry base(PolyWithHoles(outer, holes.begin(), holes.end()));
+
+    auto obstacleHole = obstacle;
+    obstacleHole.reverse_orientation();
+    const std::vector<Poly> allHoles{hole, obstacleHole};
+    const CollisionGeometry expected(PolyWithHoles(outer, allHoles.begin(), allHoles.end()));
+
+    const auto withObstacle = base.WithObstacle(obstacle);
+    ExpectSameQueries(withObstacle, expected);
+    ASSERT_FALSE(withObstacle.InsideGeometry({12, 12}));
+    ASSERT_EQ(std::get<1>(withObstacle.AccessibleArea()).size(), 2);
+
+    ExpectSameQueries(withObstacle.WithoutObstacle(obstacle), base);
+}
+
+TEST_F(CollisionGeometryWithObstacle, RemovingFirstHoleKeepsLaterHoles)
+{
+    const auto geometry = CollisionGeometry(PolyWithHoles(outer)).WithObstacle(obstacle);
+    const auto withBoth = geometry.WithObstacle(hole);
+
+    const std::vector<Poly> holes{hole};
+    ExpectSameQueries(
+        withBoth.WithoutObstacle(obstacle),
+        CollisionGeometry(PolyWithHoles(outer, holes.begin(), holes.end())));
+}
+
+TEST_F(CollisionGeometryWithObstacle, UpdatesSparseGrid)
+{
+    const auto spike =
+        constructPolyFromPoints({{0, 0}, {30, 0}, {30, 20}, {5000, 5000}, {0, 20}})
+            .outer_boundary();
+    const CollisionGeometry base{PolyWithHoles(spike)};
+    ASSERT_FALSE(base.IsDense());
+
+    auto obstacleHole = obstacle;
+    obstacleHole.reverse_orientation();
+    const std::vector<Poly> holes{obstacleHole};
+    const auto withObstacle = base.WithObstacle(obstacle);
+    ExpectSameQueries(
+        withObstacle, CollisionGeometry(PolyWithHoles(spike, holes.begin(), holes.end())));
+    ExpectSameQueries(withObstacle.WithoutObstacle(obstacle), base);
+}
+
+TEST_F(CollisionGeometryWithObstacle, RejectsInvalidObstacles)
+{
+    const CollisionGeometry geometry(PolyWithHoles(outer, &hole, &hole + 1));
+
+    // Crossing the outer boundary
+    EXPECT_THROW(
+        geometry.WithObstacle(
+            constructPolyFromPoints({{-1, 5}, {2, 5}, {2, 6}, {-1, 6}}).outer_boundary()),
+        SimulationError);
+    // Outside of the accessible area
+    EXPECT_THROW(
+        geometry.WithObstacle(
+            constructPolyFromPoints({{40, 5}, {42, 5}, {42, 6}, {40, 6}}).outer_boundary()),
+        SimulationError);
+    // Containing an existing hole
+    EXPECT_THROW(
+        geometry.WithObstacle(
+            constructPolyFromPoints({{19, 1}, {22, 1}, {22, 4}, {19, 4}}).outer_boundary()),
+        SimulationError);
+    // Not part of the geometry
+    EXPECT_THROW(geometry.WithoutObstacle(obstacle), SimulationError);
+}
@@ -6,6 +6,7 @@
 #include "OperationalModels/CustomModel/CustomModel.hpp"
 #include "OperationalModels/CustomModel/CustomModelData.hpp"
 #include "OperationalModels/CustomModel/CustomModelUpdate.hpp"
+#include "ThreadPool.hpp"
 
 #include <fmt/format.h>
 #include <gtest/gtest.h>
@@ -168,7 +169,8 @@ TEST(CustomModel, RunsThroughOperationalDecisionSystem)
     neighborhoodSearch.Update(agents);
 
     OperationalDecisionSystem system{std::make_unique<MinimalCustomModel>()};
-    system.Run(0.5, 0.0, neighborhoodSearch, geometry, agents);
+    ThreadPool threadPool{};
+    system.Run(0.5, 0.0, neighborhoodSearch, geometry, agents, threadPool);
 
     const auto& agent = agents.front();
     const auto& state = std::get<CustomModelData>(agent.model).Get<MinimalState>();
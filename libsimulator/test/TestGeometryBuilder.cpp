@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "GeometryBuilder.hpp"
+
+#include "AABB.hpp"
+#include "CollisionGeometry.hpp"
+#include "Point.hpp"
+#include "SimulationError.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+std::vector<Point> rectangle(double xmin, double ymin, double xmax, double ymax)
+{
+    return {{xmin, ymin}, {xmax, ymin}, {xmax, ymax}, {xmin, ymax}};
+}
+
+/// Row of 'count' overlapping rooms with two overlapping exclusions in every room.
+CollisionGeometry buildRow(size_t count, size_t threadCount)
+{
+    GeometryBuilder builder(threadCount);
+    for(size_t index = 0; index < count; ++index) {
+        const auto x = 10. * static_cast<double>(index);
+        builder.AddAccessibleArea(rectangle(x, 0, x + 12, 10));
+        builder.ExcludeFromAccessibleArea(rectangle(x + 2, 2, x + 5, 5));
+        builder.ExcludeFromAccessibleArea(rectangle(x + 4, 4, x + 7, 7));
+    }
+    return builder.Build();
+}
+} // namespace
+
+TEST(GeometryBuilder, UnitesOverlappingAccessibleAreas)
+{
+    const auto geometry = buildRow(9, 4);
+    const auto& [boundary, holes] = geometry.AccessibleArea();
+    const AABB bounds(boundary);
+    ASSERT_DOUBLE_EQ(bounds.xmin, 0);
+    ASSERT_DOUBLE_EQ(bounds.xmax, 92);
+    ASSERT_DOUBLE_EQ(bounds.ymin, 0);
+    ASSERT_DOUBLE_EQ(bounds.ymax, 10);
+    ASSERT_EQ(holes.size(), 9);
+    for(size_t index = 0; index < 9; ++index) {
+        const auto x = 10. * static_cast<double>(index);
+        ASSERT_TRUE(geometry.InsideGeometry({x + 1, 1}));
+        ASSERT_TRUE(geometry.InsideGeometry({x + 9, 9}));
+        ASSERT_FALSE(geometry.InsideGeometry({x + 3, 3}));
+        ASSERT_FALSE(geometry.InsideGeometry({x + 6, 6}));
+    }
+}
+
+TEST(GeometryBuilder, ResultDoesNotDependOnThreadCount)
+{
+    for(size_t count : {1, 2, 5, 16}) {
+        const auto expected = buildRow(count, 1);
+        for(size_t threadCount : {2, 3, 8}) {
+            ASSERT_EQ(buildRow(count, threadCount).AccessibleArea(), expected.AccessibleArea());
+        }
+    }
+}
+
+TEST(GeometryBuilder, RejectsDisconnectedAccessibleAreas)
+{
+    GeometryBuilder builder(2);
+    builder.AddAccessibleArea(rectangle(0, 0, 10, 10));
+    builder.AddAccessibleArea(rectangle(5, 5, 15, 15));
+    builder.AddAccessibleArea(rectangle(20, 0, 30, 10));
+    ASSERT_THROW(builder.Build(), SimulationError);
+}
+
+TEST(GeometryBuilder, RejectsExclusionsSplittingTheAccessibleArea)
+{
+    GeometryBuilder builder(2);
+    builder.AddAccessibleArea(rectangle(0, 0, 30, 10));
+    builder.ExcludeFromAccessibleArea(rectangle(10, -1, 12, 6));
+    builder.ExcludeFromAccessibleArea(rectangle(10, 5, 12, 11));
+    ASSERT_THROW(builder.Build(), SimulationError);
+}
+
+TEST(GeometryBuilder, RejectsZeroThreads)
+{
+    GeometryBuilder builder(0);
+    builder.AddAccessibleArea(rectangle(0, 0, 30, 10));
+    ASSERT_THROW(builder.Build(), SimulationError);
+}
@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "GeometryCache.hpp"
+
+#include "CfgCgal.hpp"
+#include "CollisionGeometry.hpp"
+#include "Point.hpp"
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+namespace
+{
+Poly makePoly(const std::vector<Point>& points)
+{
+    Poly polygon{};
+    for(const auto& p : points) {
+        polygon.push_back(K::Point_2(p.x, p.y));
+    }
+    return polygon;
+}
+} // namespace
+
+class GeometryCacheTest : public ::testing::Test
+{
+protected:
+    std::filesystem::path directory{};
+    const Poly outer{makePoly({{0, 0}, {30, 0}, {30, 20}, {0, 20}})};
+    const Poly hole{makePoly({{10, 12}, {14, 12}, {14, 8}, {10, 8}})};
+    const GeometryCache::Input input{{outer}, {hole}};
+    int buildCount{0};
+
+    void SetUp() override
+    {
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        directory = std::filesystem::temp_directory_path() /
+                    fmt::format("jps-geometry-cache-{}", info->name());
+        std::filesystem::remove_all(directory);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(directory); }
+
+    CollisionGeometry Build()
+    {
+        ++buildCount;
+        const std::vector<Poly> holes{hole};
+        return CollisionGeometry(PolyWithHoles(outer, holes.begin(), holes.end()));
+    }
+
+    static void
+    ExpectSameQueries(const CollisionGeometry& actual, const CollisionGeometry& expected)
+    {
+        ASSERT_EQ(actual.AccessibleArea(), expected.AccessibleArea());
+        for(double x = -6; x <= 36; x += 0.5) {
+            for(double y = -6; y <= 26; y += 0.5) {
+                const Point p{x, y};
+                const auto actualApprox = actual.LineSegmentsInApproxDistanceTo(p);
+                const auto expectedApprox = expected.LineSegmentsInApproxDistanceTo(p);
+                ASSERT_TRUE(std::equal(
+                    actualApprox.begin(),
+                    actualApprox.end(),
+                    expectedApprox.begin(),
+                    expectedApprox.end()))
+                    << fmt::format("{}", p);
+                ASSERT_EQ(
+                    actual.LineSegmentsInDistanceTo(2, p), expected.LineSegmentsInDistanceTo(2, p))
+                    << fmt::format("{}", p);
+                ASSERT_EQ(actual.InsideGeometry(p), expected.InsideGeometry(p))
+                    << fmt::format("{}", p);
+            }
+        }
+    }
+};
+
+TEST_F(GeometryCacheTest, SecondBuildIsLoadedFromCache)
+{
+    const GeometryCache cache(directory);
+    const auto built = cache.LoadOrBuild(input, [this]() { return Build(); });
+    ASSERT_EQ(buildCount, 1);
+    ASSERT_TRUE(std::filesystem::exists(cache.EntryPath(GeometryCache::Key(input))));
+
+    const auto loaded = cache.LoadOrBuild(input, [this]() { return Build(); });
+    ASSERT_EQ(buildCount, 1);
+    ExpectSameQueries(loaded, built);
+    ExpectSameQueries(loaded, Build());
+}
+
+TEST_F(GeometryCacheTest, CorruptEntryIsRebuilt)
+{
+    const GeometryCache cache(directory);
+    cache.LoadOrBuild(input, [this]() { return Build(); });
+    const auto path = cache.EntryPath(GeometryCache::Key(input));
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+    ASSERT_FALSE(cache.Load(input));
+
+    const auto rebuilt = cache.LoadOrBuild(input, [this]() { return Build(); });
+    ASSERT_EQ(buildCount, 2);
+    const auto loaded = cache.Load(input);
+    ASSERT_TRUE(loaded);
+    ExpectSameQueries(*loaded, rebuilt);
+}
+
+TEST_F(GeometryCacheTest, MissingEntryIsNotLoaded)
+{
+    const GeometryCache cache(directory);
+    cache.LoadOrBuild(input, [this]() { return Build(); });
+    ASSERT_FALSE(GeometryCache(directory / "missing").Load(input));
+}
+
+TEST_F(GeometryCacheTest, EntryIsOnlyLoadedForItsInput)
+{
+    // Copying the entry simulates two inputs whose keys collide
+    const GeometryCache cache(directory);
+    cache.LoadOrBuild(input, [this]() { return Build(); });
+    const GeometryCache::Input other{{outer}, {}};
+    std::filesystem::copy_file(
+        cache.EntryPath(GeometryCache::Key(input)), cache.EntryPath(GeometryCache::Key(other)));
+    ASSERT_FALSE(cache.Load(other));
+    ASSERT_TRUE(cache.Load(input));
+}
+
+TEST_F(GeometryCacheTest, KeyDependsOnInput)
+{
+    const auto key = GeometryCache::Key(input);
+    ASSERT_EQ(key, GeometryCache::Key({{outer}, {hole}}));
+    ASSERT_NE(key, GeometryCache::Key({{outer}, {}}));
+    ASSERT_NE(key, GeometryCache::Key({{outer, hole}, {}}));
+
+    const auto moved = makePoly({{10, 12.000001}, {14, 12}, {14, 8}, {10, 8}});
+    ASSERT_NE(key, GeometryCache::Key({{outer}, {moved}}));
+}
@@ -5,7 +5,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <random>
+#include <vector>
 
 const double PI = acos(-1);
 
@@ -110,3 +112,48 @@ TEST(LineSegment, OperatorLTCaseC)
     ASSERT_FALSE(b < a);
     ASSERT_FALSE(a < a);
 }
+
+TEST(LineSegment, IntersectsAnyIsFalseWithoutSegments)
+{
+    const LineSegment l{{0, 0}, {1, 1}};
+    ASSERT_FALSE(intersectsAny(l, {}));
+}
+
+TEST(LineSegment, IntersectsAnyDetectsTouchingAndCollinearSegments)
+{
+    const LineSegment l{{0, 0}, {0, 6}};
+    const std::vector<LineSegment> disjoint{{{1, 0}, {1, 6}}, {{0, 7}, {0, 8}}};
+    ASSERT_FALSE(intersectsAny(l, disjoint));
+    ASSERT_TRUE(intersectsAny(l, std::vector<LineSegment>{{{0, 6}, {0, 8}}}));
+    ASSERT_TRUE(intersectsAny(l, std::vector<LineSegment>{{{-1, 3}, {0, 3}}}));
+}
+
+TEST(LineSegment, IntersectsAnyMatchesIntersects)
+{
+    std::mt19937 gen(42);
+    // Coordinates on a coarse grid produce many touching and collinear segments, the continuous
+    // ones mostly proper crossings and misses.
+    std::uniform_int_distribution<int> grid(-8, 8);
+    std::uniform_real_distribution<double> continuous(-2, 2);
+    const auto randomSegment = [&](bool onGrid) {
+        if(onGrid) {
+            return LineSegment{
+                {grid(gen) * 0.25, grid(gen) * 0.25}, {grid(gen) * 0.25, grid(gen) * 0.25}};
+        }
+        return LineSegment{
+            {continuous(gen), continuous(gen)}, {continuous(gen), continuous(gen)}};
+    };
+
+    for(int run = 0; run < 2000; ++run) {
+        const bool onGrid = run % 2 == 0;
+        const auto segment = randomSegment(onGrid);
+        std::vector<LineSegment> walls{};
+        for(int index = 0; index < run % 20; ++index) {
+            walls.push_back(randomSegment(onGrid));
+        }
+        const bool expected = std::any_of(walls.cbegin(), walls.cend(), [&](const auto& wall) {
+            return intersects(segment, wall);
+        });
+        ASSERT_EQ(intersectsAny(segment, walls), expected) << fmt::format("{}", segment);
+    }
+}
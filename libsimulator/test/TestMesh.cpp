@@ -6,6 +6,8 @@
 #include <glm/vec2.hpp>
 #include <gtest/gtest.h>
 
+#include <cstddef>
+
 class SingleTriangeMesh : public ::testing::Test
 {
 public:
@@ -82,3 +84,46 @@ TEST_F(DoubleBottleNeckMesh, RegressionInContains)
         m->FindContainingPolygon({26.690912185191067, 4.94908998002494}),
         Mesh::Polygon::InvalidIndex);
 }
+
+/// Index of the first polygon of 'mesh' containing 'p', found by testing every polygon.
+static size_t findContainingPolygonLinear(const Mesh& mesh, glm::dvec2 p)
+{
+    for(size_t index = 0; index < mesh.CountPolygons(); ++index) {
+        if(!mesh.AxisAlignedBoundingBox(index).Inside({p.x, p.y})) {
+            continue;
+        }
+        const auto& vertices = mesh.Polygons(index).vertices;
+        bool inside = true;
+        for(size_t corner = 0; corner < vertices.size(); ++corner) {
+            const auto a = mesh.Vertex(vertices[corner]);
+            const auto b = mesh.Vertex(vertices[(corner + 1) % vertices.size()]);
+            inside = inside && (p.y - a.y) * (b.x - a.x) - (p.x - a.x) * (b.y - a.y) >= 0;
+        }
+        if(inside) {
+            return index;
+        }
+    }
+    return Mesh::Polygon::InvalidIndex;
+}
+
+TEST_F(DoubleBottleNeckMesh, FindContainingPolygonMatchesLinearSearch)
+{
+    const auto expectSameAsLinearSearch = [this]() {
+        for(double x = -1; x <= 29; x += 0.2) {
+            for(double y = -1; y <= 11; y += 0.2) {
+                ASSERT_EQ(m->FindContainingPolygon({x, y}), findContainingPolygonLinear(*m, {x, y}))
+                    << x << ", " << y;
+            }
+        }
+    };
+    expectSameAsLinearSearch();
+    EXPECT_NE(m->FindContainingPolygon({5, 5}), Mesh::Polygon::InvalidIndex);
+    EXPECT_EQ(m->FindContainingPolygon({20, 11}), Mesh::Polygon::InvalidIndex);
+
+    m->MergeGreedy();
+    expectSameAsLinearSearch();
+    EXPECT_NE(m->FindContainingPolygon({5, 5}), Mesh::Polygon::InvalidIndex);
+    EXPECT_NE(
+        m->FindContainingPolygon({26.690912185191067, 4.94908998002494}),
+        Mesh::Polygon::InvalidIndex);
+}
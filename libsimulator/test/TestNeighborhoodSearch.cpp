@@ -1,13 +1,18 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
+#include "AABB.hpp"
 #include "GenericAgent.hpp"
 #include "NeighborhoodSearch.hpp"
 
 #include <gtest/gtest.h>
 
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <iterator>
 #include <memory>
+#include <set>
+#include <vector>
 
 template <typename T>
 struct ValueWithPos {
@@ -15,6 +20,12 @@ struct ValueWithPos {
     T val;
 };
 
+template <typename T>
+struct ValueWithId {
+    Point pos{};
+    T id;
+};
+
 TEST(NeighborhoodSearch, ReturnsEmptyOnEmpty)
 {
     NeighborhoodSearch<ValueWithPos<int>> neighborhood{3};
@@ -124,3 +135,263 @@ TEST(NeighborhoodSearch, ReturnsValueExactlyDistanceAwayFromQueryPoint)
         [](const auto& v) { return v.val; });
     ASSERT_EQ(actual, expected);
 }
+
+TEST(NeighborhoodSearch, UsesDenseGridForBoundedAreas)
+{
+    NeighborhoodSearch<ValueWithPos<int>> neighborhood{3, AABB{Point{-20, -20}, Point{20, 20}}};
+    ASSERT_TRUE(neighborhood.IsDense());
+}
+
+TEST(NeighborhoodSearch, FallsBackToHashGridForLargeAreas)
+{
+    NeighborhoodSearch<ValueWithPos<int>> neighborhood{1, AABB{Point{0, 0}, Point{1e5, 1e5}}};
+    ASSERT_FALSE(neighborhood.IsDense());
+}
+
+TEST(NeighborhoodSearch, DenseGridMatchesHashGrid)
+{
+    AgentContainer<ValueWithPos<int>> agents{};
+    for(int index = 0; index < 500; ++index) {
+        const Point pos{std::fmod(index * 7.31, 40.0) - 20, std::fmod(index * 3.17, 40.0) - 20};
+        agents.push_back({pos, index});
+    }
+    NeighborhoodSearch<ValueWithPos<int>> hashed{2.2};
+    NeighborhoodSearch<ValueWithPos<int>> dense{2.2, AABB{Point{-20, -20}, Point{20, 20}}};
+    hashed.Update(agents);
+    dense.Update(agents);
+
+    for(const auto& agent : agents) {
+        for(const double radius : {0.5, 2.2, 5.0}) {
+            std::set<int> expected{};
+            for(const auto& v : hashed.GetNeighboringAgents(agent.pos, radius)) {
+                expected.insert(v.val);
+            }
+            std::set<int> actual{};
+            for(const auto& v : dense.GetNeighboringAgents(agent.pos, radius)) {
+                actual.insert(v.val);
+            }
+            ASSERT_EQ(actual, expected);
+        }
+    }
+}
+
+TEST(NeighborhoodSearch, DenseGridFindsValuesOutsideOfBounds)
+{
+    NeighborhoodSearch<ValueWithPos<int>> neighborhood{1, AABB{Point{0, 0}, Point{10, 10}}};
+    const AgentContainer<ValueWithPos<int>> agents{{{-0.5, 5}, 1}, {{10.5, 10.5}, 2}};
+    neighborhood.Update(agents);
+
+    ASSERT_EQ(neighborhood.GetNeighboringAgents({0.2, 5}, 1).size(), 1);
+    ASSERT_EQ(neighborhood.GetNeighboringAgents({11, 11}, 1).size(), 1);
+    ASSERT_EQ(neighborhood.GetNeighboringAgents({5, 5}, 1).size(), 0);
+}
+
+TEST(NeighborhoodSearch, DenseGridFindsValuesAddedAfterUpdate)
+{
+    NeighborhoodSearch<ValueWithPos<int>> neighborhood{1, AABB{Point{0, 0}, Point{10, 10}}};
+    AgentContainer<ValueWithPos<int>> agents{{{1, 1}, 1}};
+    neighborhood.Update(agents);
+    agents.push_back({{2, 2}, 2});
+    neighborhood.AddAgent(agents.back());
+
+    ASSERT_EQ(neighborhood.GetNeighboringAgents({1.5, 1.5}, 1).size(), 2);
+}
+
+TEST(NeighborhoodSearch, DenseGridSeesRefreshedPositions)
+{
+    NeighborhoodSearch<ValueWithPos<int>> neighborhood{1, AABB{Point{0, 0}, Point{10, 10}}};
+    AgentContainer<ValueWithPos<int>> agents{{{5.9, 5.9}, 1}, {{5, 5}, 2}};
+    neighborhood.Update(agents);
+    agents.front().pos = {5.3, 5.3};
+    ASSERT_EQ(neighborhood.GetNeighboringAgents({5, 5}, 1).size(), 1);
+
+    neighborhood.RefreshPositions(agents);
+    ASSERT_EQ(neighborhood.GetNeighboringAgents({5, 5}, 1).size(), 2);
+}
+
+TEST(NeighborhoodSearch, DenseGridRefreshesPositionsAfterRemovingValues)
+{
+    for(const auto skin : {0.0, 0.5}) {
+        NeighborhoodSearch<ValueWithId<int>> neighborhood{1, AABB{Point{0, 0}, Point{10, 10}}};
+        if(skin > 0) {
+            neighborhood.EnableVerletLists(1, skin);
+        }
+        AgentContainer<ValueWithId<int>> agents{{{1, 1}, 1}, {{5, 5}, 2}, {{9, 9}, 3}};
+        neighborhood.Update(agents);
+        neighborhood.RemoveAgent(agents.front());
+        agents.erase(agents.begin());
+        agents.back().pos = {5.5, 5.5};
+
+        neighborhood.RefreshPositions(agents);
+        ASSERT_EQ(neighborhood.GetNeighboringAgents({5, 5}, 1).size(), 2);
+        neighborhood.Update(agents);
+        ASSERT_EQ(neighborhood.GetNeighboringAgents({5, 5}, 1).size(), 2);
+        ASSERT_EQ(neighborhood.GetNeighboringAgents({1, 1}, 1).size(), 0);
+    }
+}
+
+TEST(NeighborhoodSearch, BufferAndCallbackQueriesMatchCopyingQuery)
+{
+    AgentContainer<ValueWithPos<int>> agents{};
+    for(int index = 0; index < 200; ++index) {
+        agents.push_back({{std::fmod(index * 7.31, 20.0), std::fmod(index * 3.17, 20.0)}, index});
+    }
+    for(auto neighborhood : {
+            NeighborhoodSearch<ValueWithPos<int>>{2.2},
+            NeighborhoodSearch<ValueWithPos<int>>{2.2, AABB{Point{0, 0}, Point{20, 20}}}}) {
+        neighborhood.Update(agents);
+        std::vector<const ValueWithPos<int>*> buffer{{nullptr}};
+        for(const auto& agent : agents) {
+            std::vector<int> expected{};
+            for(const auto& v : neighborhood.GetNeighboringAgents(agent.pos, 2.2)) {
+                expected.push_back(v.val);
+            }
+            neighborhood.GetNeighboringAgents(agent.pos, 2.2, buffer);
+            std::vector<int> fromBuffer{};
+            for(const auto* v : buffer) {
+                fromBuffer.push_back(v->val);
+            }
+            std::vector<int> fromCallback{};
+            neighborhood.ForEachNeighboringAgent(
+                agent.pos, 2.2, [&fromCallback](const auto& v) { fromCallback.push_back(v.val); });
+            ASSERT_EQ(fromBuffer, expected);
+            ASSERT_EQ(fromCallback, expected);
+        }
+    }
+}
+
+TEST(NeighborhoodSearch, VerletListsMatchGridQueries)
+{
+    AgentContainer<ValueWithPos<int>> agents{};
+    for(int index = 0; index < 300; ++index) {
+        agents.push_back({{std::fmod(index * 7.31, 20.0), std::fmod(index * 3.17, 20.0)}, index});
+    }
+    for(auto neighborhood : {
+            NeighborhoodSearch<ValueWithPos<int>>{2.2},
+            NeighborhoodSearch<ValueWithPos<int>>{2.2, AABB{Point{0, 0}, Point{20, 20}}}}) {
+        NeighborhoodSearch<ValueWithPos<int>> reference{2.2};
+        neighborhood.EnableVerletLists(3, 0.4);
+        ASSERT_TRUE(neighborhood.UsesVerletLists());
+        auto moving = agents;
+        std::vector<const ValueWithPos<int>*> buffer{};
+        // Moves of 0.03 per step require a rebuild every few steps only, positions cross cell
+        // borders in between
+        for(int step = 0; step < 20; ++step) {
+            neighborhood.Update(moving);
+            reference.Update(moving);
+            for(const auto& agent : moving) {
+                for(const double radius : {1.0, 3.0, 4.0}) {
+                    std::set<int> expected{};
+                    for(const auto& v : reference.GetNeighboringAgents(agent.pos, radius)) {
+                        expected.insert(v.val);
+                    }
+                    neighborhood.GetNeighboringAgentsOf(agent, radius, buffer);
+                    std::set<int> fromList{};
+                    for(const auto* v : buffer) {
+                        fromList.insert(v->val);
+                    }
+                    std::set<int> fromGrid{};
+                    neighborhood.ForEachNeighboringAgent(
+                        agent.pos, radius, [&fromGrid](const auto& v) { fromGrid.insert(v.val); });
+                    ASSERT_EQ(fromList, expected);
+                    ASSERT_EQ(fromGrid, expected);
+                }
+            }
+            for(auto& agent : moving) {
+                const auto dx = agent.val % 2 == 0 ? 0.03 : -0.03;
+                const auto dy = agent.val % 3 == 0 ? 0.03 : 0.0;
+                agent.pos += Point{dx, dy};
+            }
+        }
+    }
+}
+
+TEST(NeighborhoodSearch, VerletListsAreRebuiltAfterAddingValues)
+{
+    NeighborhoodSearch<ValueWithPos<int>> neighborhood{1, AABB{Point{0, 0}, Point{10, 10}}};
+    neighborhood.EnableVerletLists(1, 0.5);
+    AgentContainer<ValueWithPos<int>> agents{{{1, 1}, 1}};
+    neighborhood.Update(agents);
+    agents.push_back({{1.5, 1.5}, 2});
+    neighborhood.AddAgent(agents.back());
+
+    std::vector<const ValueWithPos<int>*> buffer{};
+    neighborhood.GetNeighboringAgentsOf(agents.front(), 1, buffer);
+    ASSERT_EQ(buffer.size(), 2);
+    neighborhood.Update(agents);
+    neighborhood.GetNeighboringAgentsOf(agents.front(), 1, buffer);
+    ASSERT_EQ(buffer.size(), 2);
+}
+
+TEST(NeighborhoodSearch, NeighborIndicesMatchPointerQueries)
+{
+    AgentContainer<ValueWithPos<int>> agents{};
+    for(int index = 0; index < 300; ++index) {
+        agents.push_back({{std::fmod(index * 7.31, 20.0), std::fmod(index * 3.17, 20.0)}, index});
+    }
+    for(const auto skin : {0.0, 0.4}) {
+        for(auto neighborhood : {
+                NeighborhoodSearch<ValueWithPos<int>>{2.2},
+                NeighborhoodSearch<ValueWithPos<int>>{2.2, AABB{Point{0, 0}, Point{20, 20}}}}) {
+            if(skin > 0) {
+                neighborhood.EnableVerletLists(3, skin);
+            }
+            auto moving = agents;
+            std::vector<Point> positions{};
+            std::vector<const ValueWithPos<int>*> buffer{};
+            std::vector<uint32_t> indices{};
+            for(int step = 0; step < 10; ++step) {
+                neighborhood.Update(moving);
+                positions.clear();
+                for(const auto& agent : moving) {
+                    positions.push_back(agent.pos);
+                }
+                for(size_t index = 0; index < moving.size(); ++index) {
+                    for(const double radius : {1.0, 3.0, 4.0}) {
+                        neighborhood.GetNeighboringAgentsOf(moving[index], radius, buffer);
+                        std::set<int> expected{};
+                        for(const auto* v : buffer) {
+                            expected.insert(v->val);
+                        }
+                        neighborhood.GetNeighborIndicesOf(index, positions, radius, indices);
+                        std::set<int> actual{};
+                        for(const auto neighbor : indices) {
+                            actual.insert(moving[neighbor].val);
+                        }
+                        ASSERT_EQ(actual, expected);
+                        ASSERT_EQ(indices.size(), expected.size());
+                    }
+                }
+                for(auto& agent : moving) {
+                    agent.pos += Point{agent.val % 2 == 0 ? 0.03 : -0.03, 0.0};
+                }
+            }
+        }
+    }
+}
+
+TEST(NeighborhoodSearch, NeighborIndicesRequireUpdateAfterAddingValues)
+{
+    NeighborhoodSearch<ValueWithPos<int>> neighborhood{1, AABB{Point{0, 0}, Point{10, 10}}};
+    AgentContainer<ValueWithPos<int>> agents{{{1, 1}, 1}};
+    std::vector<uint32_t> indices{};
+    ASSERT_THROW(neighborhood.GetNeighborIndicesOf(0, {}, 1, indices), SimulationError);
+
+    neighborhood.Update(agents);
+    agents.push_back({{1.5, 1.5}, 2});
+    neighborhood.AddAgent(agents.back());
+    const std::vector<Point> positions{{1, 1}, {1.5, 1.5}};
+    ASSERT_THROW(neighborhood.GetNeighborIndicesOf(0, positions, 1, indices), SimulationError);
+
+    neighborhood.Update(agents);
+    neighborhood.GetNeighborIndicesOf(0, positions, 1, indices);
+    ASSERT_EQ(indices, (std::vector<uint32_t>{0, 1}));
+}
+
+TEST(NeighborhoodSearch, VerletListsRequirePositiveSkin)
+{
+    NeighborhoodSearch<ValueWithPos<int>> neighborhood{1};
+    ASSERT_THROW(neighborhood.EnableVerletLists(1, 0), SimulationError);
+    ASSERT_THROW(neighborhood.EnableVerletLists(-1, 0.5), SimulationError);
+    ASSERT_FALSE(neighborhood.UsesVerletLists());
+}
@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "PortalGraph.hpp"
+
+#include "GeometryBuilder.hpp"
+#include "Mesh.hpp"
+#include "Point.hpp"
+#include "RoutingEngine.hpp"
+#include "SimulationError.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace
+{
+double pathLength(const std::vector<Point>& path)
+{
+    double length = 0;
+    for(size_t index = 1; index < path.size(); ++index) {
+        length += Distance(path[index - 1], path[index]);
+    }
+    return length;
+}
+
+/// Hallway of 200m by 10m with a square pillar every 10m.
+std::unique_ptr<RoutingEngine> buildHallway()
+{
+    GeometryBuilder builder{};
+    builder.AddAccessibleArea({{0, 0}, {200, 0}, {200, 10}, {0, 10}});
+    for(double x = 0; x < 200; x += 10) {
+        builder.ExcludeFromAccessibleArea({{x + 4, 4}, {x + 6, 4}, {x + 6, 6}, {x + 4, 6}});
+    }
+    return std::make_unique<RoutingEngine>(builder.Build().Polygon());
+}
+
+const std::vector<Point> hallwayPositions{
+    {1, 1}, {2, 9}, {37, 5}, {75, 2}, {101, 8}, {150, 5}, {173, 1}, {199, 9}};
+} // namespace
+
+class Hallway : public ::testing::Test
+{
+public:
+    void SetUp() override { engine = buildHallway(); }
+
+protected:
+    std::unique_ptr<RoutingEngine> engine{};
+};
+
+TEST_F(Hallway, PartitionsIntoClusters)
+{
+    const PortalGraph graph(*engine->MeshData(), 1, 8);
+    EXPECT_GT(graph.CountClusters(), 10);
+    EXPECT_GT(graph.CountPortals(), graph.CountClusters() - 1);
+}
+
+TEST_F(Hallway, RouteIsSequenceOfAdjacentPolygons)
+{
+    const PortalGraph graph(*engine->MeshData(), 1, 8);
+    const auto& mesh = graph.MeshData();
+    for(const auto from : hallwayPositions) {
+        for(const auto to : hallwayPositions) {
+            const auto fromPolygon = engine->Locate(from);
+            const auto toPolygon = engine->Locate(to);
+            const auto route =
+                graph.ComputeRoute({from.x, from.y}, fromPolygon, {to.x, to.y}, toPolygon);
+            ASSERT_FALSE(route.polygons.empty());
+            EXPECT_EQ(route.polygons.front(), fromPolygon);
+            EXPECT_EQ(route.polygons.back(), toPolygon);
+            for(size_t index = 1; index < route.polygons.size(); ++index) {
+                const auto& neighbors = mesh.Polygons(route.polygons[index - 1]).neighbors;
+                EXPECT_NE(
+                    std::find(neighbors.begin(), neighbors.end(), route.polygons[index]),
+                    neighbors.end());
+            }
+        }
+    }
+}
+
+TEST_F(Hallway, RouteDoesNotDependOnThreadCount)
+{
+    const PortalGraph sequential(*engine->MeshData(), 1, 8);
+    const PortalGraph parallel(*engine->MeshData(), 4, 8);
+    ASSERT_EQ(parallel.CountPortals(), sequential.CountPortals());
+    for(const auto from : hallwayPositions) {
+        for(const auto to : hallwayPositions) {
+            const auto fromPolygon = engine->Locate(from);
+            const auto toPolygon = engine->Locate(to);
+            EXPECT_EQ(
+                parallel.ComputeRoute({from.x, from.y}, fromPolygon, {to.x, to.y}, toPolygon)
+                    .polygons,
+                sequential.ComputeRoute({from.x, from.y}, fromPolygon, {to.x, to.y}, toPolygon)
+                    .polygons);
+        }
+    }
+}
+
+TEST_F(Hallway, RouteInsideOfOnePolygon)
+{
+    const PortalGraph graph(*engine->MeshData(), 1, 8);
+    const auto polygon = engine->Locate({1, 1});
+    const auto route = graph.ComputeRoute({1, 1}, polygon, {1, 1.1}, polygon);
+    EXPECT_EQ(route.polygons, std::vector<size_t>{polygon});
+    EXPECT_EQ(route.expandedNodes, 0);
+}
+
+TEST_F(Hallway, RejectsInvalidParameters)
+{
+    EXPECT_THROW(PortalGraph(*engine->MeshData(), 0), SimulationError);
+    EXPECT_THROW(PortalGraph(*engine->MeshData(), 1, 0), SimulationError);
+}
+
+TEST_F(Hallway, HierarchicalCorridorIsCloseToTriangulationCorridor)
+{
+    const auto hierarchical = buildHallway();
+    hierarchical->SetAlgorithm(RoutingAlgorithm::Hierarchical);
+    for(const auto from : hallwayPositions) {
+        for(const auto to : hallwayPositions) {
+            const auto corridor = hierarchical->ComputeCorridor(from, to);
+            ASSERT_FALSE(corridor.faces.empty());
+            EXPECT_EQ(hierarchical->LocateInCorridor(corridor, 0, from), 0);
+            EXPECT_TRUE(hierarchical->LocateInCorridor(corridor, 0, to));
+            EXPECT_EQ(corridor.waypoints.front(), from);
+            EXPECT_EQ(corridor.waypoints.back(), to);
+            EXPECT_GE(pathLength(corridor.waypoints), Distance(from, to) - 1e-9);
+            EXPECT_LT(
+                pathLength(corridor.waypoints),
+                1.1 * pathLength(engine->ComputeAllWaypoints(from, to)) + 1);
+        }
+    }
+}
+
+TEST_F(Hallway, CloneKeepsHierarchicalAlgorithm)
+{
+    engine->SetAlgorithm(RoutingAlgorithm::Hierarchical);
+    const auto clone = engine->Clone();
+    EXPECT_EQ(clone->Algorithm(), RoutingAlgorithm::Hierarchical);
+    EXPECT_EQ(
+        clone->ComputeAllWaypoints({1, 1}, {199, 9}),
+        engine->ComputeAllWaypoints({1, 1}, {199, 9}));
+}
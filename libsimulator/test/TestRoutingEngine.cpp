@@ -0,0 +1,358 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "AABB.hpp"
+#include "CfgCgal.hpp"
+#include "GeometryBuilder.hpp"
+#include "Point.hpp"
+#include "RoutingEngine.hpp"
+#include "SimulationError.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class LShapedCorridor : public ::testing::Test
+{
+public:
+    static std::unique_ptr<RoutingEngine> Build()
+    {
+        GeometryBuilder builder{};
+        builder.AddAccessibleArea({{0, 0}, {10, 0}, {10, 10}, {8, 10}, {8, 2}, {0, 2}});
+        return std::make_unique<RoutingEngine>(builder.Build().Polygon());
+    }
+
+    void SetUp() override { engine = Build(); }
+
+protected:
+    std::unique_ptr<RoutingEngine> engine{};
+    const Point start{1, 1};
+    const Point destination{9, 9};
+};
+
+TEST_F(LShapedCorridor, CorridorMatchesWaypoints)
+{
+    const auto corridor = engine->ComputeCorridor(start, destination);
+    EXPECT_EQ(corridor.destination, destination);
+    EXPECT_FALSE(corridor.faces.empty());
+    EXPECT_EQ(corridor.waypoints, engine->ComputeAllWaypoints(start, destination));
+}
+
+TEST_F(LShapedCorridor, CanLocateStartAndDestination)
+{
+    const auto corridor = engine->ComputeCorridor(start, destination);
+    EXPECT_EQ(engine->LocateInCorridor(corridor, 0, start), 0);
+    EXPECT_EQ(engine->LocateInCorridor(corridor, 0, destination), corridor.faces.size() - 1);
+}
+
+TEST_F(LShapedCorridor, DoesNotLocatePositionsOutsideOfCorridor)
+{
+    const auto corridor = engine->ComputeCorridor(start, destination);
+    EXPECT_FALSE(engine->LocateInCorridor(corridor, 0, {-1, 1}));
+    EXPECT_FALSE(engine->LocateInCorridor(corridor, corridor.faces.size() - 1, start));
+}
+
+TEST_F(LShapedCorridor, NextWaypointMatchesFullSearch)
+{
+    const auto corridor = engine->ComputeCorridor(start, destination);
+    const std::vector<Point> positions{{1, 1}, {3, 1.5}, {6, 0.5}, {8.5, 1}, {9, 5}};
+    size_t face = 0;
+    for(const auto& position : positions) {
+        const auto located = engine->LocateInCorridor(corridor, face, position);
+        ASSERT_TRUE(located);
+        face = *located;
+        EXPECT_EQ(
+            engine->NextWaypointInCorridor(corridor, face, position),
+            engine->ComputeWaypoint(position, destination));
+    }
+}
+
+TEST_F(LShapedCorridor, NavigationFieldCorridorMatchesSearch)
+{
+    const auto field = engine->ComputeNavigationField(destination);
+    for(const auto& position : {Point{1, 1}, Point{5, 1}, Point{9, 1}, Point{9, 9}}) {
+        const auto corridor = engine->ComputeCorridor(field, position);
+        EXPECT_EQ(corridor.destination, destination);
+        EXPECT_EQ(corridor.waypoints, engine->ComputeAllWaypoints(position, destination));
+    }
+}
+
+TEST_F(LShapedCorridor, NavigationFieldDistancesAreFinite)
+{
+    const auto field = engine->ComputeNavigationField(destination);
+    size_t destinationFaces = 0;
+    for(size_t index = 0; index < field.distance.size(); ++index) {
+        EXPECT_LT(field.distance[index], 20.0);
+        if(field.next[index] == NavigationField::InvalidIndex) {
+            ++destinationFaces;
+            EXPECT_EQ(field.distance[index], 0.0);
+        }
+    }
+    EXPECT_EQ(destinationFaces, 1);
+}
+
+class RoomWithWall : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        GeometryBuilder builder{};
+        builder.AddAccessibleArea({{0, 0}, {20, 0}, {20, 10}, {0, 10}});
+        builder.ExcludeFromAccessibleArea({{9, 0}, {11, 0}, {11, 8}, {9, 8}});
+        engine = std::make_unique<RoutingEngine>(builder.Build().Polygon());
+    }
+
+protected:
+    std::unique_ptr<RoutingEngine> engine{};
+    const Point start{2, 2};
+    const Point destination{18, 2};
+};
+
+static double pathLength(const std::vector<Point>& path)
+{
+    double length = 0;
+    for(size_t index = 1; index < path.size(); ++index) {
+        length += Distance(path[index - 1], path[index]);
+    }
+    return length;
+}
+
+TEST_F(RoomWithWall, CorridorLeadsAroundWall)
+{
+    const auto corridor = engine->ComputeCorridor(start, destination);
+    EXPECT_EQ(corridor.waypoints.front(), start);
+    EXPECT_EQ(corridor.waypoints.back(), destination);
+    // Waypoints keep a clearance of up to 0.2m to the two corners of the wall
+    const auto shortest = 2 * std::sqrt(7. * 7. + 6. * 6.) + 2;
+    EXPECT_GE(pathLength(corridor.waypoints), shortest - 1e-9);
+    EXPECT_LT(pathLength(corridor.waypoints), shortest + 2 * 0.2);
+}
+
+TEST_F(RoomWithWall, RepeatedQueriesReuseNoStateOfEarlierQueries)
+{
+    const auto expected = engine->ComputeCorridor(start, destination);
+    const auto other = LShapedCorridor::Build();
+    for(size_t query = 0; query < 10; ++query) {
+        other->ComputeCorridor({1, 1}, {9, 9});
+        engine->ComputeCorridor(destination, {19, 9});
+        const auto corridor = engine->ComputeCorridor(start, destination);
+        EXPECT_EQ(corridor.faces, expected.faces);
+        EXPECT_EQ(corridor.waypoints, expected.waypoints);
+    }
+}
+
+TEST_F(RoomWithWall, ConcurrentQueriesMatchSequentialQuery)
+{
+    const auto expected = engine->ComputeCorridor(start, destination);
+    std::vector<std::vector<Point>> results(4);
+    std::vector<std::thread> threads{};
+    for(auto& result : results) {
+        threads.emplace_back([this, &result]() {
+            for(size_t query = 0; query < 20; ++query) {
+                result = engine->ComputeCorridor(start, destination).waypoints;
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    for(const auto& result : results) {
+        EXPECT_EQ(result, expected.waypoints);
+    }
+}
+
+TEST_F(RoomWithWall, LocateWithHintMatchesLocateWithoutHint)
+{
+    std::vector<Point> positions{};
+    for(double x = 0.137; x < 20; x += 0.731) {
+        for(double y = 0.113; y < 10; y += 0.617) {
+            if(x < 9 || x > 11 || y > 8) {
+                positions.emplace_back(x, y);
+            }
+        }
+    }
+    const auto last = engine->Locate(positions.back());
+    size_t previous = engine->Locate(positions.front());
+    for(const auto& position : positions) {
+        const auto expected = engine->Locate(position);
+        for(const auto hint : {RoutingEngine::NoFaceHint, size_t{0}, previous, last, last + 1}) {
+            ASSERT_EQ(engine->Locate(position, hint), expected);
+            ASSERT_TRUE(engine->IsRoutable(position, hint));
+        }
+        previous = expected;
+    }
+}
+
+TEST_F(RoomWithWall, LocateWithHintRejectsPositionsOutsideOfRoutableArea)
+{
+    const auto hint = engine->Locate({8.9, 1});
+    EXPECT_THROW(engine->Locate({10, 1}, hint), SimulationError);
+    EXPECT_THROW(engine->Locate({-1, 1}, hint), SimulationError);
+    EXPECT_FALSE(engine->IsRoutable({10, 1}, hint));
+}
+
+TEST_F(RoomWithWall, CorridorWithHintsMatchesCorridorWithoutHints)
+{
+    const auto expected = engine->ComputeCorridor(start, destination);
+    const auto corridor = engine->ComputeCorridor(
+        start,
+        destination,
+        expected.faces.back()->get_index(),
+        expected.faces.front()->get_index());
+    EXPECT_EQ(corridor.faces, expected.faces);
+    EXPECT_EQ(corridor.waypoints, expected.waypoints);
+}
+
+TEST_F(RoomWithWall, BatchMatchesSingleQueries)
+{
+    const std::vector<Point> origins{{2, 2}, {18, 2}, {5, 9}, {2, 2}};
+    const std::vector<Point> destinations{{18, 2}, {2, 2}, {15, 9}, {3, 3}};
+    const auto batch = engine->ComputeBatch(origins, destinations, 2, true);
+    ASSERT_EQ(batch.lengths.size(), origins.size());
+    ASSERT_EQ(batch.offsets.size(), origins.size() + 1);
+    EXPECT_EQ(batch.offsets.back(), batch.waypoints.size());
+    for(size_t index = 0; index < origins.size(); ++index) {
+        const auto expected = engine->ComputeAllWaypoints(origins[index], destinations[index]);
+        const std::vector<Point> waypoints(
+            batch.waypoints.begin() + batch.offsets[index],
+            batch.waypoints.begin() + batch.offsets[index + 1]);
+        EXPECT_EQ(waypoints, expected);
+        EXPECT_DOUBLE_EQ(batch.lengths[index], pathLength(expected));
+    }
+}
+
+TEST_F(RoomWithWall, BatchDoesNotDependOnThreadCount)
+{
+    std::vector<Point> origins{};
+    std::vector<Point> destinations{};
+    for(size_t index = 0; index < 64; ++index) {
+        origins.emplace_back(0.5 + 0.1 * index, 1 + 0.1 * index);
+        destinations.emplace_back(19.5 - 0.1 * index, 0.5 + 0.1 * index);
+    }
+    const auto sequential = engine->ComputeBatch(origins, destinations, 1, true);
+    const auto parallel = engine->ComputeBatch(origins, destinations, 4, true);
+    EXPECT_EQ(parallel.lengths, sequential.lengths);
+    EXPECT_EQ(parallel.waypoints, sequential.waypoints);
+    EXPECT_EQ(parallel.offsets, sequential.offsets);
+}
+
+TEST_F(RoomWithWall, BatchSkipsPositionsOutsideOfRoutableArea)
+{
+    const std::vector<Point> origins{{10, 1}, {2, 2}, {2, 2}};
+    const std::vector<Point> destinations{{18, 2}, {-1, 1}, {18, 2}};
+    const auto batch = engine->ComputeBatch(origins, destinations, 1, true);
+    EXPECT_TRUE(std::isinf(batch.lengths[0]));
+    EXPECT_TRUE(std::isinf(batch.lengths[1]));
+    EXPECT_FALSE(std::isinf(batch.lengths[2]));
+    EXPECT_EQ(batch.offsets, (std::vector<size_t>{0, 0, 0, batch.waypoints.size()}));
+}
+
+TEST_F(RoomWithWall, BatchWithoutWaypointsOnlyReturnsLengths)
+{
+    const std::vector<Point> origins{start};
+    const std::vector<Point> destinations{destination};
+    const auto batch = engine->ComputeBatch(origins, destinations, 1, false);
+    ASSERT_EQ(batch.lengths.size(), 1);
+    EXPECT_TRUE(batch.waypoints.empty());
+    EXPECT_TRUE(batch.offsets.empty());
+}
+
+TEST_F(RoomWithWall, BatchRejectsMismatchingSizes)
+{
+    const std::vector<Point> origins{start, start};
+    const std::vector<Point> destinations{destination};
+    EXPECT_THROW(engine->ComputeBatch(origins, destinations, 1, false), SimulationError);
+}
+
+class RoomWithObstacle : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        GeometryBuilder builder{};
+        builder.AddAccessibleArea({{0, 0}, {40, 0}, {40, 10}, {0, 10}});
+        engine = std::make_unique<RoutingEngine>(builder.Build().Polygon());
+        for(const auto& [x, y] : {std::pair{20., 4.}, {22., 4.}, {22., 6.}, {20., 6.}}) {
+            obstacle.push_back(K::Point_2(x, y));
+        }
+    }
+
+protected:
+    std::unique_ptr<RoutingEngine> engine{};
+    Poly obstacle{};
+    const Point centroid{21, 5};
+
+    /// Bounds of all faces of 'corridor' like the TacticalDecisionSystem computes them
+    static AABB Bounds(const Corridor& corridor)
+    {
+        AABB bounds{};
+        for(const auto& face : corridor.faces) {
+            for(int idx = 0; idx < 3; ++idx) {
+                const auto& p = face->vertex(idx)->point();
+                bounds.Extend(Point{CGAL::to_double(p.x()), CGAL::to_double(p.y())});
+            }
+        }
+        return bounds;
+    }
+
+    /// True if all faces of 'corridor' are routable and each one is adjacent to the next
+    static bool IsConnected(const Corridor& corridor)
+    {
+        for(size_t index = 0; index < corridor.faces.size(); ++index) {
+            const auto& face = corridor.faces[index];
+            if(!face->get_in_domain()) {
+                return false;
+            }
+            if(index + 1 == corridor.faces.size()) {
+                break;
+            }
+            bool adjacent = false;
+            for(int idx = 0; idx < 3; ++idx) {
+                adjacent = adjacent || face->neighbor(idx) == corridor.faces[index + 1];
+            }
+            if(!adjacent) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+TEST_F(RoomWithObstacle, ObstacleIsNotRoutableUntilRemoved)
+{
+    ASSERT_TRUE(engine->IsRoutable(centroid));
+    engine->AddObstacle(obstacle);
+    EXPECT_FALSE(engine->IsRoutable(centroid));
+    EXPECT_TRUE(engine->IsRoutable({19.5, 5}));
+    engine->RemoveObstacle(obstacle);
+    EXPECT_TRUE(engine->IsRoutable(centroid));
+}
+
+TEST_F(RoomWithObstacle, CorridorsOutsideOfChangedBoundsStayConnected)
+{
+    std::vector<Corridor> corridors{};
+    for(const auto& [from, to] :
+        {std::pair{Point{1, 1}, Point{4, 9}},
+         {Point{36, 1}, Point{39, 9}},
+         {Point{1, 5}, Point{39, 5}},
+         {Point{10, 1}, Point{30, 9}}}) {
+        corridors.push_back(engine->ComputeCorridor(from, to));
+    }
+    std::vector<AABB> bounds{};
+    for(const auto& corridor : corridors) {
+        bounds.push_back(Bounds(corridor));
+    }
+
+    const auto changed = engine->AddObstacle(obstacle);
+    EXPECT_TRUE(changed.Inside(centroid));
+    // The corridor through the obstacle has to be dropped
+    EXPECT_TRUE(changed.Overlap(bounds[2]));
+    for(size_t index = 0; index < corridors.size(); ++index) {
+        if(!changed.Overlap(bounds[index])) {
+            EXPECT_TRUE(IsConnected(corridors[index])) << index;
+        }
+    }
+}
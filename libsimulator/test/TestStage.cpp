@@ -56,3 +56,20 @@ TEST_F(StagesTests, NotifiableWaitingSetTargetIsCorrect)
         ASSERT_EQ(target, waitingPoints.back());
     }
 }
+
+TEST_F(StagesTests, IsCoveredByAreasContainingItsPositions)
+{
+    const Polygon area({{0, 0}, {2, 0}, {2, 2}, {0, 2}});
+    std::vector<GenericAgent::ID> toRemove{};
+
+    EXPECT_TRUE(Waypoint({1, 1}, 0.5).IsCoveredBy(area));
+    EXPECT_FALSE(Waypoint({3, 1}, 0.5).IsCoveredBy(area));
+    EXPECT_TRUE(Exit(Polygon({{1, 1}, {3, 1}, {3, 3}, {1, 3}}), toRemove).IsCoveredBy(area));
+    EXPECT_FALSE(Exit(Polygon({{5, 5}, {6, 5}, {6, 6}, {5, 6}}), toRemove).IsCoveredBy(area));
+    EXPECT_FALSE(Exit(Polygon({{2, 0}, {3, 0}, {3, 2}, {2, 2}}), toRemove).IsCoveredBy(area));
+    EXPECT_TRUE(NotifiableWaitingSet({{5, 5}, {1, 1}}).IsCoveredBy(area));
+    EXPECT_FALSE(NotifiableWaitingSet({{5, 5}, {-1, 1}}).IsCoveredBy(area));
+    EXPECT_TRUE(NotifiableQueue({{5, 5}, {1, 1}}).IsCoveredBy(area));
+    EXPECT_FALSE(NotifiableQueue({{5, 5}, {-1, 1}}).IsCoveredBy(area));
+    EXPECT_FALSE(DirectSteering().IsCoveredBy(area));
+}
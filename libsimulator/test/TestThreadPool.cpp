@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "SimulationError.hpp"
+#include "ThreadPool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+TEST(ThreadPool, RejectsZeroThreads)
+{
+    ASSERT_THROW(ThreadPool{0}, SimulationError);
+}
+
+TEST(ThreadPool, ThreadCount)
+{
+    ASSERT_EQ(ThreadPool{1}.ThreadCount(), 1);
+    ASSERT_EQ(ThreadPool{4}.ThreadCount(), 4);
+}
+
+TEST(ThreadPool, SmallLoopsRunOnOneChunk)
+{
+    ThreadPool pool{4};
+    ASSERT_EQ(pool.ChunkCount(0), 1);
+    ASSERT_EQ(pool.ChunkCount(ThreadPool::MIN_CHUNK_SIZE), 1);
+    ASSERT_EQ(pool.ChunkCount(2 * ThreadPool::MIN_CHUNK_SIZE), 2);
+    ASSERT_EQ(pool.ChunkCount(100 * ThreadPool::MIN_CHUNK_SIZE), 4);
+}
+
+TEST(ThreadPool, MinChunkSizeAllowsSmallLoopsToRunInParallel)
+{
+    ThreadPool pool{4};
+    ASSERT_EQ(pool.ChunkCount(1, 1), 1);
+    ASSERT_EQ(pool.ChunkCount(3, 1), 3);
+    ASSERT_EQ(pool.ChunkCount(9, 2), 4);
+
+    std::vector<int> visits(3, 0);
+    pool.ParallelFor(3, [&visits](size_t index) { ++visits[index]; }, 1);
+    ASSERT_EQ(visits, std::vector<int>(3, 1));
+}
+
+TEST(ThreadPool, VisitsEveryIndexOnce)
+{
+    for(size_t threadCount : {1, 2, 3, 8}) {
+        ThreadPool pool{threadCount};
+        for(size_t count : {0, 1, 17, 1000, 1001}) {
+            std::vector<int> visits(count, 0);
+            pool.ParallelFor(count, [&visits](size_t index) { ++visits[index]; });
+            ASSERT_EQ(std::accumulate(std::begin(visits), std::end(visits), 0), count);
+            for(const auto visit : visits) {
+                ASSERT_EQ(visit, 1);
+            }
+        }
+    }
+}
+
+TEST(ThreadPool, CanBeReused)
+{
+    ThreadPool pool{3};
+    std::vector<size_t> values(500, 0);
+    for(size_t run = 0; run < 100; ++run) {
+        pool.ParallelFor(values.size(), [&values](size_t index) { values[index] += index; });
+    }
+    for(size_t index = 0; index < values.size(); ++index) {
+        ASSERT_EQ(values[index], 100 * index);
+    }
+}
+
+TEST(ThreadPool, RethrowsExceptionFromWorker)
+{
+    ThreadPool pool{4};
+    const size_t count = 1000;
+    ASSERT_THROW(
+        pool.ParallelFor(
+            count,
+            [count](size_t index) {
+                if(index == count - 1) {
+                    throw std::runtime_error("failed");
+                }
+            }),
+        std::runtime_error);
+
+    // The pool has to stay usable after a failed loop
+    std::vector<int> visits(count, 0);
+    pool.ParallelFor(count, [&visits](size_t index) { ++visits[index]; });
+    ASSERT_EQ(std::accumulate(std::begin(visits), std::end(visits), 0), count);
+}
+
+TEST(ThreadPool, RangesAreContiguousAndCoverAllIndices)
+{
+    ThreadPool pool{4};
+    for(size_t count : {0, 5, 1000}) {
+        std::mutex mutex{};
+        std::vector<std::pair<size_t, size_t>> ranges{};
+        pool.ParallelForRanges(count, [&mutex, &ranges](size_t begin, size_t end) {
+            const std::lock_guard lock{mutex};
+            ranges.emplace_back(begin, end);
+        });
+        std::sort(std::begin(ranges), std::end(ranges));
+        ASSERT_EQ(ranges.size(), pool.ChunkCount(count));
+        ASSERT_EQ(ranges.front().first, 0);
+        ASSERT_EQ(ranges.back().second, count);
+        for(size_t chunk = 1; chunk < ranges.size(); ++chunk) {
+            ASSERT_EQ(ranges[chunk].first, ranges[chunk - 1].second);
+        }
+    }
+}
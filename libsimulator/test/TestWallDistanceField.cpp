@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "CfgCgal.hpp"
+#include "CollisionGeometry.hpp"
+#include "Point.hpp"
+#include "SimulationError.hpp"
+#include "WallDistanceField.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+class WallDistanceFieldInRectangle : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        using CGALPoint = PolyWithHoles::Polygon_2::Point_2;
+        const std::vector<CGALPoint> points{{0, 0}, {10, 0}, {10, 6}, {0, 6}};
+        geometry = std::make_unique<CollisionGeometry>(
+            PolyWithHoles(Poly{points.begin(), points.end()}));
+    }
+
+protected:
+    std::unique_ptr<CollisionGeometry> geometry{};
+};
+
+TEST_F(WallDistanceFieldInRectangle, IsExactAlongStraightWalls)
+{
+    const WallDistanceField field(*geometry, 0.3);
+    for(const auto& position : {Point{5, 0.1}, Point{5.05, 1.37}, Point{2.9, 2.5}}) {
+        const auto sample = field.At(position);
+        EXPECT_NEAR(sample.distance, position.y, 1e-5);
+        EXPECT_NEAR(sample.direction.x, 0, 1e-5);
+        EXPECT_NEAR(sample.direction.y, -1, 1e-5);
+    }
+}
+
+TEST_F(WallDistanceFieldInRectangle, DirectionDoesNotCancelOnMedialAxis)
+{
+    // Node rows at y = 2.8 and y = 3.2 have their closest walls on opposite sides
+    constexpr double resolution = 0.4;
+    const WallDistanceField field(*geometry, resolution);
+    for(double x = 3.5; x < 6.6; x += 0.3) {
+        const auto sample = field.At({x, 3});
+        EXPECT_NEAR(sample.distance, 3, resolution);
+        EXPECT_NEAR(sample.direction.x, 0, 1e-5);
+        EXPECT_NEAR(std::abs(sample.direction.y), 1, 1e-5);
+    }
+}
+
+TEST_F(WallDistanceFieldInRectangle, DirectionPointsToWallInCellsStraddlingIt)
+{
+    // Node rows at y = 5.6 and y = 6.4 lie on both sides of the wall at y = 6
+    constexpr double resolution = 0.8;
+    const WallDistanceField field(*geometry, resolution);
+    for(const auto y : {5.65, 5.8, 5.95, 5.99}) {
+        const auto sample = field.At({5.3, y});
+        EXPECT_NEAR(sample.distance, 6 - y, 1e-5);
+        EXPECT_NEAR(sample.direction.x, 0, 1e-5);
+        EXPECT_NEAR(sample.direction.y, 1, 1e-5);
+    }
+}
+
+TEST_F(WallDistanceFieldInRectangle, IsNegativeOutside)
+{
+    const WallDistanceField field(*geometry, 0.25);
+    EXPECT_NEAR(field.At({5, -0.1}).distance, -0.1, 1e-5);
+    EXPECT_EQ(field.At({100, 100}).distance, -WallDistanceField::MaxDistance);
+}
+
+TEST_F(WallDistanceFieldInRectangle, ErrorNearCornersIsBoundedByResolution)
+{
+    constexpr double resolution = 0.2;
+    const WallDistanceField field(*geometry, resolution);
+    for(double x = 0.05; x < 1.5; x += 0.13) {
+        for(double y = 0.05; y < 1.5; y += 0.11) {
+            EXPECT_NEAR(field.At({x, y}).distance, std::min(x, y), resolution);
+        }
+    }
+}
+
+TEST_F(WallDistanceFieldInRectangle, IsSharedAndBuiltOnce)
+{
+    const auto& field = geometry->WallDistances(0.5);
+    const CollisionGeometry copy = *geometry;
+    EXPECT_EQ(&copy.WallDistances(0.5), &field);
+    EXPECT_THROW(geometry->WallDistances(0.25), SimulationError);
+}
+
+TEST_F(WallDistanceFieldInRectangle, UpdatesWithObstacleLikeRebuild)
+{
+    using CGALPoint = PolyWithHoles::Polygon_2::Point_2;
+    const std::vector<CGALPoint> points{{2, 2}, {3, 2}, {3, 3}, {2, 3}};
+    geometry->WallDistances(0.25);
+    const auto withObstacle = geometry->WithObstacle(Poly{points.begin(), points.end()});
+    const auto withoutObstacle = withObstacle.WithoutObstacle(Poly{points.begin(), points.end()});
+    for(const auto* derived : {&withObstacle, &withoutObstacle}) {
+        const auto& updated = derived->WallDistances(0.25);
+        const WallDistanceField rebuilt(*derived, 0.25);
+        for(double x = 0.05; x < 10; x += 0.37) {
+            for(double y = 0.05; y < 6; y += 0.29) {
+                EXPECT_EQ(updated.At({x, y}).distance, rebuilt.At({x, y}).distance);
+            }
+        }
+    }
+}
+
+TEST_F(WallDistanceFieldInRectangle, RejectsInvalidResolution)
+{
+    EXPECT_THROW(WallDistanceField(*geometry, 0), SimulationError);
+    EXPECT_THROW(WallDistanceField(*geometry, -1), SimulationError);
+}
@@ -18,12 +18,13 @@ void init_collision_free_speed_model(py::module_& m)
         m, "CollisionFreeSpeedModel");
     py::class_<CollisionFreeSpeedModelBuilder>(m, "CollisionFreeSpeedModelBuilder")
         .def(
-            py::init<double, double, double, double>(),
+            py::init<double, double, double, double, double>(),
             py::kw_only(),
             py::arg("strength_neighbor_repulsion"),
             py::arg("range_neighbor_repulsion"),
             py::arg("strength_geometry_repulsion"),
-            py::arg("range_geometry_repulsion"))
+            py::arg("range_geometry_repulsion"),
+            py::arg("wall_distance_resolution") = 0.0)
         .def("build", &CollisionFreeSpeedModelBuilder::Build);
     py::class_<CollisionFreeSpeedModelData>(m, "CollisionFreeSpeedModelState")
         .def_static("_defaults", []() { return CollisionFreeSpeedModelData{}; })
@@ -6,7 +6,10 @@
 
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h> // IWYU pragma: keep
+#include <pybind11/stl/filesystem.h> // IWYU pragma: keep
 
+#include <filesystem>
+#include <memory>
 #include <tuple>
 #include <vector>
 
@@ -14,7 +17,7 @@ namespace py = pybind11;
 
 void init_geometry(py::module_& m)
 {
-    py::class_<CollisionGeometry>(m, "Geometry")
+    py::class_<CollisionGeometry, std::shared_ptr<CollisionGeometry>>(m, "Geometry")
         .def(
             "boundary",
             [](const CollisionGeometry& geo) {
@@ -31,7 +34,11 @@ void init_geometry(py::module_& m)
                 }
                 return res;
             })
-        .def("linesegments_close_to", &CollisionGeometry::LineSegmentsInApproxDistanceTo)
+        .def(
+            "linesegments_close_to",
+            [](const CollisionGeometry& geo, Point p) {
+                return intoVec(geo.LineSegmentsInApproxDistanceTo(p));
+            })
         .def(
             "linesegments_in_distance_to",
             [](const CollisionGeometry& geo, double distance, std::tuple<double, double> pos) {
@@ -39,6 +46,7 @@ void init_geometry(py::module_& m)
             });
     py::class_<GeometryBuilder>(m, "GeometryBuilder")
         .def(py::init<>())
+        .def(py::init<size_t>(), py::arg("num_threads"))
         .def(
             "add_accessible_area",
             [](GeometryBuilder& builder, const std::vector<std::tuple<double, double>>& points) {
@@ -49,5 +57,9 @@ void init_geometry(py::module_& m)
             [](GeometryBuilder& builder, const std::vector<std::tuple<double, double>>& points) {
                 builder.ExcludeFromAccessibleArea(intoPoints(points));
             })
-        .def("build", &GeometryBuilder::Build);
+        .def("build", py::overload_cast<>(&GeometryBuilder::Build))
+        .def(
+            "build",
+            py::overload_cast<const std::filesystem::path&>(&GeometryBuilder::Build),
+            py::arg("cache_directory"));
 }
@@ -1,26 +1,65 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #include "CollisionGeometry.hpp"
+#include "Point.hpp"
 #include "RoutingEngine.hpp"
 #include "conversion.hpp"
 
 #include <glm/ext/vector_float2.hpp>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h> // IWYU pragma: keep
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <tuple>
 #include <vector>
 
 namespace py = pybind11;
 
+using PositionArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+namespace
+{
+/// Copies an array of shape (n, 2) into points.
+std::vector<Point> fromPositionArray(const PositionArray& positions, const std::string& name)
+{
+    if(positions.ndim() != 2 || positions.shape(1) != 2) {
+        throw std::invalid_argument(name + " needs to be an array of shape (n, 2)");
+    }
+    const auto view = positions.unchecked<2>();
+    std::vector<Point> points{};
+    points.reserve(view.shape(0));
+    for(py::ssize_t index = 0; index < view.shape(0); ++index) {
+        points.emplace_back(view(index, 0), view(index, 1));
+    }
+    return points;
+}
+} // namespace
+
 void init_routing(py::module_& m)
 {
+    py::enum_<RoutingAlgorithm>(m, "RoutingAlgorithm")
+        .value("Triangulation", RoutingAlgorithm::Triangulation)
+        .value("AnyAngle", RoutingAlgorithm::AnyAngle)
+        .value("Hierarchical", RoutingAlgorithm::Hierarchical);
+
     py::class_<RoutingEngine>(m, "RoutingEngine")
-        .def(py::init([](const CollisionGeometry& geo) {
-            return std::make_unique<RoutingEngine>(geo.Polygon());
-        }))
+        .def(
+            py::init(
+                [](const CollisionGeometry& geo, RoutingAlgorithm algorithm, size_t numThreads) {
+                    auto engine = std::make_unique<RoutingEngine>(geo.Polygon());
+                    engine->SetAlgorithm(algorithm, numThreads);
+                    return engine;
+                }),
+            py::arg("geometry"),
+            py::arg("algorithm") = RoutingAlgorithm::Triangulation,
+            py::arg("num_threads") = 1)
         .def(
             "compute_waypoints",
             [](RoutingEngine& engine,
@@ -28,6 +67,41 @@ void init_routing(py::module_& m)
                std::tuple<double, double> to) {
                 return intoTuples(engine.ComputeAllWaypoints(intoPoint(from), intoPoint(to)));
             })
+        .def(
+            "compute_batch",
+            [](RoutingEngine& engine,
+               const PositionArray& origins,
+               const PositionArray& destinations,
+               bool withWaypoints,
+               std::optional<size_t> numThreads) {
+                const auto from = fromPositionArray(origins, "origins");
+                const auto to = fromPositionArray(destinations, "destinations");
+                const auto threadCount =
+                    numThreads.value_or(std::max<size_t>(std::thread::hardware_concurrency(), 1));
+                RoutingBatch batch{};
+                {
+                    py::gil_scoped_release release{};
+                    batch = engine.ComputeBatch(from, to, threadCount, withWaypoints);
+                }
+                py::array_t<double> lengths(batch.lengths.size(), batch.lengths.data());
+                if(!withWaypoints) {
+                    return py::make_tuple(lengths, py::none(), py::none());
+                }
+                py::array_t<double> waypoints(std::vector<py::ssize_t>{
+                    static_cast<py::ssize_t>(batch.waypoints.size()), 2});
+                auto waypointsView = waypoints.mutable_unchecked<2>();
+                for(size_t index = 0; index < batch.waypoints.size(); ++index) {
+                    waypointsView(index, 0) = batch.waypoints[index].x;
+                    waypointsView(index, 1) = batch.waypoints[index].y;
+                }
+                py::array_t<int64_t> offsets(batch.offsets.size());
+                std::copy(batch.offsets.begin(), batch.offsets.end(), offsets.mutable_data());
+                return py::make_tuple(lengths, waypoints, offsets);
+            },
+            py::arg("origins"),
+            py::arg("destinations"),
+            py::arg("with_waypoints") = false,
+            py::arg("num_threads") = py::none())
         .def(
             "is_routable",
             [](RoutingEngine& engine, std::tuple<double, double> point) {
@@ -3,8 +3,10 @@
 
 #include "CollisionGeometry.hpp"
 #include "Journey.hpp"
+#include "Obstacle.hpp"
 #include "OperationalModel.hpp"
 #include "Polygon.hpp"
+#include "RoutingEngine.hpp"
 #include "Stage.hpp"
 #include "StageDescription.hpp"
 #include "conversion.hpp"
@@ -15,6 +17,7 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h> // IWYU pragma: keep
 
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -31,18 +34,33 @@ void init_simulation(py::module_& m)
             // The model is moved out of the Python object into Simulation. After this constructor
             // returns, the Python model object passed here is disowned/invalid and must not be
             // reused.
-            py::init(
-                [](std::unique_ptr<OperationalModel> model, CollisionGeometry geometry, double dT) {
-                    if(!model) {
-                        throw std::invalid_argument("model must not be None");
-                    }
-                    return std::make_unique<Simulation>(
-                        std::move(model), std::make_unique<CollisionGeometry>(geometry), dT);
-                }),
+            py::init([](std::unique_ptr<OperationalModel> model,
+                        CollisionGeometry geometry,
+                        double dT,
+                        size_t numThreads,
+                        double neighborListSkin,
+                        RoutingAlgorithm routingAlgorithm,
+                        bool useNavigationFields) {
+                if(!model) {
+                    throw std::invalid_argument("model must not be None");
+                }
+                return std::make_unique<Simulation>(
+                    std::move(model),
+                    std::make_unique<CollisionGeometry>(geometry),
+                    dT,
+                    numThreads,
+                    neighborListSkin,
+                    routingAlgorithm,
+                    useNavigationFields);
+            }),
             py::kw_only(),
             py::arg("model"),
             py::arg("geometry"),
-            py::arg("dt"))
+            py::arg("dt"),
+            py::arg("num_threads") = 1,
+            py::arg("neighbor_list_skin") = 0.0,
+            py::arg("routing_algorithm") = RoutingAlgorithm::Triangulation,
+            py::arg("use_navigation_fields") = false)
         .def(
             "add_waypoint_stage",
             [](Simulation& sim, std::tuple<double, double> position, double distance) {
@@ -63,6 +81,14 @@ void init_simulation(py::module_& m)
             [](Simulation& sim, const std::vector<std::tuple<double, double>>& polygon) {
                 return sim.AddStage(ExitDescription{Polygon{intoPoints(polygon)}}).getID();
             })
+        .def(
+            "add_obstacle",
+            [](Simulation& sim, const std::vector<std::tuple<double, double>>& polygon) {
+                return sim.AddObstacle(intoPoints(polygon)).getID();
+            })
+        .def(
+            "remove_obstacle",
+            [](Simulation& sim, uint64_t id) { sim.RemoveObstacle(Obstacle::ID(id)); })
         .def(
             "add_direct_steering_stage",
             [](Simulation& sim) { return sim.AddStage(DirectSteeringDescription{}).getID(); })
@@ -93,7 +119,12 @@ void init_simulation(py::module_& m)
                 }
                 return agent_ids;
             })
-        .def("iterate", [](Simulation& sim) { sim.Iterate(); })
+        // The GIL is released so that worker threads of the simulation can acquire it, e.g. for
+        // logging callbacks. Python models acquire the GIL on their own.
+        .def(
+            "iterate",
+            [](Simulation& sim) { sim.Iterate(); },
+            py::call_guard<py::gil_scoped_release>())
         .def(
             "switch_agent_journey",
             [](Simulation& sim, uint64_t agentId, uint64_t journeyId, uint64_t stageId) {
@@ -106,6 +137,12 @@ void init_simulation(py::module_& m)
         .def("agent_count", [](const Simulation& sim) { return sim.AgentCount(); })
         .def("elapsed_time", [](const Simulation& sim) { return sim.ElapsedTime(); })
         .def("delta_time", [](const Simulation& sim) { return sim.DT(); })
+        .def("num_threads", [](const Simulation& sim) { return sim.ThreadCount(); })
+        .def("neighbor_list_skin", [](const Simulation& sim) { return sim.NeighborListSkin(); })
+        .def("routing_algorithm", [](const Simulation& sim) { return sim.Routing(); })
+        .def(
+            "use_navigation_fields",
+            [](const Simulation& sim) { return sim.UsesNavigationFields(); })
         .def("iteration_count", [](const Simulation& sim) { return sim.Iteration(); })
         .def(
             "agents",
@@ -143,7 +180,14 @@ void init_simulation(py::module_& m)
         .def(
             "set_timer_log_level",
             [](Simulation& sim, size_t level) { sim.SetTimerLogLevel(level); })
-        .def("get_geometry", [](Simulation& sim) { return sim.Geo(); })
+        .def(
+            "get_geometry",
+            [](const Simulation& sim) {
+                // Only const member functions of the geometry are bound, the cast does not allow
+                // modifying the shared instance from Python.
+                return std::const_pointer_cast<CollisionGeometry>(sim.Geo());
+            })
+        .def("geometry_generation", &Simulation::GeometryGeneration)
         .def(
             "push_timer",
             [](Simulation& sim, const std::string& name, size_t probe_log_level) {
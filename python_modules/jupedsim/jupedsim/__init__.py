@@ -75,7 +75,7 @@ from jupedsim.models.warp_driver import (
 )
 from jupedsim.neighborhood import NeighborhoodSearch
 from jupedsim.recording import Recording, RecordingAgent, RecordingFrame
-from jupedsim.routing import RoutingEngine
+from jupedsim.routing import RoutingAlgorithm, RoutingBatchResult, RoutingEngine
 from jupedsim.serialization import TrajectoryWriter
 from jupedsim.simulation import Simulation
 from jupedsim.sqlite_serialization import SqliteTrajectoryWriter
@@ -129,6 +129,8 @@ __all__ = [
     "Recording",
     "RecordingAgent",
     "RecordingFrame",
+    "RoutingAlgorithm",
+    "RoutingBatchResult",
     "RoutingEngine",
     "Simulation",
     "SqliteTrajectoryWriter",
@@ -18,6 +18,8 @@ class Geometry:
 
     def __init__(self, obj: py_jps.Geometry):
         self._obj = obj
+        self._wkt: str | None = None
+        self._bounds: tuple[float, float, float, float] | None = None
 
     def boundary(self) -> list[tuple[float, float]]:
         """Access the boundary polygon of the walkable area.
@@ -36,16 +38,34 @@ class Geometry:
         return self._obj.holes()
 
     def as_wkt(self) -> str:
-        """_summary_
+        """Access the walkable area as WKT.
+
+        The geometry is immutable, the WKT is computed on first access and
+        cached afterwards.
+
+        Returns:
+            The walkable area as WKT polygon.
+        """
+        if self._wkt is None:
+            poly = shapely.Polygon(self.boundary(), holes=self.holes())
+            self._wkt = shapely.to_wkt(
+                poly,
+                rounding_precision=-1,
+            )
+        return self._wkt
+
+    def bounds(self) -> tuple[float, float, float, float]:
+        """Access the bounding box of the walkable area.
+
+        The bounds are computed on first access and cached afterwards.
 
         Returns:
-            String: _description_
+            Bounding box as (xmin, ymin, xmax, ymax).
         """
-        poly = shapely.Polygon(self.boundary(), holes=self.holes())
-        return shapely.to_wkt(
-            poly,
-            rounding_precision=-1,
-        )
+        if self._bounds is None:
+            xs, ys = zip(*self.boundary())
+            self._bounds = (min(xs), min(ys), max(xs), max(ys))
+        return self._bounds
 
     def linesegments_close_to(
         self, point: tuple[float, float]
@@ -1,4 +1,5 @@
 # SPDX-License-Identifier: LGPL-3.0-or-later
+import pathlib
 from typing import Any, List, Optional, Tuple
 
 import shapely
@@ -19,7 +20,12 @@ class GeometryError(Exception):
         self.message = message
 
 
-def _geometry_from_wkt(wkt_input: str) -> Geometry:
+def _geometry_from_wkt(
+    wkt_input: str,
+    *,
+    cache_directory: Optional[str | pathlib.Path] = None,
+    num_threads: int = 1,
+) -> Geometry:
     geometry_collection = None
     try:
         wkt_type = shapely.from_wkt(wkt_input)
@@ -41,7 +47,11 @@ def _geometry_from_wkt(wkt_input: str) -> Geometry:
             ) from exc
 
     polygons = _polygons_from_geometry_collection(geometry_collection)
-    return Geometry(_internal_build_geometry(polygons))
+    return Geometry(
+        _internal_build_geometry(
+            polygons, cache_directory=cache_directory, num_threads=num_threads
+        )
+    )
 
 
 def _geometry_from_shapely(
@@ -51,18 +61,33 @@ def _geometry_from_shapely(
         | shapely.GeometryCollection
         | shapely.MultiPoint
     ),
+    *,
+    cache_directory: Optional[str | pathlib.Path] = None,
+    num_threads: int = 1,
 ) -> Geometry:
     polygons = _polygons_from_geometry_collection(
         shapely.GeometryCollection([geometry_input])
     )
-    return Geometry(_internal_build_geometry(polygons))
+    return Geometry(
+        _internal_build_geometry(
+            polygons, cache_directory=cache_directory, num_threads=num_threads
+        )
+    )
 
 
 def _geometry_from_coordinates(
-    coordinates: List[Tuple], *, excluded_areas: Optional[List[Tuple]] = None
+    coordinates: List[Tuple],
+    *,
+    excluded_areas: Optional[List[Tuple]] = None,
+    cache_directory: Optional[str | pathlib.Path] = None,
+    num_threads: int = 1,
 ) -> Geometry:
     polygon = shapely.Polygon(coordinates, holes=excluded_areas)
-    return Geometry(_internal_build_geometry([polygon]))
+    return Geometry(
+        _internal_build_geometry(
+            [polygon], cache_directory=cache_directory, num_threads=num_threads
+        )
+    )
 
 
 def _polygons_from_geometry_collection(
@@ -107,13 +132,18 @@ def _polygons_from_geometry_collection(
 
 def _internal_build_geometry(
     polygons: List[shapely.Polygon],
+    *,
+    cache_directory: Optional[str | pathlib.Path] = None,
+    num_threads: int = 1,
 ) -> py_jps.Geometry:
-    geo_builder = py_jps.GeometryBuilder()
+    geo_builder = py_jps.GeometryBuilder(num_threads=num_threads)
 
     for polygon in polygons:
         geo_builder.add_accessible_area(polygon.exterior.coords[:-1])
         for hole in polygon.interiors:
             geo_builder.exclude_from_accessible_area(hole.coords[:-1])
+    if cache_directory is not None:
+        return geo_builder.build(cache_directory=pathlib.Path(cache_directory))
     return geo_builder.build()
 
 
@@ -153,17 +183,32 @@ def build_geometry(
         excluded_areas: describes exclusions
             from the walkable area. Only use this argument if `geometry` was
             provided as list[tuple[float, float]].
+        cache_directory: directory of an on-disk cache of built geometries.
+            If the same input was built with this directory before, the
+            geometry and its navigation triangulation are loaded from the cache
+            instead of being computed, otherwise they are computed and stored.
+        num_threads: number of threads used to unite the polygons, defaults
+            to 1. The built geometry does not depend on it.
     """
+    cache_directory = kwargs.get("cache_directory")
+    num_threads = kwargs.get("num_threads", 1)
     if isinstance(geometry, str):
-        return _geometry_from_wkt(geometry)
+        return _geometry_from_wkt(
+            geometry, cache_directory=cache_directory, num_threads=num_threads
+        )
     elif (
         isinstance(geometry, shapely.GeometryCollection)
         or isinstance(geometry, shapely.Polygon)
         or isinstance(geometry, shapely.MultiPolygon)
         or isinstance(geometry, shapely.MultiPoint)
     ):
-        return _geometry_from_shapely(geometry)
+        return _geometry_from_shapely(
+            geometry, cache_directory=cache_directory, num_threads=num_threads
+        )
     else:
         return _geometry_from_coordinates(
-            geometry, excluded_areas=kwargs.get("excluded_areas")
+            geometry,
+            excluded_areas=kwargs.get("excluded_areas"),
+            cache_directory=cache_directory,
+            num_threads=num_threads,
         )
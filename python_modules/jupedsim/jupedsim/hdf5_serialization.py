@@ -19,8 +19,6 @@ import json
 import pathlib
 from typing import Final
 
-from shapely import from_wkt
-
 from jupedsim.serialization import TrajectoryWriter
 from jupedsim.simulation import Simulation
 
@@ -141,9 +139,11 @@ class Hdf5TrajectoryWriter(TrajectoryWriter):
         self._buffer: list[tuple] = []
         self._frames_since_flush: int = 0
 
-        # Cache of bounds keyed by deterministic WKT hash so we don't
-        # re-parse WKT every frame for static geometry.
-        self._bounds_cache: dict[int, tuple[float, float, float, float]] = {}
+        # Geometry of the last recorded frame. WKT, hash and bounds are only
+        # recomputed when the simulation reports a new geometry generation.
+        self._geometry_generation: int | None = None
+        self._geometry_wkt: str = ""
+        self._geometry_hash: int = 0
 
         # Tracks the unique-geometry registry. Datasets in /geometry are
         # only created once a *second* distinct WKT is observed.
@@ -162,7 +162,8 @@ class Hdf5TrajectoryWriter(TrajectoryWriter):
             raise TrajectoryWriter.Exception("File already closed.")
 
         fps = 1.0 / simulation.delta_time() / self._every_nth_frame
-        wkt = simulation.get_geometry().as_wkt()
+        self._update_geometry(simulation)
+        wkt = self._geometry_wkt
 
         comp_kwargs: dict[str, object] = {}
         if self._compression_level > 0:
@@ -219,8 +220,7 @@ class Hdf5TrajectoryWriter(TrajectoryWriter):
             _dt.timezone.utc
         ).isoformat()
 
-        self._initial_wkt_hash = _stable_geometry_hash(wkt)
-        self._update_bounds(wkt, self._initial_wkt_hash)
+        self._initial_wkt_hash = self._geometry_hash
 
     def write_iteration_state(self, simulation: Simulation) -> None:
         if self._file is None or self._traj_ds is None:
@@ -242,10 +242,11 @@ class Hdf5TrajectoryWriter(TrajectoryWriter):
                 )
             )
 
-        wkt = simulation.get_geometry().as_wkt()
-        wkt_hash = _stable_geometry_hash(wkt)
-        self._update_bounds(wkt, wkt_hash)
-        self._record_frame_geometry(frame, wkt, wkt_hash)
+        if simulation.geometry_generation() != self._geometry_generation:
+            self._update_geometry(simulation)
+        self._record_frame_geometry(
+            frame, self._geometry_wkt, self._geometry_hash
+        )
 
         self._frames_since_flush += 1
         if self._frames_since_flush >= self._commit_every_nth_write:
@@ -276,13 +277,12 @@ class Hdf5TrajectoryWriter(TrajectoryWriter):
 
     # ----- internal helpers --------------------------------------------------
 
-    def _update_bounds(self, wkt: str, wkt_hash: int) -> None:
-        bounds = self._bounds_cache.get(wkt_hash)
-        if bounds is None:
-            xmin, ymin, xmax, ymax = from_wkt(wkt).bounds
-            bounds = (xmin, ymin, xmax, ymax)
-            self._bounds_cache[wkt_hash] = bounds
-        xmin, ymin, xmax, ymax = bounds
+    def _update_geometry(self, simulation: Simulation) -> None:
+        geometry = simulation.get_geometry()
+        self._geometry_generation = simulation.geometry_generation()
+        self._geometry_wkt = geometry.as_wkt()
+        self._geometry_hash = _stable_geometry_hash(self._geometry_wkt)
+        xmin, ymin, xmax, ymax = geometry.bounds()
         self._xmin = min(self._xmin, xmin)
         self._xmax = max(self._xmax, xmax)
         self._ymin = min(self._ymin, ymin)
@@ -23,12 +23,24 @@ class CollisionFreeSpeedModel:
         range_neighbor_repulsion: Range of the repulsion from neighbors
         strength_geometry_repulsion: Strength of the repulsion from geometry boundaries
         range_geometry_repulsion: Range of the repulsion from geometry boundaries
+        wall_distance_resolution: If larger than 0 the repulsion from geometry
+            boundaries is looked up in a precomputed wall distance field with
+            this many meters between its nodes instead of being summed over
+            all nearby walls. This makes the lookup independent of the number
+            of nearby walls, but only the closest wall repels an agent. The
+            distance to it is interpolated bilinearly, which is exact along
+            straight walls and off by up to the resolution close to corners
+            and halfway between walls. The direction to the wall is taken
+            from the closest node of the field.
+            The field is built once per geometry on first use, its memory
+            grows with the walkable area divided by the squared resolution.
     """
 
     strength_neighbor_repulsion: float = 8.0
     range_neighbor_repulsion: float = 0.1
     strength_geometry_repulsion: float = 5.0
     range_geometry_repulsion: float = 0.02
+    wall_distance_resolution: float = 0.0
 
 
 @dataclass(kw_only=True)
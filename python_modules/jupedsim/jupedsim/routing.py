@@ -1,15 +1,76 @@
 # SPDX-License-Identifier: LGPL-3.0-or-later
 
+from dataclasses import dataclass
+from enum import Enum
 from typing import Any
 
+import numpy as np
+import numpy.typing as npt
 import shapely
 
 import jupedsim.native as py_jps
 from jupedsim.geometry_utils import build_geometry
 
 
+class RoutingAlgorithm(Enum):
+    """Search used to find the path of an agent to its target.
+
+    TRIANGULATION runs A* over the triangles of the navigation mesh and is
+    fast, but may pick a detour through long and thin triangles.
+    ANY_ANGLE searches the navigation mesh merged into convex polygons and
+    always finds the shortest path, at the cost of building the merged mesh
+    up front.
+    HIERARCHICAL groups the triangles into clusters and precomputes the
+    distances between the portals of each cluster in parallel up front.
+    Queries only search the portals and the clusters along the way, which
+    pays off for long paths through large geometries. Paths are close to
+    but not always the shortest ones.
+    """
+
+    TRIANGULATION = py_jps.RoutingAlgorithm.Triangulation
+    ANY_ANGLE = py_jps.RoutingAlgorithm.AnyAngle
+    HIERARCHICAL = py_jps.RoutingAlgorithm.Hierarchical
+
+
+@dataclass
+class RoutingBatchResult:
+    """Paths of a batch of routing queries in flat arrays.
+
+    Attributes:
+        lengths: Path length per query, ``inf`` if origin or destination of
+            the query is not routable.
+        waypoints: Waypoints of all paths as array of shape (m, 2), None if
+            waypoints were not requested.
+        offsets: Waypoints of query i are
+            ``waypoints[offsets[i]:offsets[i + 1]]``, None if waypoints were
+            not requested.
+    """
+
+    lengths: npt.NDArray[np.float64]
+    waypoints: npt.NDArray[np.float64] | None
+    offsets: npt.NDArray[np.int64] | None
+
+    def path(self, index: int) -> npt.NDArray[np.float64]:
+        """Waypoints of query 'index' including origin and destination.
+
+        Returns:
+            Array of shape (k, 2), empty if the query has no path.
+        """
+        if self.waypoints is None or self.offsets is None:
+            raise ValueError("Waypoints were not requested")
+        return self.waypoints[self.offsets[index] : self.offsets[index + 1]]
+
+
 class RoutingEngine:
-    """RoutingEngine to compute the shortest paths with navigation meshes."""
+    """RoutingEngine to compute the shortest paths with navigation meshes.
+
+    Arguments:
+        geometry: Data to create the geometry out of, see
+            :func:`~jupedsim.geometry_utils.build_geometry`.
+        algorithm: Search used to find paths.
+        num_threads: Number of threads used to build the geometry and to
+            precompute the search structures of the HIERARCHICAL algorithm.
+    """
 
     def __init__(
         self,
@@ -21,10 +82,14 @@ class RoutingEngine:
             | shapely.MultiPoint
             | list[tuple[float, float]]
         ),
+        algorithm: RoutingAlgorithm = RoutingAlgorithm.TRIANGULATION,
+        num_threads: int = 1,
         **kwargs: Any,
     ) -> None:
         self._obj = py_jps.RoutingEngine(
-            build_geometry(geometry, **kwargs)._obj
+            build_geometry(geometry, num_threads=num_threads, **kwargs)._obj,
+            algorithm.value,
+            num_threads,
         )
 
     def compute_waypoints(
@@ -61,6 +126,41 @@ class RoutingEngine:
         """
         return self._obj.compute_waypoints(frm, to)
 
+    def compute_batch(
+        self,
+        origins: npt.ArrayLike,
+        destinations: npt.ArrayLike,
+        *,
+        with_waypoints: bool = False,
+        num_threads: int | None = None,
+    ) -> RoutingBatchResult:
+        """Computes the paths from ``origins[i]`` to ``destinations[i]``.
+
+        All queries run on a pool of threads without holding the GIL, so
+        other Python threads keep running meanwhile. Queries with an origin
+        or destination outside of the geometry do not fail the batch, they
+        get an infinite length and an empty path instead.
+
+        Arguments:
+            origins: Array of shape (n, 2) with the start of each query.
+            destinations: Array of shape (n, 2) with the target of each
+                query.
+            with_waypoints: If True, the waypoints of all paths are returned
+                as well, otherwise only their lengths.
+            num_threads: Number of threads, defaults to the number of
+                hardware threads. The results do not depend on it.
+
+        Returns:
+            Lengths and, if requested, waypoints of all paths.
+        """
+        lengths, waypoints, offsets = self._obj.compute_batch(
+            np.asarray(origins, dtype=np.float64),
+            np.asarray(destinations, dtype=np.float64),
+            with_waypoints=with_waypoints,
+            num_threads=num_threads,
+        )
+        return RoutingBatchResult(lengths, waypoints, offsets)
+
     def is_routable(self, p: tuple[float, float]) -> bool:
         """Tests if the supplied point is inside the underlying geometry.
 
@@ -43,6 +43,7 @@ from jupedsim.models.warp_driver import (
     WarpDriverModel,
     WarpDriverModelAgentParameters,
 )
+from jupedsim.routing import RoutingAlgorithm
 from jupedsim.serialization import TrajectoryWriter
 from jupedsim.stages import (
     ExitStage,
@@ -86,6 +87,10 @@ class Simulation:
         dt: float = 0.01,
         trajectory_writer: TrajectoryWriter | None = None,
         timer_log_level: int = 1,
+        num_threads: int = 1,
+        neighbor_list_skin: float = 0.0,
+        routing_algorithm: RoutingAlgorithm = RoutingAlgorithm.TRIANGULATION,
+        use_navigation_fields: bool = False,
         **kwargs: Any,
     ) -> None:
         """Creates a Simulation.
@@ -114,11 +119,38 @@ class Simulation:
                 TrajectoryWriter interface. JuPedSim provides a writer that outputs trajectory data
                 in a sqlite database. If you want other formats such as CSV you need to provide
                 your own custom implementation.
+            num_threads: Number of threads used to build the geometry and to
+                compute the movement of the agents in each iteration.
+                Results are identical for any number of threads. The
+                AnticipationVelocityModel, the WarpDriverModel and custom
+                models are always computed on a single thread.
+            neighbor_list_skin: Enables cached neighbor lists if larger than 0.
+                Neighbor lists are built with the interaction radius of the
+                model plus this skin and are only rebuilt once any agent moved
+                more than half of the skin. Larger values mean fewer rebuilds
+                but longer lists, 0.3 to 0.5 is a good choice for dense and
+                slow crowds. Results may differ slightly from runs without
+                neighbor lists because neighbors are visited in a different
+                order.
+            routing_algorithm: Search used to route agents to their
+                targets, see :class:`~jupedsim.routing.RoutingAlgorithm`.
+                With ANY_ANGLE every agent follows the shortest path to its
+                target, HIERARCHICAL speeds up routing on large geometries.
+            use_navigation_fields: Share one navigation field between all
+                agents heading to the same target once at least 16 agents
+                do so, only used with the TRIANGULATION routing algorithm.
+                Saves one search per agent, but fields measure distances
+                along the midpoints of the triangle edges, so agents may
+                take a different route than without fields.
 
         Keyword Arguments:
             excluded_areas: describes exclusions
                 from the walkable area. Only use this argument if `geometry` was
                 provided as list[tuple[float, float]].
+            cache_directory: directory of an on-disk cache of built
+                geometries, see :func:`~jupedsim.geometry_utils.build_geometry`.
+                Repeated runs on the same geometry skip building the geometry
+                and its navigation triangulation.
         """
         if isinstance(model, CollisionFreeSpeedModel):
             model_builder = py_jps.CollisionFreeSpeedModelBuilder(
@@ -126,6 +158,7 @@ class Simulation:
                 range_neighbor_repulsion=model.range_neighbor_repulsion,
                 strength_geometry_repulsion=model.strength_geometry_repulsion,
                 range_geometry_repulsion=model.range_geometry_repulsion,
+                wall_distance_resolution=model.wall_distance_resolution,
             )
             py_jps_model = model_builder.build()
         elif isinstance(model, CollisionFreeSpeedModelV2):
@@ -172,9 +205,19 @@ class Simulation:
             raise Exception("Unknown model type supplied")
         self._writer = trajectory_writer
         self._obj = py_jps.Simulation(
-            model=py_jps_model, geometry=build_geometry(geometry)._obj, dt=dt
+            model=py_jps_model,
+            geometry=build_geometry(
+                geometry, num_threads=num_threads, **kwargs
+            )._obj,
+            dt=dt,
+            num_threads=num_threads,
+            neighbor_list_skin=neighbor_list_skin,
+            routing_algorithm=routing_algorithm.value,
+            use_navigation_fields=use_navigation_fields,
         )
         self._timer = Timer(self._obj, timer_log_level=timer_log_level)
+        self._geometry: Geometry | None = None
+        self._geometry_generation: int | None = None
 
     def add_waypoint_stage(
         self, position: tuple[float, float], distance
@@ -255,6 +298,50 @@ class Simulation:
         exit_geometry = build_geometry(polygon)
         return self._obj.add_exit_stage(exit_geometry.boundary())
 
+    def add_obstacle(
+        self,
+        polygon: (
+            str
+            | shapely.GeometryCollection
+            | shapely.Polygon
+            | shapely.MultiPolygon
+            | shapely.MultiPoint
+            | list[tuple[float, float]]
+        ),
+    ) -> int:
+        """Exclude a polygon from the walkable area while the simulation runs.
+
+        The obstacle has to lie strictly inside the walkable area, i.e. it may
+        not touch the boundary or existing holes. It may neither cover an
+        agent, the current target of an agent, a waypoint, an exit nor a slot
+        of a waiting set or queue. Only the geometry and routing data around
+        the obstacle are updated, so obstacles can be toggled frequently, e.g.
+        to model barriers placed inside a room. The ANY_ANGLE and HIERARCHICAL
+        routing algorithms are the exception, they rebuild their search
+        structures for the whole geometry on every change.
+
+        Obstacles touching or overlapping walls are rejected, therefore
+        closing doors cannot be modelled with obstacles.
+
+        Arguments:
+            polygon:
+                Polygon without holes describing the obstacle. Supports the
+                same inputs as :meth:`add_exit_stage`.
+
+        Returns:
+            Id of the obstacle, use it to remove the obstacle again.
+        """
+        obstacle_geometry = build_geometry(polygon)
+        return self._obj.add_obstacle(obstacle_geometry.boundary())
+
+    def remove_obstacle(self, obstacle_id: int) -> None:
+        """Give the area of an obstacle back to the walkable area.
+
+        Arguments:
+            obstacle_id: Id returned by :meth:`add_obstacle`.
+        """
+        self._obj.remove_obstacle(obstacle_id)
+
     def add_direct_steering_stage(self) -> int:
         """Add an direct steering stage to the simulation.
 
@@ -486,6 +573,39 @@ class Simulation:
         """
         return self._obj.delta_time()
 
+    def num_threads(self) -> int:
+        """Number of threads used to compute the operational model.
+
+        Returns:
+            Number of threads used per iteration.
+        """
+        return self._obj.num_threads()
+
+    def neighbor_list_skin(self) -> float:
+        """Skin of the cached neighbor lists.
+
+        Returns:
+            Skin in meters, 0 if neighbor lists are not used.
+        """
+        return self._obj.neighbor_list_skin()
+
+    def routing_algorithm(self) -> RoutingAlgorithm:
+        """Search used to route agents to their targets.
+
+        Returns:
+            Routing algorithm selected when creating the simulation.
+        """
+        return RoutingAlgorithm(self._obj.routing_algorithm())
+
+    def use_navigation_fields(self) -> bool:
+        """Whether agents heading to the same target share navigation fields.
+
+        Returns:
+            True if navigation fields were enabled when creating the
+            simulation.
+        """
+        return self._obj.use_navigation_fields()
+
     def iteration_count(self) -> int:
         """Number of iterations performed since start of the simulation.
 
@@ -599,10 +719,30 @@ class Simulation:
     def get_geometry(self) -> Geometry:
         """Current geometry of the simulation.
 
+        The returned object is shared and immutable. It is reused for all
+        calls until the geometry changes, so derived representations such as
+        :meth:`Geometry.as_wkt` are only computed once per geometry.
+
         Returns:
             The geometry of the simulation.
         """
-        return Geometry(self._obj.get_geometry())
+        generation = self._obj.geometry_generation()
+        if self._geometry is None or self._geometry_generation != generation:
+            self._geometry = Geometry(self._obj.get_geometry())
+            self._geometry_generation = generation
+        return self._geometry
+
+    def geometry_generation(self) -> int:
+        """Generation of the current geometry.
+
+        The generation changes whenever the geometry of the simulation is
+        replaced. Comparing it against a previously seen value is a cheap way
+        to detect geometry changes without accessing the geometry.
+
+        Returns:
+            Generation counter of the geometry.
+        """
+        return self._obj.geometry_generation()
 
     @property
     def timer(self) -> Timer:
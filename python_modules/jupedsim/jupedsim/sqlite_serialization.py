@@ -5,8 +5,6 @@ import sqlite3
 from pathlib import Path
 from typing import Final
 
-from shapely import from_wkt
-
 from jupedsim.serialization import TrajectoryWriter
 from jupedsim.simulation import Simulation
 
@@ -66,6 +64,11 @@ class SqliteTrajectoryWriter(TrajectoryWriter):
         self._commit_every_nth_write = commit_every_nth_write
         self._buffered_frame_count = 0
 
+        # Geometry work is only repeated when the simulation reports a new
+        # geometry generation.
+        self._geometry_generation: int | None = None
+        self._geometry_hash: int | None = None
+
     def begin_writing(self, simulation: Simulation) -> None:
         """Begin writing trajectory data.
 
@@ -75,6 +78,8 @@ class SqliteTrajectoryWriter(TrajectoryWriter):
         """
         fps = 1 / simulation.delta_time() / self._every_nth_frame
         geo = simulation.get_geometry().as_wkt()
+        self._geometry_generation = None
+        self._geometry_hash = None
 
         cur = self._con.cursor()
         try:
@@ -151,32 +156,13 @@ class SqliteTrajectoryWriter(TrajectoryWriter):
                 frame_data,
             )
 
-            geo_wkt = simulation.get_geometry().as_wkt()
-            geo_hash = hash(geo_wkt)
-            cur.execute(
-                "INSERT OR IGNORE INTO geometry(hash, wkt) VALUES(?,?)",
-                (geo_hash, geo_wkt),
-            )
+            generation = simulation.geometry_generation()
+            if generation != self._geometry_generation:
+                self._write_geometry(cur, simulation)
+                self._geometry_generation = generation
             cur.execute(
                 "INSERT INTO frame_data VALUES(?, ?)",
-                (frame, geo_hash),
-            )
-
-            xmin, ymin, xmax, ymax = from_wkt(geo_wkt).bounds
-
-            old_xmin = self._x_min(cur)
-            old_xmax = self._x_max(cur)
-            old_ymin = self._y_min(cur)
-            old_ymax = self._y_max(cur)
-
-            cur.executemany(
-                "INSERT OR REPLACE INTO metadata(key, value) VALUES(?,?)",
-                [
-                    ("xmin", str(min(xmin, float(old_xmin)))),
-                    ("xmax", str(max(xmax, float(old_xmax)))),
-                    ("ymin", str(min(ymin, float(old_ymin)))),
-                    ("ymax", str(max(ymax, float(old_ymax)))),
-                ],
+                (frame, self._geometry_hash),
             )
             # Trigger flush if buffer full
             self._buffered_frame_count += 1
@@ -213,6 +199,33 @@ class SqliteTrajectoryWriter(TrajectoryWriter):
             text = res[0]
             return type(default)(text)
 
+    def _write_geometry(self, cur, simulation: Simulation) -> None:
+        geometry = simulation.get_geometry()
+        geo_wkt = geometry.as_wkt()
+        geo_hash = hash(geo_wkt)
+        cur.execute(
+            "INSERT OR IGNORE INTO geometry(hash, wkt) VALUES(?,?)",
+            (geo_hash, geo_wkt),
+        )
+        self._geometry_hash = geo_hash
+
+        xmin, ymin, xmax, ymax = geometry.bounds()
+
+        old_xmin = self._x_min(cur)
+        old_xmax = self._x_max(cur)
+        old_ymin = self._y_min(cur)
+        old_ymax = self._y_max(cur)
+
+        cur.executemany(
+            "INSERT OR REPLACE INTO metadata(key, value) VALUES(?,?)",
+            [
+                ("xmin", str(min(xmin, float(old_xmin)))),
+                ("xmax", str(max(xmax, float(old_xmax)))),
+                ("ymin", str(min(ymin, float(old_ymin)))),
+                ("ymax", str(max(ymax, float(old_ymax)))),
+            ],
+        )
+
     def _x_min(self, cur):
         return self._value_or_default(cur, "xmin", float("inf"))
 
@@ -0,0 +1,100 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+import math
+
+import jupedsim as jps
+import pytest
+import shapely
+
+ZIG_ZAG = shapely.Polygon(
+    [(0, 0), (30, 0), (30, 10), (0, 10)],
+    holes=[
+        [(9, 0), (9, 8), (11, 8), (11, 0)],
+        [(19, 2), (19, 10), (21, 10), (21, 2)],
+    ],
+)
+
+
+def path_length(path):
+    return sum(math.dist(a, b) for a, b in zip(path, path[1:]))
+
+
+def test_any_angle_paths_are_not_longer_than_triangulation_paths():
+    triangulation = jps.RoutingEngine(ZIG_ZAG)
+    any_angle = jps.RoutingEngine(
+        ZIG_ZAG, algorithm=jps.RoutingAlgorithm.ANY_ANGLE
+    )
+    positions = [(1, 1), (5, 9), (10, 9), (15, 1), (20, 1), (25, 5), (29, 9)]
+    for frm in positions:
+        for to in positions:
+            path = any_angle.compute_waypoints(frm, to)
+            reference = triangulation.compute_waypoints(frm, to)
+            assert path[0] == frm
+            assert path[-1] == to
+            # Both paths keep a small clearance to corners, which may differ
+            # slightly between the triangles of the two corridors
+            assert path_length(path) <= path_length(reference) + 0.1
+
+
+def test_hierarchical_paths_connect_start_and_destination():
+    triangulation = jps.RoutingEngine(ZIG_ZAG)
+    hierarchical = jps.RoutingEngine(
+        ZIG_ZAG, algorithm=jps.RoutingAlgorithm.HIERARCHICAL
+    )
+    positions = [(1, 1), (5, 9), (10, 9), (15, 1), (20, 1), (25, 5), (29, 9)]
+    for frm in positions:
+        for to in positions:
+            path = hierarchical.compute_waypoints(frm, to)
+            reference = triangulation.compute_waypoints(frm, to)
+            assert path[0] == frm
+            assert path[-1] == to
+            assert path_length(path) <= 1.1 * path_length(reference) + 1
+
+
+@pytest.mark.parametrize(
+    "routing_algorithm",
+    [
+        jps.RoutingAlgorithm.TRIANGULATION,
+        jps.RoutingAlgorithm.ANY_ANGLE,
+        jps.RoutingAlgorithm.HIERARCHICAL,
+    ],
+)
+def test_agents_reach_exit_with_any_routing_algorithm(routing_algorithm):
+    simulation = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(),
+        geometry=ZIG_ZAG,
+        routing_algorithm=routing_algorithm,
+    )
+    assert simulation.routing_algorithm() == routing_algorithm
+    exit = simulation.add_exit_stage([(29, 7), (30, 7), (30, 9), (29, 9)])
+    journey_id = simulation.add_journey(jps.JourneyDescription([exit]))
+    for position in [(2, 2), (2, 5), (5, 8), (7, 3)]:
+        simulation.add_agent(
+            jps.CollisionFreeSpeedModelAgentParameters(
+                position=position, journey_id=journey_id, stage_id=exit
+            )
+        )
+    while simulation.agent_count() > 0 and simulation.iteration_count() < 5000:
+        simulation.iterate(10)
+    assert simulation.agent_count() == 0
+
+
+def test_agents_reach_exit_with_navigation_fields():
+    simulation = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(),
+        geometry=ZIG_ZAG,
+        use_navigation_fields=True,
+    )
+    assert simulation.use_navigation_fields()
+    exit = simulation.add_exit_stage([(29, 7), (30, 7), (30, 9), (29, 9)])
+    journey_id = simulation.add_journey(jps.JourneyDescription([exit]))
+    # More agents than required to share a navigation field
+    for x in range(1, 9, 2):
+        for y in range(1, 10, 2):
+            simulation.add_agent(
+                jps.CollisionFreeSpeedModelAgentParameters(
+                    position=(x, y), journey_id=journey_id, stage_id=exit
+                )
+            )
+    while simulation.agent_count() > 0 and simulation.iteration_count() < 8000:
+        simulation.iterate(10)
+    assert simulation.agent_count() == 0
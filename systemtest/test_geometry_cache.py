@@ -0,0 +1,59 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+import jupedsim as jps
+import shapely
+from jupedsim.geometry_utils import build_geometry
+
+ROOM = shapely.Polygon(
+    [(0, 0), (20, 0), (20, 10), (0, 10)],
+    holes=[[(8, 3), (8, 7), (12, 7), (12, 3)]],
+)
+
+
+def run_to_exit(cache_directory):
+    simulation = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(),
+        geometry=ROOM,
+        cache_directory=cache_directory,
+    )
+    exit = simulation.add_exit_stage([(19, 4), (20, 4), (20, 6), (19, 6)])
+    journey_id = simulation.add_journey(jps.JourneyDescription([exit]))
+    simulation.add_agent(
+        jps.CollisionFreeSpeedModelAgentParameters(
+            position=(2, 5), journey_id=journey_id, stage_id=exit
+        )
+    )
+    positions = []
+    while simulation.agent_count() > 0 and simulation.iteration_count() < 5000:
+        simulation.iterate(10)
+        positions += [agent.position for agent in simulation.agents()]
+    return simulation, positions
+
+
+def test_cached_geometry_matches_built_geometry(tmp_path):
+    built = build_geometry(ROOM)
+    cold = build_geometry(ROOM, cache_directory=tmp_path)
+    assert len(list(tmp_path.iterdir())) == 1
+    warm = build_geometry(ROOM, cache_directory=str(tmp_path))
+    assert len(list(tmp_path.iterdir())) == 1
+
+    for geometry in (cold, warm):
+        assert geometry.boundary() == built.boundary()
+        assert geometry.holes() == built.holes()
+
+
+def test_simulation_on_cached_geometry_routes_like_uncached(tmp_path):
+    _, expected = run_to_exit(None)
+    cold, cold_positions = run_to_exit(tmp_path)
+    warm, warm_positions = run_to_exit(tmp_path)
+
+    assert cold.agent_count() == 0
+    assert warm.agent_count() == 0
+    assert cold_positions == expected
+    assert warm_positions == expected
+
+
+def test_changed_geometry_gets_new_cache_entry(tmp_path):
+    build_geometry(ROOM, cache_directory=tmp_path)
+    shrunk = ROOM.buffer(-0.5, join_style="mitre")
+    build_geometry(shrunk, cache_directory=tmp_path)
+    assert len(list(tmp_path.iterdir())) == 2
@@ -18,3 +18,22 @@ def test_geometry_holes_returns_coordinates():
     assert holes is not None
     assert len(holes) == 1
     assert len(holes[0]) >= 4
+
+
+def test_geometry_is_shared_while_generation_is_unchanged():
+    outer = [(0, 0), (100, 0), (100, 100), (0, 100)]
+    hole = [(40, 40), (60, 40), (60, 60), (40, 60)]
+    poly = shapely.Polygon(outer, holes=[hole])
+
+    simulation = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(),
+        geometry=poly,
+    )
+    generation = simulation.geometry_generation()
+    geo = simulation.get_geometry()
+    simulation.iterate(10)
+
+    assert simulation.geometry_generation() == generation
+    assert simulation.get_geometry() is geo
+    assert geo.as_wkt() is geo.as_wkt()
+    assert geo.bounds() == shapely.from_wkt(geo.as_wkt()).bounds
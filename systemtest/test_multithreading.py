@@ -0,0 +1,71 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+import jupedsim as jps
+import pytest
+
+
+def run_crowd(model, agent_parameters_type, num_threads):
+    simulation = jps.Simulation(
+        model=model,
+        geometry=[(0, 0), (40, 0), (40, 40), (0, 40)],
+        num_threads=num_threads,
+    )
+    exit = simulation.add_exit_stage([(39, 15), (39, 25), (40, 25), (40, 15)])
+    journey_id = simulation.add_journey(jps.JourneyDescription([exit]))
+
+    for x in range(2, 20):
+        for y in range(2, 38, 2):
+            simulation.add_agent(
+                agent_parameters_type(
+                    position=(x, y), journey_id=journey_id, stage_id=exit
+                )
+            )
+
+    simulation.iterate(200)
+    return [agent.position for agent in simulation.agents()]
+
+
+@pytest.mark.parametrize(
+    "model, agent_parameters_type",
+    [
+        (
+            jps.CollisionFreeSpeedModel(),
+            jps.CollisionFreeSpeedModelAgentParameters,
+        ),
+        (
+            jps.CollisionFreeSpeedModelV2(),
+            jps.CollisionFreeSpeedModelV2AgentParameters,
+        ),
+        (
+            jps.GeneralizedCentrifugalForceModel(),
+            jps.GeneralizedCentrifugalForceModelAgentParameters,
+        ),
+        (
+            jps.SocialForceModel(),
+            jps.SocialForceModelAgentParameters,
+        ),
+    ],
+)
+def test_results_do_not_depend_on_thread_count(model, agent_parameters_type):
+    single_threaded = run_crowd(model, agent_parameters_type, 1)
+    multi_threaded = run_crowd(model, agent_parameters_type, 4)
+
+    assert len(single_threaded) > 0
+    assert single_threaded == multi_threaded
+
+
+def test_num_threads_is_reported():
+    simulation = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(),
+        geometry=[(0, 0), (10, 0), (10, 10), (0, 10)],
+        num_threads=3,
+    )
+    assert simulation.num_threads() == 3
+
+
+def test_num_threads_must_be_positive():
+    with pytest.raises(Exception):
+        jps.Simulation(
+            model=jps.CollisionFreeSpeedModel(),
+            geometry=[(0, 0), (10, 0), (10, 10), (0, 10)],
+            num_threads=0,
+        )
@@ -0,0 +1,54 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+import jupedsim as jps
+import pytest
+
+
+def run_bottleneck(neighbor_list_skin):
+    simulation = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(),
+        geometry=[
+            (0, 0),
+            (20, 0),
+            (20, 9),
+            (22, 9),
+            (22, 11),
+            (20, 11),
+            (20, 20),
+            (0, 20),
+        ],
+        neighbor_list_skin=neighbor_list_skin,
+    )
+    exit = simulation.add_exit_stage([(21, 9), (22, 9), (22, 11), (21, 11)])
+    journey_id = simulation.add_journey(jps.JourneyDescription([exit]))
+
+    for x in range(2, 18, 2):
+        for y in range(2, 18, 2):
+            simulation.add_agent(
+                jps.CollisionFreeSpeedModelAgentParameters(
+                    position=(x, y), journey_id=journey_id, stage_id=exit
+                )
+            )
+
+    simulation.iterate(500)
+    return simulation
+
+
+def test_neighbor_lists_do_not_change_evacuation_progress():
+    without_lists = run_bottleneck(0)
+    with_lists = run_bottleneck(0.4)
+
+    assert with_lists.neighbor_list_skin() == 0.4
+    assert without_lists.neighbor_list_skin() == 0
+    assert with_lists.agent_count() < 64
+    assert with_lists.agent_count() == pytest.approx(
+        without_lists.agent_count(), abs=3
+    )
+
+
+def test_neighbor_list_skin_must_not_be_negative():
+    with pytest.raises(Exception):
+        jps.Simulation(
+            model=jps.CollisionFreeSpeedModel(),
+            geometry=[(0, 0), (10, 0), (10, 10), (0, 10)],
+            neighbor_list_skin=-0.1,
+        )
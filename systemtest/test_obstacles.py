@@ -0,0 +1,80 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+import jupedsim as jps
+import pytest
+import shapely
+
+
+def make_room():
+    simulation = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(),
+        geometry=[(0, 0), (20, 0), (20, 10), (0, 10)],
+    )
+    exit = simulation.add_exit_stage([(19, 4), (20, 4), (20, 6), (19, 6)])
+    journey_id = simulation.add_journey(jps.JourneyDescription([exit]))
+    return simulation, exit, journey_id
+
+
+def test_obstacle_is_excluded_from_geometry_until_removed():
+    simulation, _, _ = make_room()
+    generation = simulation.geometry_generation()
+
+    obstacle_id = simulation.add_obstacle([(8, 3), (12, 3), (12, 7), (8, 7)])
+    assert simulation.geometry_generation() != generation
+    geometry = shapely.from_wkt(simulation.get_geometry().as_wkt())
+    assert not geometry.contains(shapely.Point(10, 5))
+    assert len(simulation.get_geometry().holes()) == 1
+
+    simulation.remove_obstacle(obstacle_id)
+    geometry = shapely.from_wkt(simulation.get_geometry().as_wkt())
+    assert geometry.contains(shapely.Point(10, 5))
+    assert len(simulation.get_geometry().holes()) == 0
+
+
+def test_agents_walk_around_obstacle_added_during_simulation():
+    simulation, exit, journey_id = make_room()
+    simulation.add_agent(
+        jps.CollisionFreeSpeedModelAgentParameters(
+            position=(2, 5), journey_id=journey_id, stage_id=exit
+        )
+    )
+    simulation.iterate(10)
+    obstacle = shapely.Polygon([(8, 3), (12, 3), (12, 7), (8, 7)])
+    simulation.add_obstacle(obstacle)
+
+    while simulation.agent_count() > 0 and simulation.iteration_count() < 3000:
+        simulation.iterate()
+        for agent in simulation.agents():
+            assert not obstacle.contains(shapely.Point(agent.position))
+    assert simulation.agent_count() == 0
+
+
+def test_obstacles_can_be_toggled_repeatedly():
+    simulation, exit, journey_id = make_room()
+    simulation.add_agent(
+        jps.CollisionFreeSpeedModelAgentParameters(
+            position=(2, 5), journey_id=journey_id, stage_id=exit
+        )
+    )
+    for _ in range(10):
+        obstacle_id = simulation.add_obstacle(
+            [(8, 3), (12, 3), (12, 7), (8, 7)]
+        )
+        simulation.iterate(5)
+        simulation.remove_obstacle(obstacle_id)
+        simulation.iterate(5)
+    assert len(simulation.get_geometry().holes()) == 0
+
+
+def test_invalid_obstacles_are_rejected():
+    simulation, exit, journey_id = make_room()
+    simulation.add_agent(
+        jps.CollisionFreeSpeedModelAgentParameters(
+            position=(2, 5), journey_id=journey_id, stage_id=exit
+        )
+    )
+    with pytest.raises(Exception, match="boundary"):
+        simulation.add_obstacle([(-1, 3), (2, 3), (2, 4), (-1, 4)])
+    with pytest.raises(Exception, match="covers agent"):
+        simulation.add_obstacle([(1, 4), (3, 4), (3, 6), (1, 6)])
+    with pytest.raises(Exception):
+        simulation.remove_obstacle(123456)
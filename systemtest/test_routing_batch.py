@@ -0,0 +1,91 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+import math
+
+import jupedsim as jps
+import numpy as np
+import pytest
+import shapely
+
+ROOM_WITH_WALL = shapely.Polygon(
+    [(0, 0), (20, 0), (20, 10), (0, 10)],
+    holes=[[(9, 0), (9, 8), (11, 8), (11, 0)]],
+)
+
+
+def path_length(path):
+    return sum(math.dist(a, b) for a, b in zip(path, path[1:]))
+
+
+@pytest.fixture
+def queries():
+    rng = np.random.default_rng(42)
+    origins = np.column_stack(
+        [rng.uniform(0.5, 8.5, 200), rng.uniform(0.5, 9.5, 200)]
+    )
+    destinations = np.column_stack(
+        [rng.uniform(11.5, 19.5, 200), rng.uniform(0.5, 9.5, 200)]
+    )
+    return origins, destinations
+
+
+def test_batch_matches_single_queries(queries):
+    origins, destinations = queries
+    engine = jps.RoutingEngine(ROOM_WITH_WALL)
+    result = engine.compute_batch(
+        origins, destinations, with_waypoints=True, num_threads=4
+    )
+    assert result.lengths.shape == (len(origins),)
+    assert result.offsets.shape == (len(origins) + 1,)
+    assert result.waypoints.shape == (result.offsets[-1], 2)
+    for index, (frm, to) in enumerate(zip(origins, destinations)):
+        expected = engine.compute_waypoints(tuple(frm), tuple(to))
+        path = [tuple(p) for p in result.path(index)]
+        assert path == expected
+        assert result.lengths[index] == pytest.approx(path_length(expected))
+
+
+def test_batch_does_not_depend_on_thread_count(queries):
+    origins, destinations = queries
+    engine = jps.RoutingEngine(ROOM_WITH_WALL)
+    sequential = engine.compute_batch(
+        origins, destinations, with_waypoints=True, num_threads=1
+    )
+    parallel = engine.compute_batch(
+        origins, destinations, with_waypoints=True, num_threads=8
+    )
+    np.testing.assert_array_equal(parallel.lengths, sequential.lengths)
+    np.testing.assert_array_equal(parallel.waypoints, sequential.waypoints)
+    np.testing.assert_array_equal(parallel.offsets, sequential.offsets)
+
+
+def test_batch_without_waypoints_only_returns_lengths(queries):
+    origins, destinations = queries
+    result = jps.RoutingEngine(ROOM_WITH_WALL).compute_batch(
+        origins, destinations
+    )
+    assert result.lengths.shape == (len(origins),)
+    assert result.waypoints is None
+    assert result.offsets is None
+    with pytest.raises(ValueError):
+        result.path(0)
+
+
+def test_batch_marks_unroutable_queries():
+    result = jps.RoutingEngine(ROOM_WITH_WALL).compute_batch(
+        [(10, 1), (2, 2), (2, 2)],
+        [(18, 2), (-1, 1), (18, 2)],
+        with_waypoints=True,
+    )
+    assert math.isinf(result.lengths[0])
+    assert math.isinf(result.lengths[1])
+    assert math.isfinite(result.lengths[2])
+    assert len(result.path(0)) == 0
+    assert len(result.path(1)) == 0
+
+
+def test_batch_rejects_invalid_shapes():
+    engine = jps.RoutingEngine(ROOM_WITH_WALL)
+    with pytest.raises(ValueError):
+        engine.compute_batch([1, 2, 3], [(18, 2)])
+    with pytest.raises(RuntimeError):
+        engine.compute_batch([(2, 2), (3, 3)], [(18, 2)])
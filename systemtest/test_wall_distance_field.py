@@ -0,0 +1,43 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+import jupedsim as jps
+import pytest
+
+
+def run_corridor(wall_distance_resolution):
+    simulation = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(
+            wall_distance_resolution=wall_distance_resolution
+        ),
+        geometry=[(0, 0), (30, 0), (30, 3), (0, 3)],
+    )
+    exit = simulation.add_exit_stage([(29, 0), (30, 0), (30, 3), (29, 3)])
+    journey_id = simulation.add_journey(jps.JourneyDescription([exit]))
+
+    for x in range(1, 10):
+        for y in (0.5, 1.5, 2.5):
+            simulation.add_agent(
+                jps.CollisionFreeSpeedModelAgentParameters(
+                    position=(x, y), journey_id=journey_id, stage_id=exit
+                )
+            )
+
+    simulation.iterate(1000)
+    return simulation
+
+
+def test_wall_distance_field_keeps_evacuation_progress():
+    exact = run_corridor(0)
+    with_field = run_corridor(0.1)
+
+    assert with_field.agent_count() < 27
+    assert with_field.agent_count() == pytest.approx(
+        exact.agent_count(), abs=3
+    )
+
+
+def test_wall_distance_resolution_must_not_be_negative():
+    with pytest.raises(Exception):
+        jps.Simulation(
+            model=jps.CollisionFreeSpeedModel(wall_distance_resolution=-0.1),
+            geometry=[(0, 0), (10, 0), (10, 10), (0, 10)],
+        )